@@ -194,17 +194,20 @@ class OpenSCADObject:
         ...
 
     def mesh(
-        self, triangulate: Optional[bool] = None
-    ) -> Union[tuple[list[Vector3], list[list[int]]], list[list[Vector2]]]:
+        self, triangulate: Optional[bool] = None, buffer: Optional[bool] = None
+    ) -> Union[tuple[list[Vector3], list[list[int]]], tuple[memoryview, memoryview], list[list[Vector2]]]:
         """Export mesh representation of this object.
 
         Args:
             triangulate: If True, triangulates the mesh.
+            buffer: If True, returns 3D meshes as memoryviews instead of lists. Implies triangulate.
 
         Returns:
             For 3D objects: A tuple of (vertices, faces) where:
             - vertices: List of 3D vertex coordinates [[x, y, z], ...]
             - faces: List of face definitions (lists of vertex indices)
+            With buffer=True, vertices is a float64 memoryview of shape (n, 3) and faces an
+            int32 memoryview of shape (m, 3), e.g. for use with numpy.asarray().
 
             For 2D objects: A list of outlines where:
             - Each outline is a list of 2D vertex coordinates [[x, y], ...]
@@ -527,8 +530,8 @@ def sphere(
     ...
 
 def polyhedron(
-    points: Matrix4x4,
-    faces: list[list[int]],
+    points: Union[Matrix4x4, memoryview],
+    faces: Union[list[list[int]], memoryview],
     convexity: int = 2,
     triangles: Optional[list[list[int]]] = None,
 ) -> OpenSCADObject:
@@ -538,8 +541,12 @@ def polyhedron(
         points: List of 3D coordinates defining the polyhedron vertices.
                 Each point must be a list of exactly 3 numbers [x, y, z].
                 Must contain at least one point.
+                Alternatively, a C-contiguous float64 buffer (e.g. a numpy array)
+                of shape (n, 3), which is copied without per-element conversion.
         faces: List of face definitions, where each face is a list of indices
                into the points list.
+               Alternatively, a C-contiguous 32 or 64 bit integer buffer of shape
+               (n, k), one face of k indices per row.
         convexity: Convexity parameter for rendering optimization. Defaults to 2.
         triangles: Optional backwards compatibility parameter for triangular faces.
 
@@ -914,18 +921,21 @@ def fill(*objects: OpenSCADObjects) -> OpenSCADObject:
     ...
 
 def mesh(
-    obj: OpenSCADObjects, triangulate: Optional[bool] = None
-) -> Union[tuple[list[Vector3], list[list[int]]], list[list[Vector2]]]:
+    obj: OpenSCADObjects, triangulate: Optional[bool] = None, buffer: Optional[bool] = None
+) -> Union[tuple[list[Vector3], list[list[int]]], tuple[memoryview, memoryview], list[list[Vector2]]]:
     """Export mesh representation of an object.
 
     Args:
         obj: Object to convert to mesh.
         triangulate: If True, triangulates the mesh.
+        buffer: If True, returns 3D meshes as memoryviews instead of lists. Implies triangulate.
 
     Returns:
         For 3D objects: A tuple of (vertices, faces) where:
         - vertices: List of 3D vertex coordinates [[x, y, z], ...]
         - faces: List of face definitions (lists of vertex indices)
+        With buffer=True, vertices is a float64 memoryview of shape (n, 3) and faces an
+        int32 memoryview of shape (m, 3), e.g. for use with numpy.asarray().
 
         For 2D objects: A list of outlines where:
         - Each outline is a list of 2D vertex coordinates [[x, y], ...]
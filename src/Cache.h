@@ -44,20 +44,48 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
 #include <unordered_map>
 
 #include "utils/printutils.h"
 
+enum class CacheEvictionPolicy {
+  // Evict the least recently used entry
+  LRU,
+  // GreedyDual-Size: evict the entry with the lowest compute time per byte, aged by an
+  // inflation value that rises with every eviction, so entries that aren't used anymore
+  // eventually go as well
+  GreedyDualSize,
+};
+
+// The state below is shared by all caches, so priorities can be compared between caches
+inline std::atomic<CacheEvictionPolicy> cacheEvictionPolicy{CacheEvictionPolicy::LRU};
+// Counts accesses, for LRU
+inline std::atomic<uint64_t> cacheAccessClock{0};
+// Priority of the last evicted entry, for GreedyDual-Size
+inline std::atomic<double> cacheInflation{0};
+
 template <class Key, class T>
 class Cache
 {
+  struct Node;
+  using priority_map = std::multimap<double, Node *>;
+
   struct Node {
     inline Node() : keyPtr(nullptr), t(nullptr), c(0), p(nullptr), n(nullptr) {}
     inline Node(T *data, size_t cost) : keyPtr(nullptr), t(data), c(cost), p(nullptr), n(nullptr) {}
     const Key *keyPtr;
     T *t;
     size_t c;
+    // Seconds it took to compute the object
+    double computeTime{0};
+    uint64_t lastAccess{0};
+    typename priority_map::iterator priority;
     Node *p, *n;
   };
   using map_type = typename std::unordered_map<Key, Node>;
@@ -68,6 +96,11 @@ class Cache
   Node *f, *l;
   void *unused{nullptr};
   size_t mx, total{0};
+  // Nodes by GreedyDual-Size priority, maintained under both policies so it can be switched
+  priority_map byPriority;
+  double totalComputeTime{0};
+  size_t evicted{0};
+  size_t hit{0}, missed{0};
 
   inline void unlink(Node& n)
   {
@@ -76,16 +109,51 @@ class Cache
     if (l == &n) l = n.p;
     if (f == &n) f = n.n;
     total -= n.c;
+    totalComputeTime -= n.computeTime;
+    byPriority.erase(n.priority);
     T *obj = n.t;
     hash.erase(*n.keyPtr);
     delete obj;
   }
+  // Updates the priorities of a node that was just inserted or accessed
+  inline void prioritize(Node& n)
+  {
+    n.lastAccess = ++cacheAccessClock;
+    const auto size = static_cast<double>(std::max<size_t>(n.c, 1));
+    n.priority = byPriority.emplace(cacheInflation + n.computeTime / size, &n);
+  }
+  // The node to evict next under the current policy
+  [[nodiscard]] inline Node *victim() const
+  {
+    if (cacheEvictionPolicy == CacheEvictionPolicy::GreedyDualSize) {
+      return byPriority.empty() ? nullptr : byPriority.begin()->second;
+    }
+    return l;
+  }
+  inline void evict(Node& n)
+  {
+    if (cacheEvictionPolicy == CacheEvictionPolicy::GreedyDualSize) {
+      // Caches evict on several threads, so raise the inflation without losing a concurrent update
+      const double priority = n.priority->first;
+      double inflation = cacheInflation.load();
+      while (inflation < priority && !cacheInflation.compare_exchange_weak(inflation, priority)) {
+      }
+    }
+    ++evicted;
+    unlink(n);
+  }
   inline T *relink(const Key& key)
   {
     auto i = hash.find(key);
-    if (i == hash.end()) return nullptr;
+    if (i == hash.end()) {
+      ++missed;
+      return nullptr;
+    }
 
+    ++hit;
     Node& n = i->second;
+    byPriority.erase(n.priority);
+    prioritize(n);
     if (f != &n) {
       if (n.p) n.p->n = n.n;
       if (n.n) n.n->p = n.p;
@@ -120,11 +188,14 @@ public:
       f = f->n;
     }
     hash.clear();
+    byPriority.clear();
     l = nullptr;
     total = 0;
+    totalComputeTime = 0;
   }
 
-  bool insert(const Key& key, T *object, size_t cost);
+  // computeTime is the number of seconds it took to compute object
+  bool insert(const Key& key, T *object, size_t cost, double computeTime = 0);
   T *object(const Key& key) const { return const_cast<Cache<Key, T> *>(this)->relink(key); }
   inline bool contains(const Key& key) const { return hash.find(key) != hash.end(); }
   T *operator[](const Key& key) const { return object(key); }
@@ -132,6 +203,31 @@ public:
   bool remove(const Key& key);
   T *take(const Key& key);
 
+  // Priority of the entry evictNext() would remove, comparable between all caches
+  [[nodiscard]] std::optional<double> nextEvictionPriority() const
+  {
+    const Node *n = victim();
+    if (!n) return {};
+    if (cacheEvictionPolicy == CacheEvictionPolicy::GreedyDualSize) return n->priority->first;
+    return static_cast<double>(n->lastAccess);
+  }
+  // Removes the entry the current policy values least, returns false if the cache is empty
+  bool evictNext()
+  {
+    Node *n = victim();
+    if (!n) return false;
+    evict(*n);
+    return true;
+  }
+  // Number of entries evicted since the cache was created
+  [[nodiscard]] size_t evictions() const { return evicted; }
+  // Number of lookups through object() which found, and which didn't find an entry.
+  // contains() and insert() aren't counted.
+  [[nodiscard]] size_t hits() const { return hit; }
+  [[nodiscard]] size_t misses() const { return missed; }
+  // Sum of the compute times of all entries
+  [[nodiscard]] double computeTime() const { return std::max(totalComputeTime, 0.0); }
+
 private:
   void trim(size_t m);
 };
@@ -162,7 +258,7 @@ inline T *Cache<Key, T>::take(const Key& key)
 }
 
 template <class Key, class T>
-bool Cache<Key, T>::insert(const Key& akey, T *aobject, size_t acost)
+bool Cache<Key, T>::insert(const Key& akey, T *aobject, size_t acost, double acomputeTime)
 {
   remove(akey);
   if (acost > mx) {
@@ -171,11 +267,14 @@ bool Cache<Key, T>::insert(const Key& akey, T *aobject, size_t acost)
   }
   trim(mx - acost);
   Node node(aobject, acost);
+  node.computeTime = acomputeTime;
   hash[akey] = node;
   auto i = hash.find(akey);
   total += acost;
+  totalComputeTime += acomputeTime;
   Node *n = &i->second;
   n->keyPtr = &i->first;
+  prioritize(*n);
   if (f) f->p = n;
   n->n = f;
   f = n;
@@ -186,13 +285,11 @@ bool Cache<Key, T>::insert(const Key& akey, T *aobject, size_t acost)
 template <class Key, class T>
 void Cache<Key, T>::trim(size_t m)
 {
-  Node *n = l;
-  while (n && total > m) {
-    Node *u = n;
-    n = n->p;
+  Node *n;
+  while (total > m && (n = victim())) {
 #ifdef DEBUG
-    LOG("Trimming cache: %1$s (%2$d bytes)", u->keyPtr->substr(0, 40), u->c);
+    LOG("Trimming cache: %1$s (%2$d bytes)", n->keyPtr->substr(0, 40), n->c);
 #endif
-    unlink(*u);
+    evict(*n);
   }
 }
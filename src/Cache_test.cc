@@ -0,0 +1,161 @@
+#include "Cache.h"
+
+#include <catch2/catch_all.hpp>
+#include <string>
+#include <vector>
+
+namespace {
+
+// The policy and the inflation are shared by all caches, so restore them after each test
+class EvictionPolicy
+{
+public:
+  explicit EvictionPolicy(CacheEvictionPolicy policy)
+    : policy(cacheEvictionPolicy), inflation(cacheInflation)
+  {
+    cacheEvictionPolicy = policy;
+    cacheInflation = 0;
+  }
+  ~EvictionPolicy()
+  {
+    cacheEvictionPolicy = policy;
+    cacheInflation = inflation;
+  }
+
+private:
+  CacheEvictionPolicy policy;
+  double inflation;
+};
+
+// Fills a cache of 100 bytes with entries of different sizes and compute times, then uses "b"
+void fill(Cache<std::string, int>& cache)
+{
+  cache.insert("cheap big", new int(0), 40, 0.1);
+  cache.insert("expensive big", new int(0), 40, 10);
+  cache.insert("cheap small", new int(0), 10, 0.01);
+  cache.insert("expensive small", new int(0), 10, 1);
+  cache["expensive big"];
+}
+
+// Keys in the order evictNext() removes them
+std::vector<std::string> evictionOrder(Cache<std::string, int>& cache, std::vector<std::string> keys)
+{
+  std::vector<std::string> order;
+  while (cache.evictNext()) {
+    for (auto it = keys.begin(); it != keys.end(); ++it) {
+      if (!cache.contains(*it)) {
+        order.push_back(*it);
+        keys.erase(it);
+        break;
+      }
+    }
+  }
+  return order;
+}
+
+}  // namespace
+
+TEST_CASE("Cache counts hits and misses on lookups only", "[cache]")
+{
+  Cache<std::string, int> cache(10);
+  cache.insert("a", new int(1), 1);
+  CHECK(cache.hits() == 0);
+  CHECK(cache.misses() == 0);
+
+  SECTION("Lookups")
+  {
+    CHECK(*cache.object("a") == 1);
+    CHECK(cache["b"] == nullptr);
+    CHECK(*cache["a"] == 1);
+    CHECK(cache.hits() == 2);
+    CHECK(cache.misses() == 1);
+  }
+
+  SECTION("contains() doesn't count")
+  {
+    CHECK(cache.contains("a"));
+    CHECK_FALSE(cache.contains("b"));
+    CHECK(cache.hits() == 0);
+    CHECK(cache.misses() == 0);
+  }
+
+  SECTION("Replacing an entry doesn't count")
+  {
+    CHECK(cache.insert("a", new int(2), 1));
+    CHECK(cache.hits() == 0);
+    CHECK(cache.misses() == 0);
+    CHECK(*cache["a"] == 2);
+    CHECK(cache.hits() == 1);
+  }
+
+  SECTION("Rejected inserts don't count")
+  {
+    CHECK_FALSE(cache.insert("b", new int(2), 11));
+    CHECK(cache.hits() == 0);
+    CHECK(cache.misses() == 0);
+    CHECK(cache.size() == 1);
+  }
+
+  SECTION("A miss followed by an insert counts once")
+  {
+    if (!cache["b"]) cache.insert("b", new int(2), 1);
+    CHECK(*cache["b"] == 2);
+    CHECK(cache.hits() == 1);
+    CHECK(cache.misses() == 1);
+  }
+}
+
+TEST_CASE("GreedyDual-Size evicts by compute time per byte, LRU by last use", "[cache]")
+{
+  const std::vector<std::string> keys = {"cheap big", "expensive big", "cheap small", "expensive small"};
+
+  SECTION("LRU")
+  {
+    const EvictionPolicy policy(CacheEvictionPolicy::LRU);
+    Cache<std::string, int> cache(100);
+    fill(cache);
+    CHECK(evictionOrder(cache, keys) ==
+          std::vector<std::string>{"cheap big", "cheap small", "expensive small", "expensive big"});
+  }
+
+  SECTION("GreedyDual-Size")
+  {
+    const EvictionPolicy policy(CacheEvictionPolicy::GreedyDualSize);
+    Cache<std::string, int> cache(100);
+    fill(cache);
+    CHECK(evictionOrder(cache, keys) ==
+          std::vector<std::string>{"cheap small", "cheap big", "expensive small", "expensive big"});
+    // Each eviction raises the inflation to the priority of the evicted entry
+    CHECK(cacheInflation == Catch::Approx(10.0 / 40));
+  }
+
+  SECTION("Inserting into a full cache")
+  {
+    const auto policy_type = GENERATE(CacheEvictionPolicy::LRU, CacheEvictionPolicy::GreedyDualSize);
+    const EvictionPolicy policy(policy_type);
+    Cache<std::string, int> cache(100);
+    fill(cache);
+    cache.insert("new", new int(0), 10, 0.5);
+    CHECK(cache.evictions() == 1);
+    if (policy_type == CacheEvictionPolicy::LRU) {
+      CHECK_FALSE(cache.contains("cheap big"));
+      CHECK(cache.totalCost() == 70);
+    } else {
+      CHECK_FALSE(cache.contains("cheap small"));
+      CHECK(cache.totalCost() == 100);
+    }
+  }
+
+  SECTION("GreedyDual-Size ages entries which aren't used")
+  {
+    const EvictionPolicy policy(CacheEvictionPolicy::GreedyDualSize);
+    Cache<std::string, int> cache(100);
+    fill(cache);
+    for (int i = 0; i < 3; ++i) cache.evictNext();
+    REQUIRE(cache.contains("expensive big"));
+    // Less compute time per byte than "expensive big", but inserted after the inflation rose
+    cache.insert("new", new int(0), 10, 1.6);
+    CHECK(evictionOrder(cache, {"expensive big", "new"}) ==
+          std::vector<std::string>{"expensive big", "new"});
+  }
+}
@@ -26,6 +26,7 @@ Feature::list_t Feature::feature_list;  // Double-listed values. --^
  * const Features listed below.
  */
 const Feature Feature::ExperimentalRoof("roof", "Enable <code>roof</code>");
+const Feature Feature::ExperimentalSweep("sweep", "Enable <code>sweep</code>");
 const Feature Feature::ExperimentalInputDriverDBus("input-driver-dbus",
                                                    "Enable DBus input drivers (requires restart)");
 const Feature Feature::ExperimentalLazyUnion("lazy-union", "Enable lazy unions.");
@@ -49,6 +50,13 @@ const Feature Feature::ExperimentalDiscretizationByError(
 const Feature Feature::ExperimentalAiFeatures("ai-features",
                                               "Enable AI features (Note: AI integration is under "
                                               "development and does not connect to external APIs yet).");
+const Feature Feature::ExperimentalImportMeshCache(
+  "import-mesh-cache",
+  "Cache meshes imported from STL, OFF, OBJ, AMF and 3MF files in OpenSCAD's binary mesh format, "
+  "so importing them again skips parsing.");
+const Feature Feature::ExperimentalStreaming3mfExport(
+  "streaming-3mf-export",
+  "Export 3MF files without lib3mf, streaming and compressing the model in parallel.");
 
 #ifdef ENABLE_PYTHON
 const Feature Feature::ExperimentalPythonEngine(
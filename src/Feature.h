@@ -13,6 +13,7 @@ public:
   using iterator = list_t::iterator;
 
   static const Feature ExperimentalRoof;
+  static const Feature ExperimentalSweep;
   static const Feature ExperimentalInputDriverDBus;
   static const Feature ExperimentalLazyUnion;
   static const Feature ExperimentalVxORenderersIndexing;
@@ -23,6 +24,8 @@ public:
   static const Feature ExperimentalVectorSwizzle;
   static const Feature ExperimentalDiscretizationByError;
   static const Feature ExperimentalAiFeatures;
+  static const Feature ExperimentalImportMeshCache;
+  static const Feature ExperimentalStreaming3mfExport;
 #ifdef ENABLE_PYTHON
   static const Feature ExperimentalPythonEngine;
 #endif
@@ -428,6 +428,9 @@ FontFacePtr FontCache::find_face_fontconfig(const std::string& font) const
     return nullptr;
   }
 
+  // file_value is owned by match, so keep a copy for after it's destroyed
+  const std::string face_id = STR((const char *)file_value, ":", font_index);
+
   FcChar8 *font_features;
   std::string font_features_str;
   if (FcPatternGetString(match, FC_FONT_FEATURES, 0, &font_features) == FcResultMatch) {
@@ -447,7 +450,7 @@ FontFacePtr FontCache::find_face_fontconfig(const std::string& font) const
 
   std::vector<std::string> features;
   boost::split(features, font_features_str, boost::is_any_of(";"));
-  FontFacePtr face = std::make_shared<const FontFace>(ftFace, features);
+  FontFacePtr face = std::make_shared<const FontFace>(ftFace, features, face_id);
 
   for (int a = 0; a < face->face_->num_charmaps; ++a) {
     FT_CharMap charmap = face->face_->charmaps[a];
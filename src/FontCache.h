@@ -80,8 +80,12 @@ private:
 struct FontFace {
   FT_Face face_;
   std::vector<std::string> features_;
+  // Identifies the underlying font file and face index, stable across
+  // reloads of the same face (used as glyph cache key).
+  std::string id_;
 
-  FontFace(FT_Face face, std::vector<std::string> features) : face_(face), features_(std::move(features))
+  FontFace(FT_Face face, std::vector<std::string> features, std::string id = "")
+    : face_(face), features_(std::move(features)), id_(std::move(id))
   {
   }
 
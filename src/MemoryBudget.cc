@@ -0,0 +1,109 @@
+#include "MemoryBudget.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+
+#include "platform/PlatformUtils.h"
+#include "utils/printutils.h"
+
+MemoryBudget *MemoryBudget::inst = nullptr;
+
+void MemoryBudget::registerClient(Client *client)
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  this->clients.push_back(client);
+}
+
+void MemoryBudget::unregisterClient(Client *client)
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  this->clients.erase(std::remove(this->clients.begin(), this->clients.end(), client),
+                      this->clients.end());
+}
+
+void MemoryBudget::setLimitMB(size_t limit)
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  this->limit = limit * 1024ul * 1024ul;
+  enforceLocked();
+}
+
+void MemoryBudget::setSoftRSSLimitMB(size_t limit)
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  this->rss_limit = limit * 1024ul * 1024ul;
+  this->rss_time.reset();
+  enforceLocked();
+}
+
+size_t MemoryBudget::usage() const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return usageLocked();
+}
+
+size_t MemoryBudget::usageLocked() const
+{
+  size_t total = 0;
+  for (const auto *client : this->clients) total += client->memoryUsage();
+  return total;
+}
+
+// Reading the resident memory means a system call or reading a file under /proc, which is
+// too slow to do after every insert into a cache.
+uint64_t MemoryBudget::residentMemoryLocked(size_t total)
+{
+  const auto now = std::chrono::steady_clock::now();
+  if (!this->rss_time || now - *this->rss_time >= RSS_SAMPLE_INTERVAL) {
+    this->rss = PlatformUtils::residentMemory();
+    this->rss_usage = total;
+    this->rss_time = now;
+    return this->rss;
+  }
+  if (total >= this->rss_usage) return this->rss + (total - this->rss_usage);
+  return this->rss - std::min<uint64_t>(this->rss, this->rss_usage - total);
+}
+
+void MemoryBudget::enforce()
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  enforceLocked();
+}
+
+void MemoryBudget::enforceLocked()
+{
+  if (!this->limit && !this->rss_limit) return;
+
+  size_t total = usageLocked();
+  size_t target = this->limit ? this->limit : std::numeric_limits<size_t>::max();
+  if (this->rss_limit) {
+    // Memory used outside the caches can't be reclaimed here, so only try to free the excess
+    const uint64_t rss = residentMemoryLocked(total);
+    if (rss > this->rss_limit) {
+      const auto excess = static_cast<size_t>(rss - this->rss_limit);
+      target = std::min(target, total - std::min(total, excess));
+    }
+  }
+
+  while (total > target) {
+    Client *victim = nullptr;
+    double lowest = 0;
+    for (auto *client : this->clients) {
+      const auto priority = client->evictionPriority();
+      if (priority && (!victim || *priority < lowest)) {
+        victim = client;
+        lowest = *priority;
+      }
+    }
+    if (!victim) break;
+    victim->evictOne();
+    ++this->evicted;
+    total = usageLocked();
+  }
+  PRINTDB("Memory budget: %d bytes in caches, %d entries evicted", total % this->evicted);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+/*!
+   A memory budget shared by the caches of evaluated geometry.
+
+   Caches register as clients and call enforce() after they grew. Entries are then
+   evicted from all clients, the one with the lowest eviction priority first, until
+   the caches together fit into the total budget, and until the resident memory of
+   the process is back below the soft limit (as far as evicting cache entries can
+   achieve that). The resident memory is sampled at most every RSS_SAMPLE_INTERVAL,
+   in between the growth of the caches is taken as the growth of the process.
+
+   Both limits are disabled by default, leaving only the limits of the caches
+   themselves.
+
+   enforce() evicts from all clients on whichever thread grew a cache, so clients
+   have to lock their own state. They must not hold their locks while calling
+   enforce(), as it calls back into them.
+ */
+class MemoryBudget
+{
+public:
+  class Client
+  {
+  public:
+    virtual ~Client() = default;
+    // Bytes held by the cache
+    [[nodiscard]] virtual size_t memoryUsage() const = 0;
+    // Priority of the entry the cache would evict next, lower is evicted first.
+    // Empty if there is nothing to evict.
+    [[nodiscard]] virtual std::optional<double> evictionPriority() const = 0;
+    virtual void evictOne() = 0;
+  };
+
+  static MemoryBudget *instance()
+  {
+    if (!inst) inst = new MemoryBudget;
+    return inst;
+  }
+
+  void registerClient(Client *client);
+  void unregisterClient(Client *client);
+
+  // 0 disables the limit
+  void setLimitMB(size_t limit);
+  [[nodiscard]] size_t limitMB() const { return this->limit / (1024ul * 1024ul); }
+  // 0 disables the limit
+  void setSoftRSSLimitMB(size_t limit);
+  [[nodiscard]] size_t softRSSLimitMB() const { return this->rss_limit / (1024ul * 1024ul); }
+
+  // Bytes held by all clients
+  [[nodiscard]] size_t usage() const;
+  // Number of entries evicted to stay within the limits
+  [[nodiscard]] size_t evictions() const { return this->evicted; }
+  void enforce();
+
+  static constexpr std::chrono::milliseconds RSS_SAMPLE_INTERVAL{100};
+
+private:
+  static MemoryBudget *inst;
+
+  [[nodiscard]] size_t usageLocked() const;
+  [[nodiscard]] uint64_t residentMemoryLocked(size_t total);
+  void enforceLocked();
+
+  mutable std::mutex mutex;
+  std::vector<Client *> clients;
+  size_t limit{0};
+  size_t rss_limit{0};
+  size_t evicted{0};
+  // Last sample of the resident memory, and the bytes held by the clients at that time
+  uint64_t rss{0};
+  size_t rss_usage{0};
+  std::optional<std::chrono::steady_clock::time_point> rss_time;
+};
@@ -0,0 +1,117 @@
+#include "MemoryBudget.h"
+
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr size_t MB = 1024ul * 1024ul;
+
+// Holds entries of the given priorities and sizes, and logs the priorities it evicts
+class TestClient : public MemoryBudget::Client
+{
+public:
+  TestClient(MemoryBudget& budget, std::vector<double>& evicted) : budget(budget), evicted(evicted)
+  {
+    budget.registerClient(this);
+  }
+  ~TestClient() override { budget.unregisterClient(this); }
+
+  void add(double priority, size_t bytes) { entries.emplace_back(priority, bytes); }
+
+  [[nodiscard]] size_t memoryUsage() const override
+  {
+    size_t total = 0;
+    for (const auto& entry : entries) total += entry.second;
+    return total;
+  }
+  [[nodiscard]] std::optional<double> evictionPriority() const override
+  {
+    if (entries.empty()) return {};
+    return lowest()->first;
+  }
+  void evictOne() override
+  {
+    const auto it = lowest();
+    evicted.push_back(it->first);
+    entries.erase(it);
+  }
+
+private:
+  [[nodiscard]] std::vector<std::pair<double, size_t>>::const_iterator lowest() const
+  {
+    return std::min_element(entries.begin(), entries.end());
+  }
+
+  MemoryBudget& budget;
+  std::vector<double>& evicted;
+  std::vector<std::pair<double, size_t>> entries;
+};
+
+}  // namespace
+
+TEST_CASE("Memory budget is shared by its clients", "[memorybudget]")
+{
+  MemoryBudget budget;
+  std::vector<double> evicted;
+  TestClient a(budget, evicted);
+  TestClient b(budget, evicted);
+  for (const double priority : {1, 4, 5}) a.add(priority, MB);
+  for (const double priority : {2, 3, 6}) b.add(priority, MB);
+  CHECK(budget.usage() == 6 * MB);
+
+  SECTION("No limits by default")
+  {
+    budget.enforce();
+    CHECK(evicted.empty());
+    CHECK(budget.evictions() == 0);
+  }
+
+  SECTION("Setting a limit evicts the lowest priorities of all clients first")
+  {
+    budget.setLimitMB(3);
+    CHECK(evicted == std::vector<double>{1, 2, 3});
+    CHECK(a.memoryUsage() == 2 * MB);
+    CHECK(b.memoryUsage() == MB);
+    CHECK(budget.usage() == 3 * MB);
+    CHECK(budget.evictions() == 3);
+  }
+
+  SECTION("Growing one client evicts from the other")
+  {
+    budget.setLimitMB(6);
+    CHECK(evicted.empty());
+    b.add(7, 2 * MB);
+    budget.enforce();
+    CHECK(evicted == std::vector<double>{1, 2});
+    CHECK(a.memoryUsage() == 2 * MB);
+    CHECK(b.memoryUsage() == 4 * MB);
+  }
+
+  SECTION("A new entry of the lowest priority is evicted first")
+  {
+    budget.setLimitMB(6);
+    a.add(0.5, MB);
+    budget.enforce();
+    CHECK(evicted == std::vector<double>{0.5});
+    CHECK(budget.usage() == 6 * MB);
+  }
+
+  SECTION("Unregistered clients are neither counted nor evicted from")
+  {
+    std::vector<double> other_evicted;
+    {
+      TestClient c(budget, other_evicted);
+      c.add(0, 4 * MB);
+      CHECK(budget.usage() == 10 * MB);
+    }
+    CHECK(budget.usage() == 6 * MB);
+    budget.setLimitMB(5);
+    CHECK(other_evicted.empty());
+    CHECK(evicted == std::vector<double>{1});
+  }
+}
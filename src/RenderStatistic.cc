@@ -33,16 +33,22 @@
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "MemoryBudget.h"
+#include "core/enums.h"
 #include "geometry/Geometry.h"
 #include "geometry/GeometryCache.h"
+#include "geometry/GeometryEvaluator.h"
 #include "geometry/PolySet.h"
 #include "geometry/Polygon2d.h"
 #include "geometry/linalg.h"
 #include "glview/Camera.h"
 #include "json/json.hpp"
+#include "platform/PlatformUtils.h"
 #include "utils/printutils.h"
 #ifdef ENABLE_CGAL
 #include "geometry/cgal/CGALCache.h"
@@ -57,6 +63,46 @@ class GeometryList;
 
 namespace {
 
+struct PhaseTime {
+  double wall{0};  // seconds
+  double cpu{0};   // seconds
+};
+
+std::mutex phase_mutex;
+// In the order the phases were first entered
+std::vector<std::pair<std::string, PhaseTime>> phase_times;
+thread_local RenderStatistic::Phase *current_phase = nullptr;
+
+void addPhaseTime(const std::string& name, double wall, double cpu)
+{
+  const std::lock_guard<std::mutex> lock(phase_mutex);
+  auto it = std::find_if(phase_times.begin(), phase_times.end(),
+                         [&name](const auto& phase) { return phase.first == name; });
+  if (it == phase_times.end()) it = phase_times.insert(it, {name, PhaseTime{}});
+  it->second.wall += wall;
+  it->second.cpu += cpu;
+}
+
+std::vector<std::pair<std::string, PhaseTime>> phaseTimes()
+{
+  const std::lock_guard<std::mutex> lock(phase_mutex);
+  return phase_times;
+}
+
+const char *operatorName(OpenSCADOperator op)
+{
+  switch (op) {
+  case OpenSCADOperator::UNION:        return "union";
+  case OpenSCADOperator::INTERSECTION: return "intersection";
+  case OpenSCADOperator::DIFFERENCE:   return "difference";
+  case OpenSCADOperator::MINKOWSKI:    return "minkowski";
+  case OpenSCADOperator::HULL:         return "hull";
+  case OpenSCADOperator::FILL:         return "fill";
+  case OpenSCADOperator::RESIZE:       return "resize";
+  default:                             return "unknown";
+  }
+}
+
 struct StatisticVisitor : public GeometryVisitor {
   StatisticVisitor(const std::vector<std::string>& options)
     : all(std::find(options.begin(), options.end(), "all") != options.end()), options(options)
@@ -65,6 +111,8 @@ struct StatisticVisitor : public GeometryVisitor {
   virtual void printCamera(const Camera& camera) = 0;
   virtual void printCacheStatistic() = 0;
   virtual void printRenderingTime(std::chrono::milliseconds) = 0;
+  virtual void printMemoryStatistic() = 0;
+  virtual void printOperationStatistic() = 0;
   virtual void finish() = 0;
 
 protected:
@@ -92,6 +140,8 @@ struct LogVisitor : public StatisticVisitor {
   void printCamera(const Camera& camera) override;
   void printCacheStatistic() override;
   void printRenderingTime(std::chrono::milliseconds) override;
+  void printMemoryStatistic() override;
+  void printOperationStatistic() override;
   void finish() override;
 
 private:
@@ -123,6 +173,8 @@ struct StreamVisitor : public StatisticVisitor {
   void printCamera(const Camera& camera) override;
   void printCacheStatistic() override;
   void printRenderingTime(std::chrono::milliseconds) override;
+  void printMemoryStatistic() override;
+  void printOperationStatistic() override;
   void finish() override;
 
 private:
@@ -165,18 +217,66 @@ static nlohmann::json getCache(C cache)
   cacheJson["entries"] = cache->size();
   cacheJson["bytes"] = cache->totalCost();
   cacheJson["max_size"] = cache->maxSizeMB() * 1024 * 1024;
+  cacheJson["hits"] = cache->hits();
+  cacheJson["misses"] = cache->misses();
+  const auto lookups = cache->hits() + cache->misses();
+  cacheJson["hit_ratio"] = lookups ? static_cast<double>(cache->hits()) / lookups : 0.0;
+  cacheJson["evictions"] = cache->evictions();
+  cacheJson["compute_time"] = cache->computeTime();
   return cacheJson;
 }
 
 }  // namespace
 
+RenderStatistic::Phase::Phase(const char *name) : name(name), outer(current_phase)
+{
+  if (outer) outer->record();
+  current_phase = this;
+  wall_begin = std::chrono::steady_clock::now();
+  cpu_begin = PlatformUtils::processCPUTime();
+}
+
+RenderStatistic::Phase::~Phase()
+{
+  record();
+  current_phase = outer;
+  if (outer) {
+    // Continue timing the outer phase from here
+    outer->wall_begin = std::chrono::steady_clock::now();
+    outer->cpu_begin = PlatformUtils::processCPUTime();
+  }
+}
+
+void RenderStatistic::Phase::record()
+{
+  const auto wall_end = std::chrono::steady_clock::now();
+  const double cpu_end = PlatformUtils::processCPUTime();
+  addPhaseTime(name, std::chrono::duration<double>(wall_end - wall_begin).count(), cpu_end - cpu_begin);
+  wall_begin = wall_end;
+  cpu_begin = cpu_end;
+}
+
+void RenderStatistic::resetPhases()
+{
+  const std::lock_guard<std::mutex> lock(phase_mutex);
+  phase_times.clear();
+}
+
 RenderStatistic::RenderStatistic() : begin(std::chrono::steady_clock::now())
 {
+  GeometryEvaluator::resetOperationCounts();
+#ifdef ENABLE_MANIFOLD
+  ManifoldUtils::resetConversionStatistics();
+#endif
 }
 
 void RenderStatistic::start()
 {
   begin = std::chrono::steady_clock::now();
+  GeometryEvaluator::resetOperationCounts();
+#ifdef ENABLE_MANIFOLD
+  ManifoldUtils::resetConversionStatistics();
+#endif
 }
 
 std::chrono::milliseconds RenderStatistic::ms()
@@ -214,6 +314,8 @@ void RenderStatistic::printAll(const std::shared_ptr<const Geometry>& geom, cons
 
   visitor->printCacheStatistic();
   visitor->printRenderingTime(ms());
+  visitor->printMemoryStatistic();
+  visitor->printOperationStatistic();
   if (geom && !geom->isEmpty()) {
     geom->accept(*visitor);
   }
@@ -323,6 +425,13 @@ void LogVisitor::printCacheStatistic()
 #ifdef ENABLE_CGAL
   CGALCache::instance()->print();
 #endif
+#ifdef ENABLE_MANIFOLD
+  const auto conversions = ManifoldUtils::conversionStatistics();
+  if (conversions.conversions > 0) {
+    LOG("PolySet -> Manifold conversions: %1$d (%2$d direct, %3$d repaired)", conversions.conversions,
+        conversions.direct, conversions.repaired);
+  }
+#endif
 }
 
 void LogVisitor::printRenderingTime(const std::chrono::milliseconds ms)
@@ -330,6 +439,33 @@ void LogVisitor::printRenderingTime(const std::chrono::milliseconds ms)
   // always enabled
   LOG("Total rendering time: %1$d:%2$02d:%3$02d.%4$03d", (ms.count() / 1000 / 60 / 60),
       (ms.count() / 1000 / 60 % 60), (ms.count() / 1000 % 60), (ms.count() % 1000));
+  if (is_enabled(RenderStatistic::TIME)) {
+    const auto phases = phaseTimes();
+    if (!phases.empty()) LOG("Phases:");
+    for (const auto& [name, time] : phases) {
+      LOG("   %1$-20s wall %2$.3f s, cpu %3$.3f s", name, time.wall, time.cpu);
+    }
+  }
+}
+
+void LogVisitor::printMemoryStatistic()
+{
+  if (is_enabled(RenderStatistic::MEMORY)) {
+    LOG("Memory:");
+    LOG("   Peak resident: %1$d MB", PlatformUtils::peakResidentMemory() / (1024 * 1024));
+    LOG("   Resident:      %1$d MB", PlatformUtils::residentMemory() / (1024 * 1024));
+    LOG("   Caches:        %1$d MB", MemoryBudget::instance()->usage() / (1024 * 1024));
+  }
+}
+
+void LogVisitor::printOperationStatistic()
+{
+  if (is_enabled(RenderStatistic::OPERATIONS)) {
+    LOG("Operations:");
+    for (const auto& [op, count] : GeometryEvaluator::operationCounts()) {
+      LOG("   %1$-13s %2$6d", operatorName(op), count);
+    }
+  }
 }
 
 void LogVisitor::finish()
@@ -430,6 +566,14 @@ void StreamVisitor::printCacheStatistic()
 #ifdef ENABLE_CGAL
     cacheJson["cgal_cache"] = getCache(CGALCache::instance());
 #endif  // ENABLE_CGAL
+#ifdef ENABLE_MANIFOLD
+    const auto conversions = ManifoldUtils::conversionStatistics();
+    nlohmann::json conversionsJson;
+    conversionsJson["total"] = conversions.conversions;
+    conversionsJson["direct"] = conversions.direct;
+    conversionsJson["repaired"] = conversions.repaired;
+    cacheJson["manifold_conversions"] = conversionsJson;
+#endif  // ENABLE_MANIFOLD
     json["cache"] = cacheJson;
   }
 }
@@ -446,10 +590,40 @@ void StreamVisitor::printRenderingTime(const std::chrono::milliseconds ms)
     timeJson["seconds"] = ms.count() / 1000 % 60;
     timeJson["minutes"] = ms.count() / 1000 / 60 % 60;
     timeJson["hours"] = ms.count() / 1000 / 60 / 60;
+    nlohmann::json phasesJson = nlohmann::json::object();
+    for (const auto& [name, time] : phaseTimes()) {
+      nlohmann::json phaseJson;
+      phaseJson["wall"] = time.wall * 1000;
+      phaseJson["cpu"] = time.cpu * 1000;
+      phasesJson[name] = phaseJson;
+    }
+    timeJson["phases"] = phasesJson;
     json["time"] = timeJson;
   }
 }
 
+void StreamVisitor::printMemoryStatistic()
+{
+  if (is_enabled(RenderStatistic::MEMORY)) {
+    nlohmann::json memoryJson;
+    memoryJson["peak_resident"] = PlatformUtils::peakResidentMemory();
+    memoryJson["resident"] = PlatformUtils::residentMemory();
+    memoryJson["caches"] = MemoryBudget::instance()->usage();
+    json["memory"] = memoryJson;
+  }
+}
+
+void StreamVisitor::printOperationStatistic()
+{
+  if (is_enabled(RenderStatistic::OPERATIONS)) {
+    nlohmann::json operationsJson = nlohmann::json::object();
+    for (const auto& [op, count] : GeometryEvaluator::operationCounts()) {
+      operationsJson[operatorName(op)] = count;
+    }
+    json["operations"] = operationsJson;
+  }
+}
+
 void StreamVisitor::finish()
 {
   stream << json;
@@ -46,6 +46,46 @@ public:
   constexpr static auto GEOMETRY = "geometry";
   constexpr static auto BOUNDING_BOX = "bounding-box";
   constexpr static auto AREA = "area";
+  constexpr static auto MEMORY = "memory";
+  constexpr static auto OPERATIONS = "operations";
+
+  // Phases timed for the "time" statistic
+  constexpr static auto PARSE = "parse";
+  constexpr static auto INSTANTIATE = "instantiate";
+  constexpr static auto CSG_TREE = "csg_tree";
+  constexpr static auto GEOMETRY_EVALUATION = "geometry_evaluation";
+  constexpr static auto BACKEND_CONVERSION = "backend_conversion";
+  constexpr static auto EXPORT = "export";
+
+  /**
+   * Measures the wall clock and CPU time from construction to destruction
+   * as time spent in the named phase. Time spent in a phase nested on the
+   * same thread only counts for the nested phase, so the phases add up to
+   * the time they cover. CPU time is that of the whole process, including
+   * worker threads.
+   */
+  class Phase
+  {
+  public:
+    explicit Phase(const char *name);
+    ~Phase();
+    Phase(const Phase&) = delete;
+    Phase& operator=(const Phase&) = delete;
+
+  private:
+    void record();
+
+    const char *name;
+    Phase *outer;
+    std::chrono::steady_clock::time_point wall_begin;
+    double cpu_begin;
+  };
+
+  /**
+   * Forget the times of all phases. Called when a top level compile starts,
+   * so the times only cover that compile.
+   */
+  static void resetPhases();
 
   /**
    * Construct a statistic printer for the given geometry with current
@@ -54,7 +94,8 @@ public:
   RenderStatistic();
 
   /**
-   * Set start time when reusing a RenderStatistic instance.
+   * Set start time when reusing a RenderStatistic instance. Times of
+   * phases are kept, as parsing usually happens before.
    */
   void start();
 
@@ -65,7 +106,8 @@ public:
 
   /**
    * Print some statistic on cache usage. Namely, stats on the @ref GeometryCache
-   * and @ref CGALCache (if enabled).
+   * and @ref CGALCache (if enabled), and the number of PolySet to Manifold
+   * conversions since start().
    */
   void printCacheStatistic();
 
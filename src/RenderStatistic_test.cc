@@ -0,0 +1,98 @@
+#include "RenderStatistic.h"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "core/CsgOpNode.h"
+#include "core/ModuleInstantiation.h"
+#include "core/Tree.h"
+#include "core/enums.h"
+#include "core/primitives.h"
+#include "geometry/GeometryCache.h"
+#include "geometry/GeometryEvaluator.h"
+#include "glview/Camera.h"
+#include "json/json.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+nlohmann::json summary(RenderStatistic& statistic, const std::shared_ptr<const Geometry>& geom)
+{
+  const auto path =
+    fs::temp_directory_path() /
+    ("openscad-summary-test-" +
+     std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".json");
+  statistic.printAll(geom, Camera(), {"all"}, path.string());
+  std::ifstream input(path);
+  auto json = nlohmann::json::parse(input);
+  input.close();
+  std::error_code ec;
+  fs::remove(path, ec);
+  return json;
+}
+
+}  // namespace
+
+TEST_CASE("Summary reports cache, operation, memory and phase statistics", "[summary]")
+{
+  // difference() { square(2); square(1); }
+  const ModuleInstantiation mi("difference");
+  auto root = std::make_shared<CsgOpNode>(&mi, OpenSCADOperator::DIFFERENCE);
+  auto outer = std::make_shared<SquareNode>(&mi);
+  outer->x = outer->y = 2;
+  root->children.push_back(outer);
+  root->children.push_back(std::make_shared<SquareNode>(&mi));
+  const Tree tree(root);
+
+  GeometryCache::instance()->clear();
+  RenderStatistic before;
+  const auto cache = summary(before, nullptr)["cache"]["geometry_cache"];
+  const size_t hits = cache["hits"];
+  const size_t misses = cache["misses"];
+
+  RenderStatistic::resetPhases();
+  RenderStatistic statistic;
+  std::shared_ptr<const Geometry> geom;
+  {
+    const RenderStatistic::Phase phase(RenderStatistic::GEOMETRY_EVALUATION);
+    geom = GeometryEvaluator(tree).evaluateGeometry(*root, false);
+  }
+  REQUIRE(geom);
+
+  SECTION("First evaluation misses each node once")
+  {
+    const auto json = summary(statistic, geom);
+    CHECK(json["cache"]["geometry_cache"]["hits"] == hits);
+    CHECK(json["cache"]["geometry_cache"]["misses"] == misses + 3);
+    CHECK(json["operations"]["difference"] == 1);
+    CHECK(json["memory"]["peak_resident"] > 0);
+    CHECK(json["memory"]["caches"] > 0);
+    CHECK(json["time"]["phases"].contains(RenderStatistic::GEOMETRY_EVALUATION));
+    CHECK(json["time"]["phases"][RenderStatistic::GEOMETRY_EVALUATION]["wall"] >= 0);
+  }
+
+  SECTION("Second evaluation hits the root only")
+  {
+    statistic.start();
+    GeometryEvaluator(tree).evaluateGeometry(*root, false);
+    const auto json = summary(statistic, geom);
+    const auto& geometryCache = json["cache"]["geometry_cache"];
+    CHECK(geometryCache["hits"] == hits + 1);
+    CHECK(geometryCache["misses"] == misses + 3);
+    CHECK(geometryCache["hit_ratio"].get<double>() ==
+          Catch::Approx(static_cast<double>(hits + 1) / (hits + misses + 4)));
+    // Operation counts start over, cached results don't count
+    CHECK(json["operations"].empty());
+  }
+
+  SECTION("Phase times start over for each compile")
+  {
+    RenderStatistic::resetPhases();
+    CHECK(summary(statistic, geom)["time"]["phases"].empty());
+  }
+}
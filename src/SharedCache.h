@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Cache.h"
+#include "MemoryBudget.h"
+
+/*!
+   A Cache which can be used from several threads and takes part in the MemoryBudget.
+
+   Entries are copied out on lookup, so they should be small and hold their data by
+   shared_ptr. An entry found this way stays valid after it is evicted.
+ */
+template <class Key, class T>
+class SharedCache : public MemoryBudget::Client
+{
+public:
+  explicit SharedCache(size_t maxCost) : cache(maxCost) { MemoryBudget::instance()->registerClient(this); }
+  ~SharedCache() override { MemoryBudget::instance()->unregisterClient(this); }
+  SharedCache(const SharedCache&) = delete;
+  SharedCache& operator=(const SharedCache&) = delete;
+
+  std::optional<T> find(const Key& key) const
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (const T *entry = cache[key]) return *entry;
+    return {};
+  }
+  // cost is the number of bytes held by the entry, computeTime the seconds it took to compute
+  bool insert(const Key& key, T entry, size_t cost, double computeTime = 0)
+  {
+    bool inserted;
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      inserted = cache.insert(key, new T(std::move(entry)), cost, computeTime);
+    }
+    // The budget may evict from this cache, so it has to be unlocked
+    MemoryBudget::instance()->enforce();
+    return inserted;
+  }
+  struct Insertion {
+    Key key;
+    T entry;
+    size_t cost;
+    double computeTime{0};
+  };
+  // Like insert() for each of the entries, but only enforces the budget once
+  void insertAll(std::vector<Insertion> entries)
+  {
+    if (entries.empty()) return;
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      for (auto& insertion : entries) {
+        cache.insert(insertion.key, new T(std::move(insertion.entry)), insertion.cost,
+                     insertion.computeTime);
+      }
+    }
+    MemoryBudget::instance()->enforce();
+  }
+  void remove(const Key& key)
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    cache.remove(key);
+  }
+  void clear()
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    cache.clear();
+  }
+
+  [[nodiscard]] size_t size() const
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return cache.size();
+  }
+  [[nodiscard]] size_t hits() const
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return cache.hits();
+  }
+  [[nodiscard]] size_t misses() const
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return cache.misses();
+  }
+
+  [[nodiscard]] size_t memoryUsage() const override
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return cache.totalCost();
+  }
+  [[nodiscard]] std::optional<double> evictionPriority() const override
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    return cache.nextEvictionPriority();
+  }
+  void evictOne() override
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    cache.evictNext();
+  }
+
+private:
+  mutable std::mutex mutex;
+  Cache<Key, T> cache;
+};
@@ -61,6 +61,7 @@ extern void register_builtin_cgaladv();
 extern void register_builtin_offset();
 extern void register_builtin_linear_extrude();
 extern void register_builtin_rotate_extrude();
+extern void register_builtin_sweep();
 #if defined(ENABLE_EXPERIMENTAL) && defined(ENABLE_CGAL)
 extern void register_builtin_roof();
 #endif
@@ -92,6 +93,7 @@ void Builtins::initialize()
   register_builtin_offset();
   register_builtin_linear_extrude();
   register_builtin_rotate_extrude();
+  register_builtin_sweep();
 #if defined(ENABLE_EXPERIMENTAL) && defined(ENABLE_CGAL)
   register_builtin_roof();
 #endif
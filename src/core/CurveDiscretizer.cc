@@ -16,6 +16,7 @@
 #include "core/Parameters.h"
 #include "geometry/Grid.h"
 #include "geometry/Polygon2d.h"
+#include "glview/RenderSettings.h"
 #include "utils/calc.h"
 #include "utils/degree_trig.h"
 #include "utils/printutils.h"
@@ -51,6 +52,7 @@ CurveDiscretizer::CurveDiscretizer(const Parameters& parameters, const Location&
         F_MINIMUM);
     fa = F_MINIMUM;
   }
+  applyPreviewLimit(parameters);
 }
 
 CurveDiscretizer::CurveDiscretizer(const Parameters& parameters)
@@ -59,6 +61,27 @@ CurveDiscretizer::CurveDiscretizer(const Parameters& parameters)
   fe = std::max(parameters["$fe"].toDouble(), 0.0);
   fs = std::max(parameters["$fs"].toDouble(), F_MINIMUM);
   fa = std::max(parameters["$fa"].toDouble(), F_MINIMUM);
+  applyPreviewLimit(parameters);
+}
+
+/*!
+   Previews may trade accuracy for speed by capping the number of segments per
+   full circle. The cap is part of the discretizer's string representation, so
+   preview and render geometries get different node IDs and are cached separately.
+ */
+void CurveDiscretizer::applyPreviewLimit(const Parameters& parameters)
+{
+  const unsigned int limit = RenderSettings::inst()->previewMaxSegments;
+  if (limit > 0 && parameters["$preview"].toBool()) {
+    max_segments = std::max(limit, 3u);
+  }
+}
+
+int CurveDiscretizer::limitSegments(int segments, double angle_degrees, int min_segments) const
+{
+  if (max_segments == 0) return segments;
+  const int limit = static_cast<int>(std::ceil(max_segments * std::fabs(angle_degrees) / 360.0));
+  return std::max(std::min(segments, limit), min_segments);
 }
 
 CurveDiscretizer::CurveDiscretizer(double segmentsPerCircle)
@@ -150,7 +173,7 @@ std::optional<int> CurveDiscretizer::getCircularSegmentCount(double r, double an
     }
     result *= std::fabs(angle_degrees) / 360.0;
   }
-  return std::max(1, static_cast<int>(std::ceil(result)));
+  return limitSegments(std::max(1, static_cast<int>(std::ceil(result))), angle_degrees, 1);
 }
 
 /*
@@ -263,15 +286,16 @@ std::optional<int> CurveDiscretizer::getHelixSlices(double r_sqr, double height,
     return {};
   if (fn > 0.0) {
     const int fn_slices = static_cast<int>(std::ceil(twist_degrees / 360.0 * fn));
-    return std::max(fn_slices, min_slices);
+    return limitSegments(std::max(fn_slices, min_slices), twist_degrees, min_slices);
   }
   if (fe > 0.0) {
-    return helix_slices_given_fe(fe, r_sqr, twist_degrees, min_slices);
+    return limitSegments(helix_slices_given_fe(fe, r_sqr, twist_degrees, min_slices), twist_degrees,
+                         min_slices);
   }
 
   const int fa_slices = static_cast<int>(std::ceil(twist_degrees / fa));
   const int fs_slices = static_cast<int>(std::ceil(helix_arc_length(r_sqr, height, twist_degrees) / fs));
-  return std::max(std::min(fa_slices, fs_slices), min_slices);
+  return limitSegments(std::max(std::min(fa_slices, fs_slices), min_slices), twist_degrees, min_slices);
 }
 
 /*
@@ -297,7 +321,7 @@ std::optional<int> CurveDiscretizer::getConicalHelixSlices(double r_sqr, double
   if (r < GRID_FINE || std::isinf(fn) || std::isnan(fn)) return {};
   if (fn > 0.0) {
     const int fn_slices = static_cast<int>(ceil(twist_degrees * fn / 360));
-    return std::max(fn_slices, min_slices);
+    return limitSegments(std::max(fn_slices, min_slices), twist_degrees, min_slices);
   }
   /*
      Spiral length equation assumes starting from theta=0
@@ -338,7 +362,7 @@ std::optional<int> CurveDiscretizer::getConicalHelixSlices(double r_sqr, double
 
   const int fs_slices = static_cast<int>(ceil(total_length / fs));
   const int fa_slices = static_cast<int>(ceil(twist_degrees / fa));
-  return std::max(std::min(fa_slices, fs_slices), min_slices);
+  return limitSegments(std::max(std::min(fa_slices, fs_slices), min_slices), twist_degrees, min_slices);
 }
 
 std::optional<int> CurveDiscretizer::getDiagonalSlices(double delta_sqr, double height) const
@@ -540,6 +564,9 @@ std::ostream& operator<<(std::ostream& stream, const CurveDiscretizer& f)
   } else {
     stream << "$fn = " << f.fn << ", $fa = " << f.fa << ", $fs = " << f.fs;
   }
+  if (f.max_segments > 0) {
+    stream << ", $preview_max_segments = " << f.max_segments;
+  }
   return stream;
 }
 
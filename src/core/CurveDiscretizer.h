@@ -94,10 +94,14 @@ public:
 
 private:
   CurveDiscretizer(double fn, double fs, double fa) : fn(fn), fs(fs), fa(fa) {}
+  void applyPreviewLimit(const Parameters& parameters);
+  [[nodiscard]] int limitSegments(int segments, double angle_degrees, int min_segments) const;
 
 protected:
   friend class RoofDiscretizer;
   double fn, fs, fa, fe;
+  // Segments per full circle allowed in preview (see RenderSettings::previewMaxSegments), 0 if unlimited
+  unsigned int max_segments{0};
 };
 std::ostream& operator<<(std::ostream& stream, const CurveDiscretizer& f);
 
@@ -83,6 +83,20 @@ void DrawingCallback::add_vertex(const Vector2d& v)
   this->outline.vertices.push_back(size * (v + offset + advance));
 }
 
+void DrawingCallback::add_outlines(const Polygon2d::Outlines2d& outlines)
+{
+  if (this->outline.vertices.size() > 0) {
+    this->polygon->addOutline(this->outline);
+    this->outline.vertices.clear();
+  }
+  for (const auto& o : outlines) {
+    this->outline.vertices.reserve(o.vertices.size());
+    for (const auto& v : o.vertices) add_vertex(v);
+    this->polygon->addOutline(this->outline);
+    this->outline.vertices.clear();
+  }
+}
+
 void DrawingCallback::move_to(const Vector2d& to)
 {
   if (this->outline.vertices.size() > 0) {
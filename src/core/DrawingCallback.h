@@ -53,6 +53,9 @@ public:
   void curve_to(const Vector2d& c1, const Vector2d& to);
   void curve_to(const Vector2d& c1, const Vector2d& c2, const Vector2d& to);
 
+  // Add already discretized outlines (in unscaled glyph coordinates) to the current glyph.
+  void add_outlines(const Polygon2d::Outlines2d& outlines);
+
 private:
   Vector2d pen;
   Vector2d offset;
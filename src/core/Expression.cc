@@ -49,6 +49,7 @@
 #include "core/Parameters.h"
 #include "core/Value.h"
 #include "core/function.h"
+#include "core/progress.h"
 #include "utils/StackCheck.h"
 #include "utils/boost-utils.h"
 #include "utils/compiler_specific.h"
@@ -623,6 +624,8 @@ Value FunctionCall::evaluate(const std::shared_ptr<const Context>& context) cons
       }
       if (simplified_expression->new_active_function_call) {
         current_call = *simplified_expression->new_active_function_call;
+        // Tail recursion may loop for a long time without any other call being evaluated
+        progress_check_cancel();
         if (recursion_depth++ == 1000000) {
           LOG(message_group::Error, expression->location(), expression_context->documentRoot(),
               "Recursion detected calling function '%1$s'", current_call->name);
@@ -880,6 +883,8 @@ static void doForEach(const AssignmentList& assignments, const Location& locatio
                       const std::function<void(size_t)> *pReserve = nullptr)
 {
   if (assignment_index >= assignments.size()) {
+    // Polled once per iteration, rather than on every function call
+    progress_check_cancel();
     operation(context);
     return;
   }
@@ -981,6 +986,7 @@ Value LcForC::evaluate(const std::shared_ptr<const Context>& context) const
 
   unsigned int counter = 0;
   while (this->cond->evaluate(*currentContext).toBool()) {
+    progress_check_cancel();
     output.emplace_back(this->expr->evaluate(*currentContext));
 
     if (counter++ == 1000000) {
@@ -30,18 +30,23 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <iterator>
 #include <limits>
 #include <memory>
 #include <ostream>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "FontCache.h"
+#include "SharedCache.h"
 #include "core/CurveDiscretizer.h"
 #include "core/DrawingCallback.h"
 #include "core/Value.h"
+#include "geometry/Polygon2d.h"
 #include "geometry/linalg.h"
 #include "utils/calc.h"
 #include "utils/printutils.h"
@@ -58,6 +63,20 @@ static inline Vector2d get_scaled_vector(const FT_Vector *ft_vector, double scal
 
 const double FreetypeRenderer::scale = 1e5;
 
+namespace {
+
+// Glyph outlines only depend on the font face, the glyph index and the number
+// of segments used for curves (derived from $fn/$fa/$fs and the text size).
+// Since all faces are loaded at the same fixed character size, the cached
+// outlines can be offset and scaled into place for any text() call.
+struct GlyphCacheEntry {
+  std::shared_ptr<const Polygon2d::Outlines2d> outlines;
+};
+
+SharedCache<std::string, GlyphCacheEntry> glyph_cache(16ul * 1024ul * 1024ul);
+
+}  // namespace
+
 FreetypeRenderer::FreetypeRenderer()
 {
   funcs.move_to = outline_move_to_func;
@@ -375,6 +394,7 @@ FreetypeRenderer::ShapeResults::ShapeResults(const FreetypeRenderer::Params& par
     return;
   }
 
+  face_id = face->id_;
   hb_ft_font = hb_ft_font_create(face->face_, nullptr);
 
   hb_buf = hb_buffer_create();
@@ -448,7 +468,7 @@ FreetypeRenderer::ShapeResults::ShapeResults(const FreetypeRenderer::Params& par
       continue;
     }
 
-    glyph_array.emplace_back(glyph, idx, &glyph_pos[idx]);
+    glyph_array.emplace_back(glyph, glyph_index, idx, &glyph_pos[idx]);
   }
 
   ascent = std::numeric_limits<double>::lowest();
@@ -592,6 +612,38 @@ FreetypeRenderer::TextMetrics::TextMetrics(const FreetypeRenderer::Params& param
   ok = true;
 }
 
+void FreetypeRenderer::clearGlyphCache()
+{
+  glyph_cache.clear();
+}
+
+std::shared_ptr<const Polygon2d::Outlines2d> FreetypeRenderer::get_glyph_outlines(
+  const std::string& face_id, const GlyphData& glyph, unsigned int segments) const
+{
+  // Faces not loaded through fontconfig have no stable identity, so skip the cache
+  std::string key;
+  if (!face_id.empty()) {
+    key = STR(face_id, ":", glyph.get_glyph_index(), ":", segments);
+    if (const auto entry = glyph_cache.find(key)) return entry->outlines;
+  }
+
+  DrawingCallback callback(segments, 1.0);
+  callback.start_glyph();
+  FT_Outline outline = reinterpret_cast<FT_OutlineGlyph>(glyph.get_glyph())->outline;
+  FT_Outline_Decompose(&outline, &funcs, &callback);
+  callback.finish_glyph();
+  const auto result = callback.get_result();
+  auto outlines = std::make_shared<Polygon2d::Outlines2d>();
+  if (!result.empty()) *outlines = result.front()->outlines();
+
+  if (!key.empty()) {
+    size_t cost = sizeof(GlyphCacheEntry) + key.size();
+    for (const auto& o : *outlines) cost += sizeof(Outline2d) + o.vertices.size() * sizeof(Vector2d);
+    glyph_cache.insert(key, {.outlines = outlines}, cost);
+  }
+  return outlines;
+}
+
 std::vector<std::shared_ptr<const Polygon2d>> FreetypeRenderer::render(
   const FreetypeRenderer::Params& params) const
 {
@@ -605,8 +657,7 @@ std::vector<std::shared_ptr<const Polygon2d>> FreetypeRenderer::render(
   for (const auto& glyph : sr.glyph_array) {
     callback.start_glyph();
     callback.set_glyph_offset(sr.x_offset + glyph.get_x_offset(), sr.y_offset + glyph.get_y_offset());
-    FT_Outline outline = reinterpret_cast<FT_OutlineGlyph>(glyph.get_glyph())->outline;
-    FT_Outline_Decompose(&outline, &funcs, &callback);
+    callback.add_outlines(*get_glyph_outlines(sr.face_id, glyph, params.segments));
 
     double adv_x = glyph.get_x_advance() * params.spacing;
     double adv_y = glyph.get_y_advance() * params.spacing;
@@ -38,6 +38,7 @@
 #include "core/AST.h"
 #include "core/CurveDiscretizer.h"
 #include "core/Parameters.h"
+#include "geometry/Polygon2d.h"
 #include FT_FREETYPE_H
 #include FT_GLYPH_H
 
@@ -142,6 +143,8 @@ public:
   [[nodiscard]] std::vector<std::shared_ptr<const class Polygon2d>> render(
     const FreetypeRenderer::Params& params) const;
 
+  static void clearGlyphCache();
+
 private:
   const static double scale;
   FT_Outline_Funcs funcs;
@@ -153,11 +156,12 @@ private:
   class GlyphData
   {
   public:
-    GlyphData(FT_Glyph glyph, unsigned int idx, hb_glyph_position_t *glyph_pos)
-      : glyph(glyph), idx(idx), glyph_pos(glyph_pos)
+    GlyphData(FT_Glyph glyph, FT_UInt glyph_index, unsigned int idx, hb_glyph_position_t *glyph_pos)
+      : glyph(glyph), glyph_index(glyph_index), idx(idx), glyph_pos(glyph_pos)
     {
     }
     [[nodiscard]] unsigned int get_idx() const { return idx; }
+    [[nodiscard]] FT_UInt get_glyph_index() const { return glyph_index; }
     [[nodiscard]] FT_Glyph get_glyph() const { return glyph; }
     [[nodiscard]] double get_x_offset() const { return glyph_pos->x_offset / scale; }
     [[nodiscard]] double get_y_offset() const { return glyph_pos->y_offset / scale; }
@@ -167,6 +171,7 @@ private:
 
   private:
     FT_Glyph glyph;
+    FT_UInt glyph_index;
     unsigned int idx;
     hb_glyph_position_t *glyph_pos;
   };
@@ -180,6 +185,8 @@ private:
     // when rendering from Freetype, and have not yet been scaled
     // back up to the desired font size.
     std::vector<GlyphData> glyph_array;
+    // Identifies the font face the glyphs were loaded from, see FontFace::id_
+    std::string face_id;
     double x_offset{0.0};
     double y_offset{0.0};
     double left{0.0};
@@ -200,6 +207,11 @@ private:
     hb_buffer_t *hb_buf{nullptr};
   };
 
+  // Returns the discretized outlines of a single glyph in unscaled font units,
+  // shared between all render() calls using the same face and segment count.
+  [[nodiscard]] std::shared_ptr<const Polygon2d::Outlines2d> get_glyph_outlines(
+    const std::string& face_id, const GlyphData& glyph, unsigned int segments) const;
+
   static int outline_move_to_func(const FT_Vector *to, void *user);
   static int outline_line_to_func(const FT_Vector *to, void *user);
   static int outline_conic_to_func(const FT_Vector *c1, const FT_Vector *to, void *user);
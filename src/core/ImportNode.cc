@@ -97,6 +97,7 @@ static std::shared_ptr<AbstractNode> do_import(const ModuleInstantiation *inst,
     else if (ext == ".amf") actualtype = ImportType::AMF;
     else if (ext == ".svg") actualtype = ImportType::SVG;
     else if (ext == ".obj") actualtype = ImportType::OBJ;
+    else if (ext == ".binmesh") actualtype = ImportType::BINMESH;
   }
 
   auto node =
@@ -203,23 +204,37 @@ std::unique_ptr<const Geometry> ImportNode::createGeometry() const
 
   switch (this->type) {
   case ImportType::STL: {
-    g = optionally_center(import_stl(this->filename, loc), this->center);
+    auto ps = import_mesh_cached(this->filename, "stl",
+                                 [&]() { return import_stl(this->filename, loc); });
+    g = optionally_center(std::move(ps), this->center);
     break;
   }
   case ImportType::AMF: {
-    g = optionally_center(import_amf(this->filename, loc), this->center);
+    auto ps = import_mesh_cached(this->filename, "amf",
+                                 [&]() { return import_amf(this->filename, loc); });
+    g = optionally_center(std::move(ps), this->center);
     break;
   }
   case ImportType::_3MF: {
-    g = optionally_center(import_3mf(this->filename, loc), this->center);
+    auto ps = import_mesh_cached(this->filename, "3mf",
+                                 [&]() { return import_3mf(this->filename, loc); });
+    g = optionally_center(std::move(ps), this->center);
     break;
   }
   case ImportType::OFF: {
-    g = optionally_center(import_off(this->filename, loc), this->center);
+    auto ps = import_mesh_cached(this->filename, "off",
+                                 [&]() { return import_off(this->filename, loc); });
+    g = optionally_center(std::move(ps), this->center);
     break;
   }
   case ImportType::OBJ: {
-    g = optionally_center(import_obj(this->filename, loc), this->center);
+    auto ps = import_mesh_cached(this->filename, "obj",
+                                 [&]() { return import_obj(this->filename, loc); });
+    g = optionally_center(std::move(ps), this->center);
+    break;
+  }
+  case ImportType::BINMESH: {
+    g = optionally_center(import_binmesh(this->filename, loc), this->center);
     break;
   }
   case ImportType::SVG: {
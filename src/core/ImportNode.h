@@ -19,6 +19,7 @@ enum class ImportType {
   DXF,
   NEF3,
   OBJ,
+  BINMESH,
 };
 
 class ImportNode : public LeafNode
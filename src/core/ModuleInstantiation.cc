@@ -9,6 +9,7 @@
 #include "core/Expression.h"
 #include "core/callables.h"
 #include "core/module.h"
+#include "core/progress.h"
 #include "utils/compiler_specific.h"
 #include "utils/exceptions.h"
 #include "utils/printutils.h"
@@ -73,6 +74,7 @@ static void NOINLINE print_trace(EvaluationException& e, const ModuleInstantiati
 std::shared_ptr<AbstractNode> ModuleInstantiation::evaluate(
   const std::shared_ptr<const Context>& context) const
 {
+  progress_check_cancel();
   boost::optional<InstantiableModule> module = context->lookup_module(this->name(), this->loc);
   if (!module) {
     return nullptr;
@@ -19,6 +19,7 @@ class NodeVisitor : public BaseVisitor,
                     public Visitor<class LinearExtrudeNode>,
                     public Visitor<class RotateExtrudeNode>,
                     public Visitor<class RoofNode>,
+                    public Visitor<class SweepNode>,
                     public Visitor<class ImportNode>,
                     public Visitor<class TextNode>,
                     public Visitor<class ProjectionNode>,
@@ -79,6 +80,10 @@ public:
   {
     return visit(state, (const AbstractPolyNode&)node);
   }
+  Response visit(State& state, const SweepNode& node) override
+  {
+    return visit(state, (const AbstractPolyNode&)node);
+  }
   Response visit(State& state, const ImportNode& node) override
   {
     return visit(state, (const LeafNode&)node);
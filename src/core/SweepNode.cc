@@ -0,0 +1,205 @@
+/*
+ *  OpenSCAD (www.openscad.org)
+ *  Copyright (C) 2009-2011 Clifford Wolf <clifford@clifford.at> and
+ *                          Marius Kintel <marius@kintel.net>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  As a special exception, you have permission to link this program
+ *  with the CGAL library and distribute executables, as long as you
+ *  follow the requirements of the GNU GPL in regard to all of the
+ *  software in the executable aside from CGAL.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "core/SweepNode.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "Feature.h"
+#include "core/Builtins.h"
+#include "core/Children.h"
+#include "core/ModuleInstantiation.h"
+#include "core/Parameters.h"
+#include "core/module.h"
+#include "utils/calc.h"
+#include "utils/printutils.h"
+
+namespace {
+
+bool getScale(const Value& value, Vector2d& scale)
+{
+  double x = 1.0, y = 1.0;
+  bool ok = value.getFiniteDouble(x);
+  ok &= value.getFiniteDouble(y);
+  ok |= value.getVec2(x, y, true);
+  if (!ok || !std::isfinite(x) || !std::isfinite(y)) return false;
+  scale = Vector2d(std::max(x, 0.0), std::max(y, 0.0));
+  return true;
+}
+
+std::shared_ptr<AbstractNode> builtin_sweep(const ModuleInstantiation *inst, Arguments arguments,
+                                            const Children& children)
+{
+  Parameters parameters = Parameters::parse(std::move(arguments), inst->location(),
+                                            {"path", "scale", "twist"}, {"convexity"});
+  parameters.set_caller("sweep");
+
+  auto node = std::make_shared<SweepNode>(inst, CurveDiscretizer(parameters, inst->location()));
+
+  // Scale and twist may be given per path point, so consecutive duplicate
+  // points are dropped together with their corresponding per-point values.
+  std::vector<size_t> kept;
+  if (parameters["path"].type() == Value::Type::VECTOR) {
+    const auto& points = parameters["path"].toVector();
+    for (size_t i = 0; i < points.size(); ++i) {
+      Vector3d point;
+      if (!points[i].getVec3(point[0], point[1], point[2], 0.0) || !std::isfinite(point[0]) ||
+          !std::isfinite(point[1]) || !std::isfinite(point[2])) {
+        LOG(message_group::Warning, inst->location(), parameters.documentRoot(),
+            "Unable to convert path[%1$d] = %2$s to a vec3 of numbers", i,
+            points[i].toEchoStringNoThrow());
+        continue;
+      }
+      if (!node->path.empty() && node->path.back() == point) continue;
+      node->path.push_back(point);
+      kept.push_back(i);
+    }
+  }
+  if (node->path.size() < 2) {
+    LOG(message_group::Warning, inst->location(), parameters.documentRoot(),
+        "sweep() requires a path of at least two distinct points, got path = %1$s",
+        parameters["path"].toEchoStringNoThrow());
+    node->path.clear();
+    children.instantiate(node);
+    return node;
+  }
+
+  // Relative arc length at each station, used to distribute a single scale or twist value
+  std::vector<double> t(node->path.size(), 0.0);
+  for (size_t i = 1; i < node->path.size(); ++i) {
+    t[i] = t[i - 1] + (node->path[i] - node->path[i - 1]).norm();
+  }
+  for (auto& ti : t) ti /= t.back();
+
+  // A single vec2 is always taken as [scale_x, scale_y]; for a two-point path,
+  // per-point uniform scales have to be written as [[s0, s0], [s1, s1]].
+  const Value& scaleValue = parameters["scale"];
+  node->scale.assign(node->path.size(), Vector2d(1, 1));
+  if (scaleValue.isDefined()) {
+    Vector2d scale;
+    bool scaleOK = false;
+    if (getScale(scaleValue, scale)) {
+      for (size_t i = 0; i < t.size(); ++i) {
+        node->scale[i] = Vector2d(Calc::lerp(1, scale[0], t[i]), Calc::lerp(1, scale[1], t[i]));
+      }
+      scaleOK = true;
+    } else if (scaleValue.type() == Value::Type::VECTOR &&
+               scaleValue.toVector().size() == parameters["path"].toVector().size()) {
+      scaleOK = true;
+      for (size_t i = 0; i < kept.size(); ++i) {
+        scaleOK &= getScale(scaleValue.toVector()[kept[i]], node->scale[i]);
+      }
+    }
+    if (!scaleOK) {
+      LOG(message_group::Warning, inst->location(), parameters.documentRoot(),
+          "sweep(..., scale=%1$s) could not be converted, expected a number, a vec2 or one of those "
+          "for each path point",
+          scaleValue.toEchoStringNoThrow());
+      node->scale.assign(node->path.size(), Vector2d(1, 1));
+    }
+  }
+
+  const Value& twistValue = parameters["twist"];
+  node->twist.assign(node->path.size(), 0.0);
+  if (twistValue.isDefined()) {
+    double twist = 0.0;
+    bool twistOK = false;
+    if (twistValue.getFiniteDouble(twist)) {
+      for (size_t i = 0; i < t.size(); ++i) node->twist[i] = twist * t[i];
+      twistOK = true;
+    } else if (twistValue.type() == Value::Type::VECTOR &&
+               twistValue.toVector().size() == parameters["path"].toVector().size()) {
+      twistOK = true;
+      for (size_t i = 0; i < kept.size(); ++i) {
+        twistOK &= twistValue.toVector()[kept[i]].getFiniteDouble(node->twist[i]);
+      }
+    }
+    if (!twistOK) {
+      LOG(message_group::Warning, inst->location(), parameters.documentRoot(),
+          "sweep(..., twist=%1$s) could not be converted, expected a number or one number for each "
+          "path point",
+          twistValue.toEchoStringNoThrow());
+      node->twist.assign(node->path.size(), 0.0);
+    }
+  }
+
+  parameters["convexity"].getPositiveInt(node->convexity);
+
+  children.instantiate(node);
+
+  return node;
+}
+
+}  // namespace
+
+std::string SweepNode::toString() const
+{
+  std::ostringstream stream;
+
+  stream << this->name() << "(path = [";
+  for (size_t i = 0; i < this->path.size(); ++i) {
+    if (i > 0) stream << ", ";
+    stream << "[" << this->path[i][0] << ", " << this->path[i][1] << ", " << this->path[i][2] << "]";
+  }
+  stream << "]";
+
+  bool has_scale = false, has_twist = false;
+  for (const auto& s : this->scale) has_scale |= s != Vector2d(1, 1);
+  for (const auto& t : this->twist) has_twist |= t != 0.0;
+  if (has_scale) {
+    stream << ", scale = [";
+    for (size_t i = 0; i < this->scale.size(); ++i) {
+      if (i > 0) stream << ", ";
+      stream << "[" << this->scale[i][0] << ", " << this->scale[i][1] << "]";
+    }
+    stream << "]";
+  }
+  if (has_twist) {
+    stream << ", twist = [";
+    for (size_t i = 0; i < this->twist.size(); ++i) {
+      if (i > 0) stream << ", ";
+      stream << this->twist[i];
+    }
+    stream << "]";
+  }
+
+  stream << ", " << this->discretizer << ", convexity = " << this->convexity << ")";
+  return stream.str();
+}
+
+void register_builtin_sweep()
+{
+  Builtins::init("sweep", new BuiltinModule(builtin_sweep, &Feature::ExperimentalSweep),
+                 {
+                   "sweep(path, scale = 1.0, twist = 0, convexity = 1)",
+                 });
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/CurveDiscretizer.h"
+#include "core/ModuleInstantiation.h"
+#include "core/node.h"
+#include "geometry/linalg.h"
+
+class SweepNode : public AbstractPolyNode
+{
+public:
+  VISITABLE();
+  SweepNode(const ModuleInstantiation *mi, CurveDiscretizer discretizer)
+    : AbstractPolyNode(mi), discretizer(std::move(discretizer))
+  {
+  }
+  std::string toString() const override;
+  std::string name() const override { return "sweep"; }
+
+  // One entry per path station; scale and twist are always the same length as path.
+  std::vector<Vector3d> path;
+  std::vector<Vector2d> scale;
+  std::vector<double> twist;
+  CurveDiscretizer discretizer;
+  unsigned int convexity = 1u;
+};
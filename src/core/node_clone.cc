@@ -39,6 +39,7 @@
 #include "core/RoofNode.h"
 #include "core/RotateExtrudeNode.h"
 #include "core/SurfaceNode.h"
+#include "core/SweepNode.h"
 #include "core/TextNode.h"
 #include "core/TransformNode.h"
 #include "core/node.h"
@@ -70,7 +71,7 @@ NodeCloneFunc(CubeNode) NodeCloneFunc(SphereNode) NodeCloneFunc(CylinderNode)
       NodeCloneFunc(RotateExtrudeNode) NodeCloneFunc(LinearExtrudeNode) NodeCloneFunc(CsgOpNode)
         NodeCloneFunc(CgalAdvNode) NodeCloneFunc(RenderNode) NodeCloneFunc(SurfaceNode)
           NodeCloneFunc(TextNode) NodeCloneFunc(OffsetNode) NodeCloneFunc(ProjectionNode)
-            NodeCloneFunc(GroupNode) NodeCloneFunc(ImportNode)
+            NodeCloneFunc(GroupNode) NodeCloneFunc(ImportNode) NodeCloneFunc(SweepNode)
 #if defined(ENABLE_EXPERIMENTAL) && defined(ENABLE_CGAL)
               NodeCloneFunc(RoofNode)
 #endif
@@ -84,7 +85,7 @@ NodeCloneFunc(CubeNode) NodeCloneFunc(SphereNode) NodeCloneFunc(CylinderNode)
         NodeCloneUse(LinearExtrudeNode) NodeCloneUse(CsgOpNode) NodeCloneUse(CgalAdvNode)
           NodeCloneUse(RenderNode) NodeCloneUse(SurfaceNode) NodeCloneUse(TextNode)
             NodeCloneUse(OffsetNode) NodeCloneUse(ProjectionNode) NodeCloneUse(GroupNode)
-              NodeCloneUse(ImportNode)
+              NodeCloneUse(ImportNode) NodeCloneUse(SweepNode)
 #if defined(ENABLE_EXPERIMENTAL) && defined(ENABLE_CGAL)
                 NodeCloneUse(RoofNode)
 #endif
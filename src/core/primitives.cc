@@ -119,6 +119,7 @@ std::unique_ptr<const Geometry> CubeNode::createGeometry() const
     z2 = this->z;
   }
   auto ps = std::make_unique<PolySet>(3, /*convex*/ true);
+  ps->setManifold(true);
   for (int i = 0; i < 8; i++) {
     ps->vertices.emplace_back(i & 1 ? x2 : x1, i & 2 ? y2 : y1, i & 4 ? z2 : z1);
   }
@@ -188,6 +189,7 @@ std::unique_ptr<const Geometry> SphereNode::createGeometry() const
   //  phi == 0 degrees
 
   auto polyset = std::make_unique<PolySet>(3, /*convex*/ true);
+  polyset->setManifold(true);
   polyset->vertices.reserve(num_rings * num_fragments);
 
   // double offset = 0.5 * ((fragments / 2) % 2);
@@ -270,6 +272,7 @@ std::unique_ptr<const Geometry> CylinderNode::createGeometry() const
   bool inverted_cone = (r1 == 0.0);
 
   auto polyset = std::make_unique<PolySet>(3, /*convex*/ true);
+  polyset->setManifold(true);
   polyset->vertices.reserve((cone || inverted_cone) ? num_fragments + 1 : 2 * num_fragments);
 
   if (inverted_cone) {
@@ -1,6 +1,8 @@
 #include "core/progress.h"
 
+#include <atomic>
 #include <memory>
+#include <utility>
 
 #include "core/node.h"
 
@@ -8,6 +10,7 @@ int progress_report_count;
 int progress_mark_;
 void (*progress_report_f)(const std::shared_ptr<const AbstractNode>&, void *, int);
 void *progress_report_userdata;
+thread_local CancellationToken progress_cancellation_token;
 
 void progress_report_prep(const std::shared_ptr<AbstractNode>& root,
                           void (*f)(const std::shared_ptr<const AbstractNode>& node, void *userdata,
@@ -27,8 +30,21 @@ void progress_report_fin()
   progress_report_userdata = nullptr;
 }
 
+void progress_set_cancellation_token(CancellationToken token)
+{
+  progress_cancellation_token = std::move(token);
+}
+
+void progress_check_cancel()
+{
+  if (progress_cancellation_token && progress_cancellation_token->load(std::memory_order_relaxed)) {
+    throw ProgressCancelException();
+  }
+}
+
 void progress_update(const std::shared_ptr<const AbstractNode>& node, int mark)
 {
+  progress_check_cancel();
   if (progress_report_f) {
     progress_mark_ = mark;
     progress_report_f(node, progress_report_userdata, progress_mark_);
@@ -37,6 +53,7 @@ void progress_update(const std::shared_ptr<const AbstractNode>& node, int mark)
 
 void progress_tick()
 {
+  progress_check_cancel();
   if (progress_report_f)
     progress_report_f(std::shared_ptr<const AbstractNode>(), progress_report_userdata, ++progress_mark_);
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 
 class AbstractNode;
@@ -20,6 +21,13 @@ void progress_update(const std::shared_ptr<const AbstractNode>& node, int mark);
 // exact node
 void progress_tick();
 
+// Cooperative cancellation of an evaluation running on another thread: the token installed for the
+// evaluating thread is polled by progress_check_cancel() in the evaluator and on each progress report,
+// which throw ProgressCancelException once it has been set.
+using CancellationToken = std::shared_ptr<std::atomic<bool>>;
+void progress_set_cancellation_token(CancellationToken token);
+void progress_check_cancel();
+
 class ProgressCancelException
 {
 };
@@ -6,13 +6,16 @@
 #include <cassert>
 #include <cmath>
 #include <cstddef>
+#include <iterator>
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <vector>
 
 #include "clipper2/clipper.h"
 #include "geometry/Polygon2d.h"
 #include "geometry/linalg.h"
+#include "utils/parallel.h"
 #include "utils/printutils.h"
 
 namespace ClipperUtils {
@@ -97,6 +100,74 @@ void fill_minkowski_insides(const Clipper2Lib::Paths64& a, const Clipper2Lib::Pa
   }
 }
 
+// Combines sets of paths pairwise in a balanced tree, running the independent
+// operations of each level in parallel, until at most max_remaining sets are left.
+// Only meaningful for associative operations, i.e. union and intersection.
+// Every Clipper run only sees the edges of two partial results, instead of
+// a single run sweeping over all input edges at once.
+std::vector<Clipper2Lib::Paths64> reduce(std::vector<Clipper2Lib::Paths64> pathsvector,
+                                         Clipper2Lib::ClipType clipType, size_t max_remaining)
+{
+  assert(clipType == Clipper2Lib::ClipType::Union || clipType == Clipper2Lib::ClipType::Intersection);
+  while (pathsvector.size() > max_remaining) {
+    std::vector<size_t> pair_indices(pathsvector.size() / 2);
+    std::iota(pair_indices.begin(), pair_indices.end(), 0);
+    std::vector<Clipper2Lib::Paths64> merged(pair_indices.size());
+    parallelizable_transform(pair_indices.begin(), pair_indices.end(), merged.begin(), [&](size_t i) {
+      Clipper2Lib::Clipper64 clipper;
+      clipper.PreserveCollinear(false);
+      clipper.AddSubject(pathsvector[2 * i]);
+      clipper.AddClip(pathsvector[2 * i + 1]);
+      Clipper2Lib::Paths64 result;
+      clipper.Execute(clipType, Clipper2Lib::FillRule::NonZero, result);
+      return result;
+    });
+    if (pathsvector.size() % 2 != 0) merged.push_back(std::move(pathsvector.back()));
+    pathsvector = std::move(merged);
+  }
+  return pathsvector;
+}
+
+// Splits sanitized paths, i.e. counter-clockwise outlines and clockwise holes, into
+// islands of one outline each, together with the holes directly inside it.
+// Holes are assigned to the smallest outline containing them.
+std::vector<Clipper2Lib::Paths64> splitIslands(const Clipper2Lib::Paths64& paths)
+{
+  std::vector<size_t> outlines;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    if (Clipper2Lib::IsPositive(paths[i])) outlines.push_back(i);
+  }
+  std::vector<Clipper2Lib::Rect64> bounds(outlines.size());
+  std::vector<double> areas(outlines.size());
+  std::vector<Clipper2Lib::Paths64> islands(outlines.size());
+  for (size_t o = 0; o < outlines.size(); ++o) {
+    bounds[o] = Clipper2Lib::GetBounds(paths[outlines[o]]);
+    areas[o] = Clipper2Lib::Area(paths[outlines[o]]);
+    islands[o].push_back(paths[outlines[o]]);
+  }
+
+  for (const auto& path : paths) {
+    if (path.empty() || Clipper2Lib::IsPositive(path)) continue;
+    const auto& pt = path.front();
+    size_t best = outlines.size();
+    for (size_t o = 0; o < outlines.size(); ++o) {
+      if (pt.x < bounds[o].left || pt.x > bounds[o].right || pt.y < bounds[o].top ||
+          pt.y > bounds[o].bottom) {
+        continue;
+      }
+      if ((best == outlines.size() || areas[o] < areas[best]) &&
+          Clipper2Lib::PointInPolygon(pt, paths[outlines[o]]) !=
+            Clipper2Lib::PointInPolygonResult::IsOutside) {
+        best = o;
+      }
+    }
+    // Not expected for sanitized input; give up on splitting
+    if (best == outlines.size()) return {};
+    islands[best].push_back(path);
+  }
+  return islands;
+}
+
 void SimplifyPolyTree(const Clipper2Lib::PolyPath64& polytree, double epsilon,
                       Clipper2Lib::PolyPath64& result)
 {
@@ -182,12 +253,13 @@ std::unique_ptr<Polygon2d> sanitize(const Polygon2d& poly)
    We could use a Paths structure, but we'd have to check the orientation of each
    path before adding it to the Polygon2d.
  */
-std::unique_ptr<Polygon2d> toPolygon2d(const Clipper2Lib::PolyTree64& polytree, int scale_bits)
+std::unique_ptr<Polygon2d> toPolygon2d(const Clipper2Lib::PolyTree64& polytree, int scale_bits,
+                                       Clipper2Lib::Paths64 *cleaned_paths)
 {
   auto result = std::make_unique<Polygon2d>();
   const double scale = std::ldexp(1.0, -scale_bits);
-  auto processChildren = [scale, &result](auto&& processChildren,
-                                          const Clipper2Lib::PolyPath64& node) -> void {
+  auto processChildren = [scale, &result, cleaned_paths](auto&& processChildren,
+                                                         const Clipper2Lib::PolyPath64& node) -> void {
     Outline2d outline;
     // When using offset, clipper can get the hole status wrong.
     // IsPositive() calculates the area of the polygon, and if it's negative, it's a hole.
@@ -202,6 +274,7 @@ std::unique_ptr<Polygon2d> toPolygon2d(const Clipper2Lib::PolyTree64& polytree,
         outline.vertices.emplace_back(scale * ip.x, scale * ip.y);
       }
       result->addOutline(outline);
+      if (cleaned_paths) cleaned_paths->push_back(cleaned_path);
     }
     for (const auto& child : node) {
       processChildren(processChildren, *child);
@@ -219,9 +292,24 @@ std::unique_ptr<Polygon2d> toPolygon2d(const Clipper2Lib::PolyTree64& polytree,
 
    May return an empty Polygon2d, but will not return nullptr.
  */
-std::unique_ptr<Polygon2d> apply(const std::vector<Clipper2Lib::Paths64>& pathsvector,
+std::unique_ptr<Polygon2d> apply(std::vector<Clipper2Lib::Paths64> pathsvector,
                                  Clipper2Lib::ClipType clipType, int scale_bits)
 {
+  // Reduce large operations in a balanced tree first; a difference subtracts the
+  // union of all but the first operand.
+  constexpr size_t max_operands = 2;
+  if (pathsvector.size() > max_operands) {
+    if (clipType == Clipper2Lib::ClipType::Union || clipType == Clipper2Lib::ClipType::Intersection) {
+      pathsvector = reduce(std::move(pathsvector), clipType, max_operands);
+    } else if (clipType == Clipper2Lib::ClipType::Difference) {
+      auto clips = reduce({std::make_move_iterator(pathsvector.begin() + 1),
+                           std::make_move_iterator(pathsvector.end())},
+                          Clipper2Lib::ClipType::Union, 1);
+      pathsvector.resize(1);
+      pathsvector.push_back(std::move(clips.front()));
+    }
+  }
+
   Clipper2Lib::Clipper64 clipper;
   clipper.PreserveCollinear(false);
 
@@ -268,20 +356,19 @@ std::unique_ptr<Polygon2d> apply(const std::vector<std::shared_ptr<const Polygon
 {
   const int scale_bits = scaleBitsFromPrecision();
 
-  std::vector<Clipper2Lib::Paths64> pathsvector;
-  for (const auto& polygon : polygons) {
-    if (polygon) {
-      auto polypaths = fromPolygon2d(*polygon, scale_bits);
-      if (!polygon->isSanitized()) {
-        polypaths = Clipper2Lib::PolyTreeToPaths64(*sanitize(polypaths));
-      }
-      pathsvector.push_back(std::move(polypaths));
-    } else {
-      // Insert empty object as this could be the positive object in a difference
-      pathsvector.emplace_back();
-    }
-  }
-  auto res = apply(pathsvector, clipType, scale_bits);
+  // Children are converted independently of each other, so do it in parallel
+  std::vector<Clipper2Lib::Paths64> pathsvector(polygons.size());
+  parallelizable_transform(polygons.begin(), polygons.end(), pathsvector.begin(),
+                           [scale_bits](const std::shared_ptr<const Polygon2d>& polygon) {
+                             // Keep empty objects as they could be the positive object in a difference
+                             if (!polygon) return Clipper2Lib::Paths64();
+                             auto polypaths = fromPolygon2d(*polygon, scale_bits);
+                             if (!polygon->isSanitized()) {
+                               polypaths = Clipper2Lib::PolyTreeToPaths64(*sanitize(polypaths));
+                             }
+                             return polypaths;
+                           });
+  auto res = apply(std::move(pathsvector), clipType, scale_bits);
   assert(res);
   return res;
 }
@@ -334,35 +421,104 @@ std::unique_ptr<Polygon2d> applyMinkowski(const std::vector<std::shared_ptr<cons
   return toPolygon2d(polytree, scale_bits);
 }
 
+std::unique_ptr<Clipper2Lib::PolyTree64> applyOffset(const Clipper2Lib::Paths64& paths, int scale_bits,
+                                                     double offset, Clipper2Lib::JoinType joinType,
+                                                     double miter_limit, double arc_tolerance)
+{
+  // Inputs with fewer points are offset in one go
+  constexpr size_t min_parallel_points = 1000;
+  const bool isMiter = joinType == Clipper2Lib::JoinType::Miter;
+  const bool isRound = joinType == Clipper2Lib::JoinType::Round;
+  const double delta = std::ldexp(offset, scale_bits);
+  auto makeOffset = [&]() {
+    return Clipper2Lib::ClipperOffset(isMiter ? miter_limit : 2.0,
+                                      isRound ? std::ldexp(arc_tolerance, scale_bits) : 1.0);
+  };
+
+  auto result = std::make_unique<Clipper2Lib::PolyTree64>();
+  size_t num_points = 0;
+  for (const auto& path : paths) num_points += path.size();
+  const auto islands =
+    num_points >= min_parallel_points ? splitIslands(paths) : std::vector<Clipper2Lib::Paths64>();
+  if (islands.size() < 2) {
+    auto co = makeOffset();
+    co.AddPaths(paths, joinType, Clipper2Lib::EndType::Polygon);
+    co.Execute(delta, *result);
+    return result;
+  }
+
+  // Islands are offset independently and merged, where growing islands may overlap
+  std::vector<Clipper2Lib::Paths64> offset_islands(islands.size());
+  parallelizable_transform(islands.begin(), islands.end(), offset_islands.begin(),
+                           [&](const Clipper2Lib::Paths64& island) {
+                             auto co = makeOffset();
+                             co.AddPaths(island, joinType, Clipper2Lib::EndType::Polygon);
+                             Clipper2Lib::Paths64 offset_island;
+                             co.Execute(delta, offset_island);
+                             return offset_island;
+                           });
+  offset_islands = reduce(std::move(offset_islands), Clipper2Lib::ClipType::Union, 2);
+  Clipper2Lib::Clipper64 clipper;
+  clipper.PreserveCollinear(false);
+  for (const auto& island : offset_islands) {
+    clipper.AddSubject(island);
+  }
+  clipper.Execute(Clipper2Lib::ClipType::Union, Clipper2Lib::FillRule::NonZero, *result);
+  return result;
+}
+
 std::unique_ptr<Polygon2d> applyOffset(const Polygon2d& poly, double offset,
                                        Clipper2Lib::JoinType joinType, double miter_limit,
                                        double arc_tolerance)
 {
-  const bool isMiter = joinType == Clipper2Lib::JoinType::Miter;
-  const bool isRound = joinType == Clipper2Lib::JoinType::Round;
   const int scale_bits = scaleBitsFromPrecision();
-  Clipper2Lib::ClipperOffset co(isMiter ? miter_limit : 2.0,
-                                isRound ? std::ldexp(arc_tolerance, scale_bits) : 1.0);
   auto p = ClipperUtils::fromPolygon2d(poly, scale_bits);
-  co.AddPaths(p, joinType, Clipper2Lib::EndType::Polygon);
-  Clipper2Lib::PolyTree64 result;
-  co.Execute(std::ldexp(offset, scale_bits), result);
-  return toPolygon2d(result, scale_bits);
+  auto result = applyOffset(p, scale_bits, offset, joinType, miter_limit, arc_tolerance);
+  return toPolygon2d(*result, scale_bits);
 }
 
 std::unique_ptr<Polygon2d> applyProjection(const std::vector<std::shared_ptr<const Polygon2d>>& polygons)
 {
+  // Number of projected faces unioned by a single Clipper run before the partial
+  // results are combined
+  constexpr size_t chunk_size = 1024;
   const int scale_bits = scaleBitsFromPrecision();
 
-  Clipper2Lib::Clipper64 sumclipper;
-  sumclipper.PreserveCollinear(false);
+  // fromPolygon2d() turns all projected faces counter-clockwise, so the faces can
+  // be unioned in any grouping; split large meshes into chunks to spread the work.
+  // Sanitized polygons carry holes as clockwise outlines and must stay in one piece.
+  struct Chunk {
+    const Polygon2d *poly;
+    size_t begin, end;
+  };
+  std::vector<Chunk> chunks;
   for (const auto& poly : polygons) {
-    Clipper2Lib::Paths64 result = ClipperUtils::fromPolygon2d(*poly, scale_bits);
+    if (!poly) continue;
+    const size_t num_outlines = poly->outlines().size();
+    const size_t step = poly->isSanitized() ? num_outlines : chunk_size;
+    for (size_t begin = 0; begin < num_outlines; begin += step) {
+      chunks.push_back({poly.get(), begin, std::min(begin + step, num_outlines)});
+    }
+  }
+
+  std::vector<Clipper2Lib::Paths64> pathsvector(chunks.size());
+  parallelizable_transform(chunks.begin(), chunks.end(), pathsvector.begin(), [&](const Chunk& chunk) {
+    Polygon2d part;
+    part.setSanitized(chunk.poly->isSanitized());
+    for (size_t i = chunk.begin; i < chunk.end; ++i) {
+      part.addOutline(chunk.poly->outlines()[i]);
+    }
     // Using NonZero ensures that we don't create holes from polygons sharing
     // edges since we're unioning a mesh
-    result = ClipperUtils::process(result, Clipper2Lib::ClipType::Union, Clipper2Lib::FillRule::NonZero);
-    // Add correctly winded polygons to the main clipper
-    sumclipper.AddSubject(result);
+    return ClipperUtils::process(ClipperUtils::fromPolygon2d(part, scale_bits),
+                                 Clipper2Lib::ClipType::Union, Clipper2Lib::FillRule::NonZero);
+  });
+  pathsvector = reduce(std::move(pathsvector), Clipper2Lib::ClipType::Union, 2);
+
+  Clipper2Lib::Clipper64 sumclipper;
+  sumclipper.PreserveCollinear(false);
+  for (const auto& paths : pathsvector) {
+    sumclipper.AddSubject(paths);
   }
 
   Clipper2Lib::PolyTree64 sumresult;
@@ -18,8 +18,14 @@ std::unique_ptr<Clipper2Lib::PolyTree64> sanitize(const Clipper2Lib::Paths64& pa
 std::unique_ptr<Polygon2d> sanitize(const Polygon2d& poly);
 
 Clipper2Lib::Paths64 fromPolygon2d(const Polygon2d& poly, int scale_bits);
-std::unique_ptr<Polygon2d> toPolygon2d(const Clipper2Lib::PolyTree64& poly, int scale_bits);
-
+// If given, cleaned_paths receives the paths of the resulting outlines in fixed point,
+// as fromPolygon2d() would return them for the result.
+std::unique_ptr<Polygon2d> toPolygon2d(const Clipper2Lib::PolyTree64& poly, int scale_bits,
+                                       Clipper2Lib::Paths64 *cleaned_paths = nullptr);
+
+std::unique_ptr<Clipper2Lib::PolyTree64> applyOffset(const Clipper2Lib::Paths64& paths, int scale_bits,
+                                                     double offset, Clipper2Lib::JoinType joinType,
+                                                     double miter_limit, double arc_tolerance);
 std::unique_ptr<Polygon2d> applyOffset(const Polygon2d& poly, double offset,
                                        Clipper2Lib::JoinType joinType, double miter_limit,
                                        double arc_tolerance);
@@ -2,8 +2,11 @@
 
 #include <cstddef>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 
+#include "MemoryBudget.h"
 #include "geometry/Geometry.h"
 #include "utils/printutils.h"
 
@@ -13,18 +16,89 @@
 
 GeometryCache *GeometryCache::inst = nullptr;
 
-std::shared_ptr<const Geometry> GeometryCache::get(const std::string& id) const
+GeometryCache::GeometryCache(size_t memorylimit) : cache(memorylimit)
+{
+  MemoryBudget::instance()->registerClient(this);
+}
+
+GeometryCache::~GeometryCache()
+{
+  MemoryBudget::instance()->unregisterClient(this);
+}
+
+bool GeometryCache::contains(const std::string& id) const
 {
-  const auto& geom = this->cache[id]->geom;
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return this->cache.contains(id);
+}
+
+bool GeometryCache::find(const std::string& id, std::shared_ptr<const Geometry>& geom) const
+{
+  {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    const auto entry = this->cache[id];
+    if (!entry) return false;
+    geom = entry->geom;
+  }
 #ifdef DEBUG
   PRINTDB("Geometry Cache hit: %s (%d bytes)", id.substr(0, 40) % (geom ? geom->memsize() : 0));
 #endif
+  return true;
+}
+
+std::shared_ptr<const Geometry> GeometryCache::get(const std::string& id) const
+{
+  std::shared_ptr<const Geometry> geom;
+  find(id, geom);
   return geom;
 }
 
-bool GeometryCache::insert(const std::string& id, const std::shared_ptr<const Geometry>& geom)
+std::string GeometryCache::derivedKey(const std::string& base, const std::string& suffix)
+{
+  return base + '\0' + suffix;
+}
+
+std::string GeometryCache::convertedKey(const std::string& id, RenderBackend3D backend)
+{
+  return derivedKey(id, renderBackend3DToString(backend));
+}
+
+std::shared_ptr<const Geometry> GeometryCache::getConverted(const std::string& id,
+                                                            RenderBackend3D backend) const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  const auto entry = this->cache[convertedKey(id, backend)];
+  return entry ? entry->geom : nullptr;
+}
+
+bool GeometryCache::insertConverted(const std::string& id, RenderBackend3D backend,
+                                    const std::shared_ptr<const Geometry>& geom, double computeTime)
+{
+  bool inserted;
+  {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    inserted = this->cache.insert(convertedKey(id, backend), new cache_entry(geom),
+                                  geom ? geom->memsize() : 0, computeTime);
+  }
+  // The budget may evict from this cache, so it has to be unlocked
+  MemoryBudget::instance()->enforce();
+#ifdef DEBUG
+  LOG("Geometry Cache %1$s: %2$s as %3$s (%4$d bytes)", inserted ? "inserted" : "insert failed",
+      id.substr(0, 40), renderBackend3DToString(backend), geom ? geom->memsize() : 0);
+#endif
+  return inserted;
+}
+
+bool GeometryCache::insert(const std::string& id, const std::shared_ptr<const Geometry>& geom,
+                           double computeTime)
 {
-  auto inserted = this->cache.insert(id, new cache_entry(geom), geom ? geom->memsize() : 0);
+  bool inserted;
+  {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    inserted = this->cache.insert(id, new cache_entry(geom), geom ? geom->memsize() : 0, computeTime);
+  }
+  // The budget may evict from this cache, so it has to be unlocked
+  MemoryBudget::instance()->enforce();
 #if defined(ENABLE_CGAL) && defined(DEBUG)
   assert(!dynamic_cast<const CGALNefGeometry *>(geom.get()));
   LOG("Geometry Cache %1$s: %2$s (%3$d bytes)", inserted ? "inserted" : "insert failed",
@@ -35,28 +109,84 @@ bool GeometryCache::insert(const std::string& id, const std::shared_ptr<const Ge
 
 size_t GeometryCache::size() const
 {
+  const std::lock_guard<std::mutex> lock(this->mutex);
   return cache.size();
 }
 
 size_t GeometryCache::totalCost() const
 {
+  const std::lock_guard<std::mutex> lock(this->mutex);
   return cache.totalCost();
 }
 
+size_t GeometryCache::hits() const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return cache.hits();
+}
+
+size_t GeometryCache::misses() const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return cache.misses();
+}
+
+size_t GeometryCache::evictions() const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return cache.evictions();
+}
+
+double GeometryCache::computeTime() const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return cache.computeTime();
+}
+
 size_t GeometryCache::maxSizeMB() const
 {
+  const std::lock_guard<std::mutex> lock(this->mutex);
   return this->cache.maxCost() / (1024ul * 1024ul);
 }
 
 void GeometryCache::setMaxSizeMB(size_t limit)
 {
+  const std::lock_guard<std::mutex> lock(this->mutex);
   this->cache.setMaxCost(limit * 1024ul * 1024ul);
 }
 
+void GeometryCache::clear()
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  cache.clear();
+}
+
+size_t GeometryCache::memoryUsage() const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return cache.totalCost();
+}
+
+std::optional<double> GeometryCache::evictionPriority() const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return cache.nextEvictionPriority();
+}
+
+void GeometryCache::evictOne()
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  cache.evictNext();
+}
+
 void GeometryCache::print()
 {
+  const std::lock_guard<std::mutex> lock(this->mutex);
   LOG("Geometries in cache: %1$d", this->cache.size());
   LOG("Geometry cache size in bytes: %1$d", this->cache.totalCost());
+  LOG("Geometry cache hits: %1$d, misses: %2$d", this->cache.hits(), this->cache.misses());
+  LOG("Geometry cache evictions: %1$d", this->cache.evictions());
+  LOG("Geometry cache compute time: %1$.3f s", this->cache.computeTime());
 }
 
 GeometryCache::cache_entry::cache_entry(const std::shared_ptr<const Geometry>& geom) : geom(geom)
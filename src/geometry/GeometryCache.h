@@ -2,15 +2,20 @@
 
 #include <cstddef>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 
 #include "Cache.h"
+#include "MemoryBudget.h"
 #include "geometry/Geometry.h"
+#include "glview/RenderSettings.h"
 
-class GeometryCache
+class GeometryCache : public MemoryBudget::Client
 {
 public:
-  GeometryCache(size_t memorylimit = 100ul * 1024ul * 1024ul) : cache(memorylimit) {}
+  GeometryCache(size_t memorylimit = 100ul * 1024ul * 1024ul);
+  ~GeometryCache() override;
 
   static GeometryCache *instance()
   {
@@ -18,18 +23,42 @@ public:
     return inst;
   }
 
-  bool contains(const std::string& id) const { return this->cache.contains(id); }
+  bool contains(const std::string& id) const;
+  // Looks id up and counts a hit or miss. The cached geometry may be nullptr.
+  bool find(const std::string& id, std::shared_ptr<const Geometry>& geom) const;
   std::shared_ptr<const class Geometry> get(const std::string& id) const;
-  bool insert(const std::string& id, const std::shared_ptr<const Geometry>& geom);
+  // computeTime is the number of seconds it took to evaluate geom, used by the eviction policy
+  bool insert(const std::string& id, const std::shared_ptr<const Geometry>& geom,
+              double computeTime = 0);
+  // The geometry cached for id, converted to the representation used by the given 3D backend
+  // (ManifoldGeometry or CGALNefGeometry). Stored next to the original geometry with its own cost,
+  // so it can be evicted independently.
+  std::shared_ptr<const Geometry> getConverted(const std::string& id, RenderBackend3D backend) const;
+  bool insertConverted(const std::string& id, RenderBackend3D backend,
+                       const std::shared_ptr<const Geometry>& geom, double computeTime = 0);
   size_t size() const;
   size_t totalCost() const;
+  size_t hits() const;
+  size_t misses() const;
+  size_t evictions() const;
+  // Seconds it took to compute all cached geometries
+  double computeTime() const;
   size_t maxSizeMB() const;
   void setMaxSizeMB(size_t limit);
-  void clear() { cache.clear(); }
+  void clear();
   void print();
 
+  // Key of an entry derived from base, like a conversion of the geometry cached for a node.
+  // Node ids never contain a NUL character, so joining with one can't collide with the key of a node.
+  static std::string derivedKey(const std::string& base, const std::string& suffix);
+
+  [[nodiscard]] size_t memoryUsage() const override;
+  [[nodiscard]] std::optional<double> evictionPriority() const override;
+  void evictOne() override;
+
 private:
   static GeometryCache *inst;
+  static std::string convertedKey(const std::string& id, RenderBackend3D backend);
 
   struct cache_entry {
     std::shared_ptr<const class Geometry> geom;
@@ -37,5 +66,7 @@ private:
     cache_entry(const std::shared_ptr<const Geometry>& geom);
   };
 
+  // The cache is used from the worker threads, and evicted from by the MemoryBudget on any thread
+  mutable std::mutex mutex;
   Cache<std::string, cache_entry> cache;
 };
@@ -1,14 +1,22 @@
 #include "geometry/GeometryEvaluator.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cmath>
+#include <cstddef>
 #include <iterator>
 #include <list>
+#include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
 #include "Feature.h"
+#include "RenderStatistic.h"
 #include "core/BaseVisitable.h"
 #include "core/CgalAdvNode.h"
 #include "core/ColorNode.h"
@@ -22,6 +30,7 @@
 #include "core/RoofNode.h"
 #include "core/RotateExtrudeNode.h"
 #include "core/State.h"
+#include "core/SweepNode.h"
 #include "core/TextNode.h"
 #include "core/TransformNode.h"
 #include "core/Tree.h"
@@ -41,9 +50,11 @@
 #include "geometry/roof_ss.h"
 #include "geometry/roof_vd.h"
 #include "geometry/rotate_extrude.h"
+#include "geometry/sweep.h"
 #include "glview/RenderSettings.h"
 #include "utils/calc.h"
 #include "utils/degree_trig.h"
+#include "utils/parallel.h"
 #include "utils/printutils.h"
 #ifdef ENABLE_CGAL
 #include <CGAL/Point_2.h>
@@ -62,10 +73,36 @@ class Geometry;
 class Polygon2d;
 class Tree;
 
+namespace {
+
+// Indexed by OpenSCADOperator
+std::array<std::atomic<size_t>, static_cast<size_t>(OpenSCADOperator::RESIZE) + 1> operation_counts{};
+
+void countOperation(OpenSCADOperator op)
+{
+  ++operation_counts[static_cast<size_t>(op)];
+}
+
+}  // namespace
+
 GeometryEvaluator::GeometryEvaluator(const Tree& tree) : tree(tree)
 {
 }
 
+std::map<OpenSCADOperator, size_t> GeometryEvaluator::operationCounts()
+{
+  std::map<OpenSCADOperator, size_t> counts;
+  for (size_t i = 0; i < operation_counts.size(); ++i) {
+    if (operation_counts[i] > 0) counts[static_cast<OpenSCADOperator>(i)] = operation_counts[i];
+  }
+  return counts;
+}
+
+void GeometryEvaluator::resetOperationCounts()
+{
+  for (auto& count : operation_counts) count = 0;
+}
+
 /*!
    Set allownef to false to force the result to _not_ be a Nef polyhedron
 
@@ -78,16 +115,19 @@ GeometryEvaluator::GeometryEvaluator(const Tree& tree) : tree(tree)
 std::shared_ptr<const Geometry> GeometryEvaluator::evaluateGeometry(const AbstractNode& node,
                                                                     bool allownef)
 {
-  auto result = smartCacheGet(node, allownef);
-  if (!result) {
+  std::shared_ptr<const Geometry> result;
+  // A miss is counted when traverse() visits the node
+  if (!isSmartCached(node) || !smartCacheGet(node, allownef, result) || !result) {
     // If not found in any caches, we need to evaluate the geometry
     // traverse() will set this->root to a geometry, which can be any geometry
     // (including GeometryList if the lazyunions feature is enabled)
+    this->lastresult = std::chrono::steady_clock::now();
     this->traverse(node);
     result = this->root;
 
     // Insert the raw result into the cache.
     smartCacheInsert(node, result);
+    this->computetimes.clear();
   }
 
   // Convert engine-specific 3D geometry to PolySet if needed
@@ -150,6 +190,7 @@ GeometryEvaluator::ResultObject GeometryEvaluator::applyToChildren3D(const Abstr
   if (children.empty()) return {};
 
   if (op == OpenSCADOperator::HULL) {
+    countOperation(op);
     return applyHull3D(children);
   } else if (op == OpenSCADOperator::FILL) {
     for (const auto& item : children) {
@@ -160,6 +201,7 @@ GeometryEvaluator::ResultObject GeometryEvaluator::applyToChildren3D(const Abstr
 
   // Only one child -> this is a noop
   if (children.size() == 1) return ResultObject::constResult(children.front().second);
+  countOperation(op);
 
   switch (op) {
   case OpenSCADOperator::MINKOWSKI: {
@@ -179,6 +221,7 @@ GeometryEvaluator::ResultObject GeometryEvaluator::applyToChildren3D(const Abstr
     }
     if (actualchildren.empty()) return {};
     if (actualchildren.size() == 1) return ResultObject::constResult(actualchildren.front().second);
+    actualchildren = convertChildren3D(actualchildren);
 #ifdef ENABLE_MANIFOLD
     if (RenderSettings::inst()->backend3D == RenderBackend3D::ManifoldBackend) {
       return ResultObject::mutableResult(ManifoldUtils::applyOperator3DManifold(actualchildren, op));
@@ -193,6 +236,9 @@ GeometryEvaluator::ResultObject GeometryEvaluator::applyToChildren3D(const Abstr
     break;
   }
   default: {
+    if (op == OpenSCADOperator::INTERSECTION || op == OpenSCADOperator::DIFFERENCE) {
+      children = convertChildren3D(children);
+    }
 #ifdef ENABLE_MANIFOLD
     if (RenderSettings::inst()->backend3D == RenderBackend3D::ManifoldBackend) {
       return ResultObject::mutableResult(ManifoldUtils::applyOperator3DManifold(children, op));
@@ -344,10 +390,15 @@ void GeometryEvaluator::smartCacheInsert(const AbstractNode& node,
                                          const std::shared_ptr<const Geometry>& geom)
 {
   const std::string& key = this->tree.getIdString(node);
+  double computetime = 0;
+  if (const auto it = this->computetimes.find(node.index()); it != this->computetimes.end()) {
+    computetime = it->second;
+    this->computetimes.erase(it);
+  }
 
   if (CGALCache::acceptsGeometry(geom)) {
     if (!CGALCache::instance()->contains(key)) {
-      CGALCache::instance()->insert(key, geom);
+      CGALCache::instance()->insert(key, geom, computetime);
     }
   } else if (!GeometryCache::instance()->contains(key)) {
     // FIXME: Sanity-check Polygon2d as well?
@@ -356,7 +407,7 @@ void GeometryEvaluator::smartCacheInsert(const AbstractNode& node,
     // }
 
     // Perhaps add acceptsGeometry() to GeometryCache as well?
-    if (!GeometryCache::instance()->insert(key, geom)) {
+    if (!GeometryCache::instance()->insert(key, geom, computetime)) {
       LOG(message_group::Warning, "GeometryEvaluator: Node didn't fit into cache.");
     }
   }
@@ -368,15 +419,21 @@ bool GeometryEvaluator::isSmartCached(const AbstractNode& node)
   return GeometryCache::instance()->contains(key) || CGALCache::instance()->contains(key);
 }
 
-std::shared_ptr<const Geometry> GeometryEvaluator::smartCacheGet(const AbstractNode& node,
-                                                                 bool preferNef)
+/*!
+   Looks up the geometry of node, preferring the CGAL cache if preferNef is set.
+   Returns false if neither cache has it. Unlike isSmartCached(), this counts a hit in the
+   cache it was found in, or a miss in the GeometryCache, so it should be called once for
+   each node that is evaluated.
+ */
+bool GeometryEvaluator::smartCacheGet(const AbstractNode& node, bool preferNef,
+                                      std::shared_ptr<const Geometry>& geom)
 {
   const std::string& key = this->tree.getIdString(node);
-  const bool hasgeom = GeometryCache::instance()->contains(key);
-  const bool hascgal = CGALCache::instance()->contains(key);
-  if (hascgal && (preferNef || !hasgeom)) return CGALCache::instance()->get(key);
-  if (hasgeom) return GeometryCache::instance()->get(key);
-  return {};
+  if (CGALCache::instance()->contains(key) &&
+      (preferNef || !GeometryCache::instance()->contains(key))) {
+    return CGALCache::instance()->find(key, geom);
+  }
+  return GeometryCache::instance()->find(key, geom);
 }
 
 /*!
@@ -410,6 +467,46 @@ Geometry::Geometries GeometryEvaluator::collectChildren3D(const AbstractNode& no
   return children;
 }
 
+/*!
+   Returns the given children with PolySets replaced by the representation used by the
+   3D backend for boolean operations.
+
+   Conversions are stored in the GeometryCache next to the child's own geometry, so a child
+   shared by many parents is converted only once.
+ */
+Geometry::Geometries GeometryEvaluator::convertChildren3D(const Geometry::Geometries& children)
+{
+  const auto backend = RenderSettings::inst()->backend3D;
+  Geometry::Geometries converted;
+  for (const auto& [chnode, chgeom] : children) {
+    const auto ps = std::dynamic_pointer_cast<const PolySet>(chgeom);
+    if (!ps || ps->isEmpty()) {
+      converted.emplace_back(chnode, chgeom);
+      continue;
+    }
+    const std::string& key = this->tree.getIdString(*chnode);
+    auto geom = GeometryCache::instance()->getConverted(key, backend);
+    if (!geom) {
+      const RenderStatistic::Phase phase(RenderStatistic::BACKEND_CONVERSION);
+      const auto start = std::chrono::steady_clock::now();
+#ifdef ENABLE_MANIFOLD
+      if (backend == RenderBackend3D::ManifoldBackend) {
+        geom = ManifoldUtils::createManifoldFromGeometry(chgeom);
+      } else
+#endif
+      {
+#ifdef ENABLE_CGAL
+        geom = CGALUtils::getNefPolyhedronFromGeometry(chgeom);
+#endif
+      }
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      if (geom) GeometryCache::instance()->insertConverted(key, backend, geom, elapsed.count());
+    }
+    converted.emplace_back(chnode, geom ? geom : chgeom);
+  }
+  return converted;
+}
+
 /*!
 
  */
@@ -417,6 +514,10 @@ std::unique_ptr<Polygon2d> GeometryEvaluator::applyToChildren2D(const AbstractNo
                                                                 OpenSCADOperator op)
 {
   node.progress_report();
+  if (op == OpenSCADOperator::MINKOWSKI || op == OpenSCADOperator::HULL ||
+      op == OpenSCADOperator::FILL) {
+    countOperation(op);
+  }
   if (op == OpenSCADOperator::MINKOWSKI) {
     return applyMinkowski2D(node);
   } else if (op == OpenSCADOperator::HULL) {
@@ -439,6 +540,7 @@ std::unique_ptr<Polygon2d> GeometryEvaluator::applyToChildren2D(const AbstractNo
     }
   }
 
+  countOperation(op);
   Clipper2Lib::ClipType clipType;
   switch (op) {
   case OpenSCADOperator::UNION:        clipType = Clipper2Lib::ClipType::Union; break;
@@ -465,6 +567,12 @@ std::unique_ptr<Polygon2d> GeometryEvaluator::applyToChildren2D(const AbstractNo
 void GeometryEvaluator::addToParent(const State& state, const AbstractNode& node,
                                     const std::shared_ptr<const Geometry>& geom)
 {
+  // All children were done at the time of the previous result, so this is the time it
+  // took to compute this node itself
+  const auto now = std::chrono::steady_clock::now();
+  this->computetimes[node.index()] = std::chrono::duration<double>(now - this->lastresult).count();
+  this->lastresult = now;
+
   this->visitedchildren.erase(node.index());
   if (state.parent()) {
     this->visitedchildren[state.parent()->index()].push_back(
@@ -481,7 +589,7 @@ Response GeometryEvaluator::visit(State& state, const ColorNode& node)
   if (state.isPrefix() && isSmartCached(node)) return Response::PruneTraversal;
   if (state.isPostfix()) {
     std::shared_ptr<const Geometry> geom;
-    if (!isSmartCached(node)) {
+    if (!smartCacheGet(node, state.preferNef(), geom)) {
       // First union all children
       ResultObject res = applyToChildren(node, OpenSCADOperator::UNION);
       if ((geom = res.constptr())) {
@@ -489,8 +597,6 @@ Response GeometryEvaluator::visit(State& state, const ColorNode& node)
         if (mutableGeom) mutableGeom->setColor(node.color);
         geom = mutableGeom;
       }
-    } else {
-      geom = smartCacheGet(node, state.preferNef());
     }
     addToParent(state, node, geom);
     node.progress_report();
@@ -509,10 +615,8 @@ Response GeometryEvaluator::visit(State& state, const AbstractNode& node)
   }
   if (state.isPostfix()) {
     std::shared_ptr<const Geometry> geom;
-    if (!isSmartCached(node)) {
+    if (!smartCacheGet(node, state.preferNef(), geom)) {
       geom = applyToChildren(node, OpenSCADOperator::UNION).constptr();
-    } else {
-      geom = smartCacheGet(node, state.preferNef());
     }
     addToParent(state, node, geom);
     node.progress_report();
@@ -612,18 +716,40 @@ Response GeometryEvaluator::visit(State& state, const OffsetNode& node)
   if (state.isPrefix() && isSmartCached(node)) return Response::PruneTraversal;
   if (state.isPostfix()) {
     std::shared_ptr<const Geometry> geom;
-    if (!isSmartCached(node)) {
-      if (const auto polygon = applyToChildren2D(node, OpenSCADOperator::UNION)) {
+    if (!smartCacheGet(node, false, geom)) {
+      const int scale_bits = ClipperUtils::scaleBitsFromPrecision();
+      std::optional<Clipper2Lib::Paths64> paths;
+      // A single child which is an offset itself already handed over its result in fixed point
+      const auto& children = this->visitedchildren[node.index()];
+      if (children.size() == 1 && !children.front().first->modinst->isBackground()) {
+        auto it = this->offsetpaths.find(children.front().first->index());
+        if (it != this->offsetpaths.end()) {
+          collectChildren2D(node);  // for caching the child
+          paths = std::move(it->second);
+        }
+      }
+      for (const auto& item : children) this->offsetpaths.erase(item.first->index());
+      if (!paths) {
+        if (const auto polygon = applyToChildren2D(node, OpenSCADOperator::UNION)) {
+          paths = ClipperUtils::fromPolygon2d(*polygon, scale_bits);
+        }
+      }
+      if (paths) {
         // ClipperLib documentation: The formula for the number of steps in a full
         // circular arc is ... Pi / acos(1 - arc_tolerance / abs(delta))
         double n = node.discretizer.getCircularSegmentCount(std::abs(node.delta)).value_or(3);
         double arc_tolerance = std::abs(node.delta) * (1 - cos_degrees(180 / n));
-        geom = ClipperUtils::applyOffset(*polygon, node.delta, node.join_type, node.miter_limit,
-                                         arc_tolerance);
+        auto result = ClipperUtils::applyOffset(*paths, scale_bits, node.delta, node.join_type,
+                                                node.miter_limit, arc_tolerance);
+        if (std::dynamic_pointer_cast<const OffsetNode>(state.parent())) {
+          Clipper2Lib::Paths64 result_paths;
+          geom = ClipperUtils::toPolygon2d(*result, scale_bits, &result_paths);
+          this->offsetpaths[node.index()] = std::move(result_paths);
+        } else {
+          geom = ClipperUtils::toPolygon2d(*result, scale_bits);
+        }
         assert(geom);
       }
-    } else {
-      geom = smartCacheGet(node, false);
     }
     addToParent(state, node, geom);
     node.progress_report();
@@ -642,13 +768,11 @@ Response GeometryEvaluator::visit(State& state, const RenderNode& node)
   }
   if (state.isPostfix()) {
     std::shared_ptr<const Geometry> geom;
-    if (!isSmartCached(node)) {
+    if (!smartCacheGet(node, state.preferNef(), geom)) {
       ResultObject res = applyToChildren(node, OpenSCADOperator::UNION);
       auto mutableGeom = res.asMutableGeometry();
       if (mutableGeom) mutableGeom->setConvexity(node.convexity);
       geom = mutableGeom;
-    } else {
-      geom = smartCacheGet(node, state.preferNef());
     }
     node.progress_report();
     addToParent(state, node, geom);
@@ -666,7 +790,7 @@ Response GeometryEvaluator::visit(State& state, const LeafNode& node)
 {
   if (state.isPrefix()) {
     std::shared_ptr<const Geometry> geom;
-    if (!isSmartCached(node)) {
+    if (!smartCacheGet(node, state.preferNef(), geom)) {
       geom = node.createGeometry();
       assert(geom);
       if (const auto polygon = std::dynamic_pointer_cast<const Polygon2d>(geom)) {
@@ -676,8 +800,6 @@ Response GeometryEvaluator::visit(State& state, const LeafNode& node)
       } else if (const auto ps = std::dynamic_pointer_cast<const PolySet>(geom)) {
         //        assert(!ps->hasDegeneratePolygons());
       }
-    } else {
-      geom = smartCacheGet(node, state.preferNef());
     }
     addToParent(state, node, geom);
     node.progress_report();
@@ -689,11 +811,9 @@ Response GeometryEvaluator::visit(State& state, const TextNode& node)
 {
   if (state.isPrefix()) {
     std::shared_ptr<const Geometry> geom;
-    if (!isSmartCached(node)) {
+    if (!smartCacheGet(node, false, geom)) {
       auto polygonlist = node.createPolygonList();
       geom = ClipperUtils::apply(polygonlist, Clipper2Lib::ClipType::Union);
-    } else {
-      geom = GeometryCache::instance()->get(this->tree.getIdString(node));
     }
     addToParent(state, node, geom);
     node.progress_report();
@@ -715,10 +835,8 @@ Response GeometryEvaluator::visit(State& state, const CsgOpNode& node)
   }
   if (state.isPostfix()) {
     std::shared_ptr<const Geometry> geom;
-    if (!isSmartCached(node)) {
+    if (!smartCacheGet(node, state.preferNef(), geom)) {
       geom = applyToChildren(node, node.type).constptr();
-    } else {
-      geom = smartCacheGet(node, state.preferNef());
     }
     addToParent(state, node, geom);
     node.progress_report();
@@ -738,7 +856,7 @@ Response GeometryEvaluator::visit(State& state, const TransformNode& node)
   if (state.isPrefix() && isSmartCached(node)) return Response::PruneTraversal;
   if (state.isPostfix()) {
     std::shared_ptr<const Geometry> geom;
-    if (!isSmartCached(node)) {
+    if (!smartCacheGet(node, state.preferNef(), geom)) {
       if (matrix_contains_infinity(node.matrix) || matrix_contains_nan(node.matrix)) {
         // due to the way parse/eval works we can't currently distinguish between NaN and Inf
         LOG(message_group::Warning, node.modinst->location(), this->tree.getDocumentPath(),
@@ -770,8 +888,6 @@ Response GeometryEvaluator::visit(State& state, const TransformNode& node)
           }
         }
       }
-    } else {
-      geom = smartCacheGet(node, state.preferNef());
     }
     addToParent(state, node, geom);
     node.progress_report();
@@ -791,15 +907,38 @@ Response GeometryEvaluator::visit(State& state, const LinearExtrudeNode& node)
   if (state.isPrefix() && isSmartCached(node)) return Response::PruneTraversal;
   if (state.isPostfix()) {
     std::shared_ptr<const Geometry> geom;
-    if (!isSmartCached(node)) {
+    if (!smartCacheGet(node, false, geom)) {
       const std::shared_ptr<const Geometry> geometry = applyToChildren2D(node, OpenSCADOperator::UNION);
       if (geometry) {
         const auto polygons = std::dynamic_pointer_cast<const Polygon2d>(geometry);
         geom = extrudePolygon(node, *polygons);
         assert(geom);
       }
-    } else {
-      geom = smartCacheGet(node, false);
+    }
+    addToParent(state, node, geom);
+    node.progress_report();
+  }
+  return Response::ContinueTraversal;
+}
+
+/*!
+   input: List of 2D objects
+   output: 3D PolySet
+   operation:
+    o Union all children
+    o Sweep along path
+ */
+Response GeometryEvaluator::visit(State& state, const SweepNode& node)
+{
+  if (state.isPrefix() && isSmartCached(node)) return Response::PruneTraversal;
+  if (state.isPostfix()) {
+    std::shared_ptr<const Geometry> geom;
+    if (!smartCacheGet(node, false, geom)) {
+      const std::shared_ptr<const Polygon2d> geometry = applyToChildren2D(node, OpenSCADOperator::UNION);
+      if (geometry) {
+        geom = sweepPolygon(node, *geometry);
+        assert(geom);
+      }
     }
     addToParent(state, node, geom);
     node.progress_report();
@@ -819,13 +958,11 @@ Response GeometryEvaluator::visit(State& state, const RotateExtrudeNode& node)
   if (state.isPrefix() && isSmartCached(node)) return Response::PruneTraversal;
   if (state.isPostfix()) {
     std::shared_ptr<const Geometry> geom;
-    if (!isSmartCached(node)) {
+    if (!smartCacheGet(node, false, geom)) {
       const std::shared_ptr<const Polygon2d> geometry = applyToChildren2D(node, OpenSCADOperator::UNION);
       if (geometry) {
         geom = rotatePolygon(node, *geometry);
       }
-    } else {
-      geom = smartCacheGet(node, false);
     }
     addToParent(state, node, geom);
     node.progress_report();
@@ -842,66 +979,118 @@ Response GeometryEvaluator::visit(State& /*state*/, const AbstractPolyNode& /*no
   return Response::AbortTraversal;
 }
 
+/*!
+   The cross-section of a union is the union of the cross-sections, so rather than building
+   the 3D union of all children, slice each child crossing the z=0 plane and union the slices
+   in 2D. Children entirely above or below the plane are skipped based on their bounding box.
+ */
 std::shared_ptr<const Geometry> GeometryEvaluator::projectionCut(const ProjectionNode& node)
 {
-  std::shared_ptr<const Geometry> geom;
-  std::shared_ptr<const Geometry> newgeom = applyToChildren3D(node, OpenSCADOperator::UNION).constptr();
-  if (newgeom) {
+  Geometry::Geometries children;
+  bool has_children = false;
+  for (const auto& item : collectChildren3D(node)) {
+    if (!item.second || item.second->isEmpty()) continue;
+    has_children = true;
+    const BoundingBox bbox = item.second->getBoundingBox();
+    if (bbox.min().z() > 0 || bbox.max().z() < 0) continue;
+    children.push_back(item);
+  }
+  if (!has_children) return {};
+  if (children.empty()) return std::make_shared<Polygon2d>();
+  children = convertChildren3D(children);
+
+  std::vector<std::shared_ptr<const Polygon2d>> slices(children.size());
 #ifdef ENABLE_MANIFOLD
-    if (RenderSettings::inst()->backend3D == RenderBackend3D::ManifoldBackend) {
-      auto manifold = ManifoldUtils::createManifoldFromGeometry(newgeom);
-      if (manifold != nullptr) {
-        auto poly2d = manifold->slice();
-        return std::shared_ptr<const Polygon2d>(ClipperUtils::sanitize(poly2d));
-      }
+  if (RenderSettings::inst()->backend3D == RenderBackend3D::ManifoldBackend) {
+    std::vector<std::shared_ptr<const ManifoldGeometry>> manifolds;
+    for (const auto& item : children) {
+      manifolds.push_back(ManifoldUtils::createManifoldFromGeometry(item.second));
     }
-#endif
-#ifdef ENABLE_CGAL
-    auto Nptr = CGALUtils::getNefPolyhedronFromGeometry(newgeom);
-    if (Nptr && !Nptr->isEmpty()) {
-      auto poly = CGALUtils::project(*Nptr, node.cut_mode);
-      if (poly) {
-        poly->setConvexity(node.convexity);
-        geom = std::move(poly);
-      }
+    // Slicing doesn't modify the manifolds, so the children can be sliced concurrently
+    parallelizable_transform(manifolds.begin(), manifolds.end(), slices.begin(),
+                             [](const std::shared_ptr<const ManifoldGeometry>& manifold) {
+                               return manifold ? std::make_shared<const Polygon2d>(manifold->slice())
+                                               : nullptr;
+                             });
+    if (slices.size() == 1) {
+      return slices.front() ? std::shared_ptr<const Polygon2d>(ClipperUtils::sanitize(*slices.front()))
+                            : std::make_shared<Polygon2d>();
     }
+    return std::shared_ptr<const Polygon2d>(ClipperUtils::apply(slices, Clipper2Lib::ClipType::Union));
+  }
 #endif
+#ifdef ENABLE_CGAL
+  auto cut = [&node](const Geometry::GeometryItem& item) -> std::shared_ptr<Polygon2d> {
+    auto Nptr = CGALUtils::getNefPolyhedronFromGeometry(item.second);
+    if (!Nptr || Nptr->isEmpty()) return nullptr;
+    return CGALUtils::project(*Nptr, node.cut_mode);
+  };
+  std::shared_ptr<Polygon2d> poly;
+  if (children.size() == 1) {
+    poly = cut(children.front());
+  } else {
+    // Nef polyhedra share reference counted exact numbers, so these are sliced sequentially
+    std::transform(children.begin(), children.end(), slices.begin(), cut);
+    poly = ClipperUtils::apply(slices, Clipper2Lib::ClipType::Union);
   }
-  return geom;
+  if (poly) poly->setConvexity(node.convexity);
+  return poly;
+#else
+  return {};
+#endif
 }
 
+/*!
+   The shadow of a union is the union of the shadows, so each child is projected
+   on its own, concurrently, and the projections are unioned in 2D.
+ */
 std::shared_ptr<const Geometry> GeometryEvaluator::projectionNoCut(const ProjectionNode& node)
 {
 #ifdef ENABLE_MANIFOLD
   if (RenderSettings::inst()->backend3D == RenderBackend3D::ManifoldBackend) {
-    const std::shared_ptr<const Geometry> newgeom =
-      applyToChildren3D(node, OpenSCADOperator::UNION).constptr();
-    if (newgeom) {
-      auto manifold = ManifoldUtils::createManifoldFromGeometry(newgeom);
-      if (manifold != nullptr) {
-        auto poly2d = manifold->project();
-        return std::shared_ptr<const Polygon2d>(ClipperUtils::sanitize(poly2d));
-      }
-    } else {
-      return std::make_shared<Polygon2d>();
+    Geometry::Geometries children;
+    for (const auto& item : collectChildren3D(node)) {
+      if (item.second && !item.second->isEmpty()) children.push_back(item);
+    }
+    if (children.empty()) return std::make_shared<Polygon2d>();
+    children = convertChildren3D(children);
+
+    std::vector<std::shared_ptr<const ManifoldGeometry>> manifolds;
+    for (const auto& item : children) {
+      manifolds.push_back(ManifoldUtils::createManifoldFromGeometry(item.second));
     }
+    std::vector<std::shared_ptr<const Polygon2d>> projections(manifolds.size());
+    parallelizable_transform(manifolds.begin(), manifolds.end(), projections.begin(),
+                             [](const std::shared_ptr<const ManifoldGeometry>& manifold) {
+                               return manifold ? std::shared_ptr<const Polygon2d>(
+                                                   ClipperUtils::sanitize(manifold->project()))
+                                               : nullptr;
+                             });
+    if (projections.size() == 1) {
+      return projections.front() ? projections.front() : std::make_shared<Polygon2d>();
+    }
+    return std::shared_ptr<const Polygon2d>(ClipperUtils::applyProjection(projections));
   }
 #endif
 
-  std::vector<std::shared_ptr<const Polygon2d>> tmp_geom;
+  // Converting to PolySet may involve CGAL, so only the projection itself runs in parallel
+  std::vector<std::shared_ptr<const PolySet>> polysets;
   for (const auto& [chnode, chgeom] : this->visitedchildren[node.index()]) {
     if (chnode->modinst->isBackground()) continue;
-
-    // Clipper version of Geometry projection
-    // Clipper doesn't handle meshes very well.
-    // It's better in V6 but not quite there. FIXME: stand-alone example.
-    // project chgeom -> polygon2d
     if (auto chPS = PolySetUtils::getGeometryAsPolySet(chgeom)) {
-      if (auto poly = PolySetUtils::project(*chPS)) {
-        tmp_geom.push_back(std::shared_ptr(std::move(poly)));
-      }
+      polysets.push_back(std::move(chPS));
     }
   }
+
+  // Clipper version of Geometry projection
+  // Clipper doesn't handle meshes very well.
+  // It's better in V6 but not quite there. FIXME: stand-alone example.
+  // project chgeom -> polygon2d
+  std::vector<std::shared_ptr<const Polygon2d>> tmp_geom(polysets.size());
+  parallelizable_transform(polysets.begin(), polysets.end(), tmp_geom.begin(),
+                           [](const std::shared_ptr<const PolySet>& ps) {
+                             return std::shared_ptr<const Polygon2d>(PolySetUtils::project(*ps));
+                           });
   auto projected = ClipperUtils::applyProjection(tmp_geom);
   return std::shared_ptr(std::move(projected));
 }
@@ -918,9 +1107,7 @@ Response GeometryEvaluator::visit(State& state, const ProjectionNode& node)
   if (state.isPrefix() && isSmartCached(node)) return Response::PruneTraversal;
   if (state.isPostfix()) {
     std::shared_ptr<const Geometry> geom;
-    if (isSmartCached(node)) {
-      geom = smartCacheGet(node, false);
-    } else {
+    if (!smartCacheGet(node, false, geom)) {
       if (node.cut_mode) {
         geom = projectionCut(node);
       } else {
@@ -944,7 +1131,7 @@ Response GeometryEvaluator::visit(State& state, const CgalAdvNode& node)
   if (state.isPrefix() && isSmartCached(node)) return Response::PruneTraversal;
   if (state.isPostfix()) {
     std::shared_ptr<const Geometry> geom;
-    if (!isSmartCached(node)) {
+    if (!smartCacheGet(node, state.preferNef(), geom)) {
       switch (node.type) {
       case CgalAdvType::MINKOWSKI: {
         ResultObject res = applyToChildren(node, OpenSCADOperator::MINKOWSKI);
@@ -977,8 +1164,6 @@ Response GeometryEvaluator::visit(State& state, const CgalAdvNode& node)
       }
       default: assert(false && "not implemented");
       }
-    } else {
-      geom = smartCacheGet(node, state.preferNef());
     }
     addToParent(state, node, geom);
     node.progress_report();
@@ -994,10 +1179,8 @@ Response GeometryEvaluator::visit(State& state, const AbstractIntersectionNode&
   }
   if (state.isPostfix()) {
     std::shared_ptr<const Geometry> geom;
-    if (!isSmartCached(node)) {
+    if (!smartCacheGet(node, state.preferNef(), geom)) {
       geom = applyToChildren(node, OpenSCADOperator::INTERSECTION).constptr();
-    } else {
-      geom = smartCacheGet(node, state.preferNef());
     }
     addToParent(state, node, geom);
     node.progress_report();
@@ -1028,7 +1211,7 @@ Response GeometryEvaluator::visit(State& state, const RoofNode& node)
   if (state.isPrefix() && isSmartCached(node)) return Response::PruneTraversal;
   if (state.isPostfix()) {
     std::shared_ptr<const Geometry> geom;
-    if (!isSmartCached(node)) {
+    if (!smartCacheGet(node, false, geom)) {
       const auto polygon2d = applyToChildren2D(node, OpenSCADOperator::UNION);
       if (polygon2d) {
         std::unique_ptr<Geometry> roof;
@@ -1042,8 +1225,6 @@ Response GeometryEvaluator::visit(State& state, const RoofNode& node)
         assert(roof);
         geom = std::move(roof);
       }
-    } else {
-      geom = smartCacheGet(node, false);
     }
     addToParent(state, node, geom);
   }
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <cassert>
+#include <chrono>
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "clipper2/clipper.h"
 #include "core/BaseVisitable.h"
 #include "core/NodeVisitor.h"
 #include "core/enums.h"
@@ -33,6 +36,7 @@ public:
   Response visit(State& state, const AbstractPolyNode& node) override;
   Response visit(State& state, const LinearExtrudeNode& node) override;
   Response visit(State& state, const RotateExtrudeNode& node) override;
+  Response visit(State& state, const SweepNode& node) override;
 #if defined(ENABLE_EXPERIMENTAL) && defined(ENABLE_CGAL)
   Response visit(State& state, const RoofNode& node) override;
 #endif
@@ -50,6 +54,11 @@ public:
 
   [[nodiscard]] const Tree& getTree() const { return this->tree; }
 
+  // Number of operations applied to the children of nodes since the last reset, by operator,
+  // for the render summary
+  static std::map<OpenSCADOperator, size_t> operationCounts();
+  static void resetOperationCounts();
+
 private:
   class ResultObject
   {
@@ -105,11 +114,12 @@ private:
   };
 
   void smartCacheInsert(const AbstractNode& node, const std::shared_ptr<const Geometry>& geom);
-  std::shared_ptr<const Geometry> smartCacheGet(const AbstractNode& node, bool preferNef);
+  bool smartCacheGet(const AbstractNode& node, bool preferNef, std::shared_ptr<const Geometry>& geom);
   bool isSmartCached(const AbstractNode& node);
   bool isValidDim(const Geometry::GeometryItem& item, unsigned int& dim) const;
   std::vector<std::shared_ptr<const Polygon2d>> collectChildren2D(const AbstractNode& node);
   Geometry::Geometries collectChildren3D(const AbstractNode& node);
+  Geometry::Geometries convertChildren3D(const Geometry::Geometries& children);
   std::unique_ptr<Polygon2d> applyMinkowski2D(const AbstractNode& node);
   std::unique_ptr<Polygon2d> applyHull2D(const AbstractNode& node);
   ResultObject applyHull3D(const Geometry::Geometries& children);
@@ -127,6 +137,12 @@ private:
   Response lazyEvaluateRootNode(State& state, const AbstractNode& node);
 
   std::map<int, Geometry::Geometries> visitedchildren;
+  // Seconds it took to compute each node's geometry, by node index, until it's cached
+  std::map<int, double> computetimes;
+  std::chrono::steady_clock::time_point lastresult;
+  // Fixed point result of offset nodes whose parent is another offset, by node index,
+  // handed over so chained offsets don't convert back and forth between each step
+  std::map<int, Clipper2Lib::Paths64> offsetpaths;
   const Tree& tree;
   std::shared_ptr<const Geometry> root;
 
@@ -555,3 +555,74 @@ std::shared_ptr<const Geometry> GeometryUtils::getBackendSpecificGeometry(
 #endif
   return nullptr;
 }
+
+/*!
+   Removes duplicate points and points which cannot be vertices of the convex hull of
+   all points, to cut down the input to a hull algorithm (Akl-Toussaint heuristic).
+
+   The points extreme along a fixed set of directions span a polytope inside the hull;
+   points strictly inside that polytope, by a margin relative to the size of the point
+   cloud, are discarded. If the extreme points are all coplanar nothing is discarded.
+ */
+void GeometryUtils::discardInteriorHullPoints(std::vector<Vector3d>& points)
+{
+  std::sort(points.begin(), points.end(), [](const Vector3d& a, const Vector3d& b) {
+    return std::lexicographical_compare(a.data(), a.data() + 3, b.data(), b.data() + 3);
+  });
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+  if (points.size() < 16) return;
+
+  // Axis and diagonal directions
+  std::vector<Vector3d> extremes;
+  for (int x = -1; x <= 1; ++x) {
+    for (int y = -1; y <= 1; ++y) {
+      for (int z = -1; z <= 1; ++z) {
+        if (std::abs(x) + std::abs(y) + std::abs(z) != 1 && std::abs(x * y * z) != 1) continue;
+        const Vector3d dir(x, y, z);
+        extremes.push_back(*std::max_element(
+          points.begin(), points.end(),
+          [&dir](const Vector3d& a, const Vector3d& b) { return a.dot(dir) < b.dot(dir); }));
+      }
+    }
+  }
+  std::sort(extremes.begin(), extremes.end(), [](const Vector3d& a, const Vector3d& b) {
+    return std::lexicographical_compare(a.data(), a.data() + 3, b.data(), b.data() + 3);
+  });
+  extremes.erase(std::unique(extremes.begin(), extremes.end()), extremes.end());
+
+  BoundingBox bbox;
+  for (const auto& p : extremes) bbox.extend(p);
+  const double margin = 1e-9 * bbox.sizes().maxCoeff();
+
+  // Find the facet planes of the polytope spanned by the few extreme points by brute force
+  std::vector<std::pair<Vector3d, double>> planes;
+  const size_t n = extremes.size();
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = i + 1; j < n; ++j) {
+      for (size_t k = j + 1; k < n; ++k) {
+        Vector3d normal = (extremes[j] - extremes[i]).cross(extremes[k] - extremes[i]);
+        if (normal.norm() <= margin * margin) continue;
+        normal.normalize();
+        const double d = normal.dot(extremes[i]);
+        bool above = false, below = false;
+        for (const auto& p : extremes) {
+          const double dist = normal.dot(p) - d;
+          above |= dist > margin;
+          below |= dist < -margin;
+        }
+        if (above && below) continue;
+        if (above) planes.emplace_back(-normal, -d);
+        else if (below) planes.emplace_back(normal, d);
+      }
+    }
+  }
+  if (planes.empty()) return;
+
+  points.erase(std::remove_if(points.begin(), points.end(),
+                              [&](const Vector3d& p) {
+                                return std::all_of(planes.begin(), planes.end(), [&](const auto& plane) {
+                                  return plane.first.dot(p) < plane.second - margin;
+                                });
+                              }),
+               points.end());
+}
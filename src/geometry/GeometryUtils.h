@@ -56,5 +56,6 @@ int findUnconnectedEdges(const std::vector<MarkedIndexedTriangle>& triangles);
 Transform3d getResizeTransform(const BoundingBox& bbox, const Vector3d& newsize,
                                const Eigen::Matrix<bool, 3, 1>& autosize);
 std::shared_ptr<const Geometry> getBackendSpecificGeometry(const std::shared_ptr<const Geometry>& geom);
+void discardInteriorHullPoints(std::vector<Vector3d>& points);
 
 }  // namespace GeometryUtils
@@ -2,6 +2,7 @@
 
 #include <boost/range/adaptor/reversed.hpp>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -9,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "geometry/ClipperUtils.h"
 #include "geometry/Geometry.h"
 #include "geometry/GeometryUtils.h"
 #include "geometry/PolySet.h"
@@ -28,18 +30,35 @@ namespace PolySetUtils {
 // Project all polygons (also back-facing) into a Polygon2d instance.
 // It is important to select all faces, since filtering by normal vector here
 // will trigger floating point incertainties and cause problems later.
+// The exception is a closed mesh: every point of its shadow is covered by an
+// upward-facing face, so faces facing down by clearly more than the rounding of
+// Clipper's fixed point grid can be dropped without opening cracks.
 std::unique_ptr<Polygon2d> project(const PolySet& ps)
 {
   auto poly = std::make_unique<Polygon2d>();
+  const double tolerance = std::ldexp(2.0, -ClipperUtils::scaleBitsFromPrecision());
 
-  Vector3d pt;
   for (const auto& p : ps.indices) {
+    if (p.size() < 3) continue;
     Outline2d outline;
+    outline.vertices.reserve(p.size());
     for (const auto& v : p) {
-      pt = ps.vertices[v];
-      outline.vertices.emplace_back(pt[0], pt[1]);
+      outline.vertices.emplace_back(ps.vertices[v][0], ps.vertices[v][1]);
     }
-    poly->addOutline(outline);
+    if (ps.isManifold()) {
+      // Twice the signed area, taken relative to the first vertex to limit cancellation
+      const Vector2d& origin = outline.vertices.front();
+      double area2 = 0.0;
+      double perimeter = 0.0;
+      for (size_t i = 0, j = outline.vertices.size() - 1; i < outline.vertices.size(); j = i++) {
+        const Vector2d a = outline.vertices[j] - origin;
+        const Vector2d b = outline.vertices[i] - origin;
+        area2 += a[0] * b[1] - a[1] * b[0];
+        perimeter += (b - a).norm();
+      }
+      if (area2 < -perimeter * tolerance) continue;
+    }
+    poly->addOutline(std::move(outline));
   }
   return poly;
 }
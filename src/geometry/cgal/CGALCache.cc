@@ -3,8 +3,11 @@
 #include <cassert>
 #include <cstddef>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 
+#include "MemoryBudget.h"
 #include "geometry/Geometry.h"
 #include "utils/printutils.h"
 #ifdef ENABLE_CGAL
@@ -18,15 +21,39 @@ CGALCache *CGALCache::inst = nullptr;
 
 CGALCache::CGALCache(size_t limit) : cache(limit)
 {
+  MemoryBudget::instance()->registerClient(this);
 }
 
-std::shared_ptr<const Geometry> CGALCache::get(const std::string& id) const
+CGALCache::~CGALCache()
 {
-  const auto& geom = this->cache[id]->N;
+  MemoryBudget::instance()->unregisterClient(this);
+}
+
+bool CGALCache::contains(const std::string& id) const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return this->cache.contains(id);
+}
+
+bool CGALCache::find(const std::string& id, std::shared_ptr<const Geometry>& N) const
+{
+  {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    const auto entry = this->cache[id];
+    if (!entry) return false;
+    N = entry->N;
+  }
 #ifdef DEBUG
-  LOG("CGAL Cache hit: %1$s (%2$d bytes)", id.substr(0, 40), geom ? geom->memsize() : 0);
+  LOG("CGAL Cache hit: %1$s (%2$d bytes)", id.substr(0, 40), N ? N->memsize() : 0);
 #endif
-  return geom;
+  return true;
+}
+
+std::shared_ptr<const Geometry> CGALCache::get(const std::string& id) const
+{
+  std::shared_ptr<const Geometry> N;
+  find(id, N);
+  return N;
 }
 
 bool CGALCache::acceptsGeometry(const std::shared_ptr<const Geometry>& geom)
@@ -41,10 +68,17 @@ bool CGALCache::acceptsGeometry(const std::shared_ptr<const Geometry>& geom)
     ;
 }
 
-bool CGALCache::insert(const std::string& id, const std::shared_ptr<const Geometry>& geom)
+bool CGALCache::insert(const std::string& id, const std::shared_ptr<const Geometry>& geom,
+                       double computeTime)
 {
   assert(acceptsGeometry(geom));
-  auto inserted = this->cache.insert(id, new cache_entry(geom), geom->memsize());
+  bool inserted;
+  {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    inserted = this->cache.insert(id, new cache_entry(geom), geom->memsize(), computeTime);
+  }
+  // The budget may evict from this cache, so it has to be unlocked
+  MemoryBudget::instance()->enforce();
 #ifdef DEBUG
   LOG("CGAL Cache %1$s: %2$s (%3$d bytes)", inserted ? "inserted" : "insert failed", id.substr(0, 40),
       geom->memsize());
@@ -54,33 +88,84 @@ bool CGALCache::insert(const std::string& id, const std::shared_ptr<const Geomet
 
 size_t CGALCache::size() const
 {
+  const std::lock_guard<std::mutex> lock(this->mutex);
   return cache.size();
 }
 
 size_t CGALCache::totalCost() const
 {
+  const std::lock_guard<std::mutex> lock(this->mutex);
   return cache.totalCost();
 }
 
+size_t CGALCache::hits() const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return cache.hits();
+}
+
+size_t CGALCache::misses() const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return cache.misses();
+}
+
+size_t CGALCache::evictions() const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return cache.evictions();
+}
+
+double CGALCache::computeTime() const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return cache.computeTime();
+}
+
 size_t CGALCache::maxSizeMB() const
 {
+  const std::lock_guard<std::mutex> lock(this->mutex);
   return this->cache.maxCost() / (1024ul * 1024ul);
 }
 
 void CGALCache::setMaxSizeMB(size_t limit)
 {
+  const std::lock_guard<std::mutex> lock(this->mutex);
   this->cache.setMaxCost(limit * 1024ul * 1024ul);
 }
 
 void CGALCache::clear()
 {
+  const std::lock_guard<std::mutex> lock(this->mutex);
   cache.clear();
 }
 
+size_t CGALCache::memoryUsage() const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return cache.totalCost();
+}
+
+std::optional<double> CGALCache::evictionPriority() const
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  return cache.nextEvictionPriority();
+}
+
+void CGALCache::evictOne()
+{
+  const std::lock_guard<std::mutex> lock(this->mutex);
+  cache.evictNext();
+}
+
 void CGALCache::print()
 {
+  const std::lock_guard<std::mutex> lock(this->mutex);
   LOG("CGAL Polyhedrons in cache: %1$d", this->cache.size());
   LOG("CGAL cache size in bytes: %1$d", this->cache.totalCost());
+  LOG("CGAL cache hits: %1$d, misses: %2$d", this->cache.hits(), this->cache.misses());
+  LOG("CGAL cache evictions: %1$d", this->cache.evictions());
+  LOG("CGAL cache compute time: %1$.3f s", this->cache.computeTime());
 }
 
 CGALCache::cache_entry::cache_entry(const std::shared_ptr<const Geometry>& N) : N(N)
@@ -2,15 +2,19 @@
 
 #include <cstddef>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 
 #include "Cache.h"
+#include "MemoryBudget.h"
 #include "geometry/Geometry.h"
 
-class CGALCache
+class CGALCache : public MemoryBudget::Client
 {
 public:
   CGALCache(size_t limit = 100ul * 1024ul * 1024ul);
+  ~CGALCache() override;
 
   static CGALCache *instance()
   {
@@ -19,16 +23,26 @@ public:
   }
   static bool acceptsGeometry(const std::shared_ptr<const Geometry>& geom);
 
-  bool contains(const std::string& id) const { return this->cache.contains(id); }
+  bool contains(const std::string& id) const;
+  // Looks id up and counts a hit or miss. The cached geometry may be nullptr.
+  bool find(const std::string& id, std::shared_ptr<const Geometry>& N) const;
   std::shared_ptr<const Geometry> get(const std::string& id) const;
-  bool insert(const std::string& id, const std::shared_ptr<const Geometry>& N);
+  bool insert(const std::string& id, const std::shared_ptr<const Geometry>& N, double computeTime = 0);
   size_t size() const;
   size_t totalCost() const;
+  size_t hits() const;
+  size_t misses() const;
+  size_t evictions() const;
+  double computeTime() const;
   size_t maxSizeMB() const;
   void setMaxSizeMB(size_t limit);
   void clear();
   void print();
 
+  [[nodiscard]] size_t memoryUsage() const override;
+  [[nodiscard]] std::optional<double> evictionPriority() const override;
+  void evictOne() override;
+
 private:
   static CGALCache *inst;
 
@@ -38,5 +52,7 @@ private:
     cache_entry(const std::shared_ptr<const Geometry>& N);
   };
 
+  // The cache is used from the worker threads, and evicted from by the MemoryBudget on any thread
+  mutable std::mutex mutex;
   Cache<std::string, cache_entry> cache;
 };
@@ -19,10 +19,14 @@
 #include <CGAL/normal_vector_newell_3.h>
 #include <CGAL/version.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <exception>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <numeric>
 #include <queue>
 #include <string>
 #include <utility>
@@ -34,10 +38,13 @@
 
 namespace CGALUtils {
 
-std::unique_ptr<const Geometry> applyUnion3D(Geometry::Geometries::iterator chbegin,
-                                             Geometry::Geometries::iterator chend)
+namespace {
+
+using QueueConstItem = std::pair<std::shared_ptr<const CGALNefGeometry>, int>;
+
+// Unions the given polyhedra pairwise, always combining the two with the fewest facets
+std::shared_ptr<const CGALNefGeometry> unionByFacets(std::vector<QueueConstItem> items)
 {
-  using QueueConstItem = std::pair<std::shared_ptr<const CGALNefGeometry>, int>;
   struct QueueItemGreater {
     // stable sort for priority_queue by facets, then progress mark
     bool operator()(const QueueConstItem& lhs, const QueueConstItem& rhs) const
@@ -47,10 +54,64 @@ std::unique_ptr<const Geometry> applyUnion3D(Geometry::Geometries::iterator chbe
       return (l > r) || (l == r && lhs.second > rhs.second);
     }
   };
-  std::priority_queue<QueueConstItem, std::vector<QueueConstItem>, QueueItemGreater> q;
+  std::priority_queue<QueueConstItem, std::vector<QueueConstItem>, QueueItemGreater> q(
+    QueueItemGreater(), std::move(items));
+
+  while (q.size() > 1) {
+    auto p1 = q.top();
+    q.pop();
+    auto p2 = q.top();
+    q.pop();
+    q.emplace(std::make_shared<const CGALNefGeometry>(*p1.first + *p2.first), -1);
+    progress_tick();
+  }
+  return q.empty() ? nullptr : q.top().first;
+}
+
+// Groups boxes into clusters of transitively overlapping boxes, returning a cluster
+// index per box. Sweeps along x, so only boxes overlapping in x are compared.
+std::vector<size_t> clusterByBoundingBox(const std::vector<BoundingBox>& boxes)
+{
+  std::vector<size_t> parent(boxes.size());
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find = [&parent](size_t i) {
+    while (parent[i] != i) i = parent[i] = parent[parent[i]];
+    return i;
+  };
+
+  std::vector<size_t> order(boxes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&boxes](size_t a, size_t b) { return boxes[a].min().x() < boxes[b].min().x(); });
+  std::vector<size_t> active;
+  for (const auto i : order) {
+    active.erase(std::remove_if(active.begin(), active.end(),
+                                [&](size_t j) { return boxes[j].max().x() < boxes[i].min().x(); }),
+                 active.end());
+    for (const auto j : active) {
+      if (boxes[i].intersects(boxes[j])) parent[find(i)] = find(j);
+    }
+    active.push_back(i);
+  }
+
+  std::vector<size_t> clusters(boxes.size());
+  for (size_t i = 0; i < boxes.size(); ++i) clusters[i] = find(i);
+  return clusters;
+}
+
+}  // namespace
 
+/*!
+   Unions the children in clusters of overlapping bounding boxes first, so the
+   expensive intersecting overlays stay small, and then combines the mutually
+   disjoint cluster results.
+ */
+std::unique_ptr<const Geometry> applyUnion3D(Geometry::Geometries::iterator chbegin,
+                                             Geometry::Geometries::iterator chend)
+{
   try {
-    // sort children by fewest faces
+    std::vector<QueueConstItem> items;
+    std::vector<BoundingBox> boxes;
     for (auto it = chbegin; it != chend; ++it) {
       auto curChild = getNefPolyhedronFromGeometry(it->second);
       if (curChild && !curChild->isEmpty()) {
@@ -58,22 +119,24 @@ std::unique_ptr<const Geometry> applyUnion3D(Geometry::Geometries::iterator chbe
         if (it->first) {
           node_mark = it->first->progress_mark;
         }
-        q.emplace(curChild, node_mark);
+        boxes.push_back(curChild->getBoundingBox());
+        items.emplace_back(curChild, node_mark);
       }
     }
 
     progress_tick();
-    while (q.size() > 1) {
-      auto p1 = q.top();
-      q.pop();
-      auto p2 = q.top();
-      q.pop();
-      q.emplace(std::make_unique<const CGALNefGeometry>(*p1.first + *p2.first), -1);
-      progress_tick();
+    const auto clusters = clusterByBoundingBox(boxes);
+    std::map<size_t, std::vector<QueueConstItem>> cluster_items;
+    for (size_t i = 0; i < items.size(); ++i) {
+      cluster_items[clusters[i]].push_back(std::move(items[i]));
+    }
+    std::vector<QueueConstItem> cluster_results;
+    for (auto& [cluster, members] : cluster_items) {
+      cluster_results.emplace_back(unionByFacets(std::move(members)), -1);
     }
 
-    if (q.size() == 1) {
-      return std::make_unique<CGALNefGeometry>(q.top().first->p3);
+    if (auto N = unionByFacets(std::move(cluster_results))) {
+      return std::make_unique<CGALNefGeometry>(N->p3);
     } else {
       return nullptr;
     }
@@ -90,27 +153,42 @@ std::unique_ptr<const Geometry> applyUnion3D(Geometry::Geometries::iterator chbe
 std::shared_ptr<const Geometry> applyOperator3D(const Geometry::Geometries& children,
                                                 OpenSCADOperator op)
 {
-  std::shared_ptr<CGALNefGeometry> N;
+  std::shared_ptr<const CGALNefGeometry> N;
 
   assert(op != OpenSCADOperator::UNION && "use applyUnion3D() instead of applyOperator3D()");
-  bool foundFirst = false;
+  if (children.empty()) return N;
 
   try {
-    for (const auto& item : children) {
-      const std::shared_ptr<const Geometry>& chgeom = item.second;
-      auto chN = getNefPolyhedronFromGeometry(chgeom);
-
-      // Initialize N with first expected geometric object
-      if (!foundFirst) {
-        if (chN) {
-          // FIXME: Do we need to make a copy here?
-          N = std::make_shared<CGALNefGeometry>(*chN);
-        } else {  // first child geometry might be empty/null
-          N = nullptr;
+    // Initialize N with first expected geometric object, which might be empty/null
+    N = getNefPolyhedronFromGeometry(children.front().second);
+
+    if (op == OpenSCADOperator::DIFFERENCE) {
+      // Subtract the union of all subtrahends at once rather than one at a time,
+      // skipping those which cannot touch the minuend
+      if (!N || N->isEmpty()) return N;
+      const BoundingBox bbox = N->getBoundingBox();
+      Geometry::Geometries subtrahends;
+      for (auto it = std::next(children.begin()); it != children.end(); ++it) {
+        if (it->second && !it->second->isEmpty() && bbox.intersects(it->second->getBoundingBox())) {
+          subtrahends.push_back(*it);
         }
-        foundFirst = true;
-        continue;
       }
+      if (!subtrahends.empty()) {
+        auto subtrahend = applyUnion3D(subtrahends.begin(), subtrahends.end());
+        if (const auto *subN = dynamic_cast<const CGALNefGeometry *>(subtrahend.get())) {
+          N = std::make_shared<const CGALNefGeometry>(
+            std::make_shared<CGAL_Nef_polyhedron3>(*N->p3 - *subN->p3));
+        }
+      }
+      for (auto it = std::next(children.begin()); it != children.end(); ++it) {
+        if (it->first) it->first->progress_report();
+      }
+      return N;
+    }
+
+    for (auto it = std::next(children.begin()); it != children.end(); ++it) {
+      const auto& item = *it;
+      auto chN = getNefPolyhedronFromGeometry(item.second);
 
       // Intersecting something with nothing results in nothing
       if (!chN || chN->isEmpty()) {
@@ -124,10 +202,21 @@ std::shared_ptr<const Geometry> applyOperator3D(const Geometry::Geometries& chil
       if (!N || N->isEmpty()) continue;
 
       switch (op) {
-      case OpenSCADOperator::INTERSECTION: *N *= *chN; break;
-      case OpenSCADOperator::DIFFERENCE:   *N -= *chN; break;
-      case OpenSCADOperator::MINKOWSKI:    N->minkowski(*chN); break;
-      default:                             LOG(message_group::Error, "Unsupported CGAL operator: %1$d", static_cast<int>(op));
+      case OpenSCADOperator::INTERSECTION:
+        if (N->getBoundingBox().intersects(chN->getBoundingBox())) {
+          N = std::make_shared<const CGALNefGeometry>(
+            std::make_shared<CGAL_Nef_polyhedron3>(*N->p3 * *chN->p3));
+        } else {
+          N = nullptr;
+        }
+        break;
+      case OpenSCADOperator::MINKOWSKI: {
+        auto result = std::make_shared<CGALNefGeometry>(*N);
+        result->minkowski(*chN);
+        N = result;
+        break;
+      }
+      default: LOG(message_group::Error, "Unsupported CGAL operator: %1$d", static_cast<int>(op));
       }
       if (item.first) item.first->progress_report();
     }
@@ -158,7 +158,9 @@ void add_slice_indices(PolygonIndices& indices, int slice_idx, int slice_stride,
   Eigen::Affine2d trans_top(Eigen::Scaling(scale_slice_top) *
                             Eigen::Affine2d(rotate_degrees(-rotation_slice_top)));
 
-  bool any_zero = scale_slice_top[0] == 0 || scale_slice_top[1] == 0;
+  // Only sweep() collapses the bottom of a slice, linear_extrude() just the top
+  bool any_zero = scale_slice_top[0] == 0 || scale_slice_top[1] == 0 || scale_slice_bottom[0] == 0 ||
+                  scale_slice_bottom[1] == 0;
   // setting back_twist true helps keep diagonals same as previous builds.
   bool back_twist = rotation_slice_top <= rotation_slice_bottom;
 
@@ -190,7 +192,7 @@ void add_slice_indices(PolygonIndices& indices, int slice_idx, int slice_stride,
       bool splitfirst = diff_sign == -1 || (diff_sign == 0 && !flip);
 
       // Split along shortest diagonal,
-      // unless at top for a 0-scaled axis (which can create 0 thickness "ears")
+      // unless at top or bottom for a 0-scaled axis (which can create 0 thickness "ears")
       if (splitfirst xor any_zero) {
         indices.push_back({
           bottom_offset + idx,
@@ -410,8 +412,11 @@ std::unique_ptr<Geometry> extrudePolygon(const LinearExtrudeNode& node, const Po
 
 #ifdef ENABLE_MANIFOLD
   if (RenderSettings::inst()->backend3D == RenderBackend3D::ManifoldBackend) {
-    return assemblePolySetForManifold(polyref, std::move(vertices), std::move(indices), node.convexity,
-                                      isConvex, slice_stride * num_slices);
+    auto ps = assemblePolySetForManifold(polyref, std::move(vertices), std::move(indices),
+                                         node.convexity, isConvex, slice_stride * num_slices);
+    // Slices share their vertices, so unless the top collapses the result is closed by construction
+    ps->setManifold(node.scale_x != 0 && node.scale_y != 0);
+    return ps;
   } else
 #endif
     return assemblePolySetForCGAL(polyref, vertices, indices, node.convexity, isConvex, node.scale_x,
@@ -1,9 +1,24 @@
 #pragma once
 
+#include <boost/logic/tribool.hpp>
 #include <memory>
+#include <vector>
 
 #include "core/LinearExtrudeNode.h"
 #include "geometry/Geometry.h"
+#include "geometry/PolySet.h"
 #include "geometry/Polygon2d.h"
+#include "geometry/linalg.h"
 
 std::unique_ptr<Geometry> extrudePolygon(const LinearExtrudeNode& node, const Polygon2d& poly);
+
+// Slice machinery shared with other extrusions (e.g. sweep)
+namespace LinearExtrudeInternals {
+std::unique_ptr<PolySet> assemblePolySetForManifold(const Polygon2d& polyref,
+                                                    std::vector<Vector3d>&& vertices,
+                                                    PolygonIndices&& indices, int convexity,
+                                                    boost::tribool isConvex, int index_offset);
+void add_slice_indices(PolygonIndices& indices, int slice_idx, int slice_stride, const Polygon2d& poly,
+                       double rotation_slice_bottom, double rotation_slice_top,
+                       const Vector2d& scale_slice_bottom, const Vector2d& scale_slice_top);
+}  // namespace LinearExtrudeInternals
@@ -3,16 +3,21 @@
 
 #ifdef ENABLE_MANIFOLD
 
+#include <cstddef>
 #include <memory>
+#include <vector>
 
 #include "core/AST.h"
 #include "core/enums.h"
 #include "core/node.h"
 #include "core/progress.h"
 #include "geometry/Geometry.h"
+#include "geometry/GeometryUtils.h"
 #include "geometry/PolySet.h"
+#include "geometry/linalg.h"
 #include "geometry/manifold/ManifoldGeometry.h"
 #include "geometry/manifold/manifoldutils.h"
+#include "utils/parallel.h"
 #include "utils/printutils.h"
 
 namespace ManifoldUtils {
@@ -30,36 +35,69 @@ std::shared_ptr<ManifoldGeometry> applyOperator3DManifold(const Geometry::Geomet
                                                           OpenSCADOperator op)
 {
   if (op == OpenSCADOperator::HULL) {
-    std::vector<manifold::vec3> pts;
+    // Collect candidate points per child. Conversions might involve CGAL so they are
+    // done up front, the rest is independent per child and runs in parallel.
+    std::vector<std::shared_ptr<const Geometry>> geoms;
     for (const auto& item : children) {
       if (!item.second) continue;
-      auto& chgeom = item.second;
-      if (const auto *mani = dynamic_cast<const ManifoldGeometry *>(chgeom.get())) {
-        pts.reserve(pts.size() + mani->numVertices());
-        mani->foreachVertexUntilTrue([&](auto& p) {
-          pts.push_back(p);
-          return false;
-        });
-      } else if (const auto *ps = dynamic_cast<const PolySet *>(chgeom.get())) {
-        pts.reserve(pts.size() + ps->indices.size() * 3);
-        for (const auto& p : ps->indices) {
-          for (const auto& ind : p) {
-            auto& v = ps->vertices[ind];
-            pts.push_back({v[0], v[1], v[2]});
-          }
-        }
-      } else {
-        auto chN = createManifoldFromGeometry(chgeom);
-        if (chN && !chN->isEmpty()) {
-          chN->foreachVertexUntilTrue([&](auto& p) {
-            pts.push_back(p);
+      if (dynamic_cast<const ManifoldGeometry *>(item.second.get()) ||
+          dynamic_cast<const PolySet *>(item.second.get())) {
+        geoms.push_back(item.second);
+      } else if (auto chN = createManifoldFromGeometry(item.second)) {
+        geoms.push_back(chN);
+      }
+    }
+    const bool multiple_children = geoms.size() > 1;
+    std::vector<std::vector<Vector3d>> child_points(geoms.size());
+    parallelizable_transform(
+      geoms.begin(), geoms.end(), child_points.begin(), [&](const auto& chgeom) {
+        std::vector<Vector3d> pts;
+        bool convex = false;
+        if (const auto *mani = dynamic_cast<const ManifoldGeometry *>(chgeom.get())) {
+          pts.reserve(mani->numVertices());
+          mani->foreachVertexUntilTrue([&](auto& p) {
+            pts.emplace_back(p.x, p.y, p.z);
             return false;
           });
+        } else if (const auto *ps = dynamic_cast<const PolySet *>(chgeom.get())) {
+          // Only vertices referenced by a face, each once
+          std::vector<bool> used(ps->vertices.size());
+          for (const auto& p : ps->indices) {
+            for (const auto& ind : p) used[ind] = true;
+          }
+          for (size_t i = 0; i < ps->vertices.size(); ++i) {
+            if (used[i]) pts.push_back(ps->vertices[i]);
+          }
+          convex = static_cast<bool>(ps->convexValue());
         }
-      }
-      if (item.first) item.first->progress_report();
+        GeometryUtils::discardInteriorHullPoints(pts);
+        // Reduce each non-convex child to its own hull before the final merge
+        if (multiple_children && !convex && pts.size() > 4) {
+          std::vector<manifold::vec3> mpts;
+          mpts.reserve(pts.size());
+          for (const auto& p : pts) mpts.push_back({p[0], p[1], p[2]});
+          const auto mesh = manifold::Manifold::Hull(mpts).GetMeshGL64();
+          pts.clear();
+          for (size_t v = 0; v < mesh.NumVert(); ++v) {
+            const auto p = mesh.GetVertPos(v);
+            pts.emplace_back(p.x, p.y, p.z);
+          }
+        }
+        return pts;
+      });
+    for (const auto& item : children) {
+      if (item.second && item.first) item.first->progress_report();
     }
-    if (pts.empty()) return nullptr;
+
+    std::vector<Vector3d> merged;
+    for (const auto& pts : child_points) {
+      merged.insert(merged.end(), pts.begin(), pts.end());
+    }
+    if (multiple_children) GeometryUtils::discardInteriorHullPoints(merged);
+    if (merged.empty()) return nullptr;
+    std::vector<manifold::vec3> pts;
+    pts.reserve(merged.size());
+    for (const auto& p : merged) pts.push_back({p[0], p[1], p[2]});
     return std::make_shared<ManifoldGeometry>(manifold::Manifold::Hull(pts));
   }
 
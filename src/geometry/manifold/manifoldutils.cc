@@ -3,6 +3,7 @@
 
 #include <manifold/polygon.h>
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -33,58 +34,75 @@ using Error = manifold::Manifold::Error;
 
 namespace {
 
-std::shared_ptr<ManifoldGeometry> createManifoldFromTriangularPolySet(const PolySet& ps)
-{
-  assert(ps.isTriangular());
+std::atomic<size_t> num_conversions{0};
+std::atomic<size_t> num_direct_conversions{0};
+std::atomic<size_t> num_repaired_conversions{0};
 
+// Faces must be triangles, or planar and convex so they can be fan triangulated.
+std::shared_ptr<ManifoldGeometry> createManifoldFromPolySetFaces(const PolySet& ps, bool try_merge)
+{
   manifold::MeshGL64 mesh;
 
   mesh.numProp = 3;
-  mesh.vertProperties.reserve(ps.vertices.size() * 3);
-  for (const auto& v : ps.vertices) {
-    mesh.vertProperties.push_back(v.x());
-    mesh.vertProperties.push_back(v.y());
-    mesh.vertProperties.push_back(v.z());
+  static_assert(sizeof(Vector3d) == 3 * sizeof(double), "Vector3d must be tightly packed");
+  if (!ps.vertices.empty()) {
+    const double *coords = ps.vertices.front().data();
+    mesh.vertProperties.assign(coords, coords + 3 * ps.vertices.size());
   }
 
-  mesh.triVerts.reserve(ps.indices.size() * 3);
+  size_t num_tris = 0;
+  for (const auto& face : ps.indices) {
+    if (face.size() >= 3) num_tris += face.size() - 2;
+  }
+  mesh.triVerts.reserve(num_tris * 3);
+
+  auto addFace = [&mesh](const IndexedFace& face) {
+    for (size_t i = 2; i < face.size(); ++i) {
+      mesh.triVerts.push_back(face[0]);
+      mesh.triVerts.push_back(face[i - 1]);
+      mesh.triVerts.push_back(face[i]);
+    }
+  };
 
   std::set<uint32_t> originalIDs;
   std::map<uint32_t, Color4f> originalIDToColor;
 
-  std::map<std::optional<Color4f>, std::vector<size_t>> colorToFaceIndices;
-  for (size_t i = 0, n = ps.indices.size(); i < n; i++) {
-    auto color_index = i < ps.color_indices.size() ? ps.color_indices[i] : -1;
-    std::optional<Color4f> color;
-    if (color_index >= 0) {
-      color = ps.colors[color_index];
-    }
-    colorToFaceIndices[color].push_back(i);
-  }
-  auto next_id = manifold::Manifold::ReserveIDs(colorToFaceIndices.size());
-  for (const auto& [color, faceIndices] : colorToFaceIndices) {
-    auto id = next_id++;
-    if (color.has_value()) {
-      originalIDToColor[id] = color.value();
-    }
-
-    mesh.runIndex.push_back(mesh.triVerts.size());
+  if (ps.color_indices.empty()) {
+    // Uncolored meshes form a single run, no need to group faces by color
+    auto id = manifold::Manifold::ReserveIDs(1);
+    mesh.runIndex.push_back(0);
     mesh.runOriginalID.push_back(id);
     originalIDs.insert(id);
+    for (const auto& face : ps.indices) addFace(face);
+  } else {
+    std::map<std::optional<Color4f>, std::vector<size_t>> colorToFaceIndices;
+    for (size_t i = 0, n = ps.indices.size(); i < n; i++) {
+      auto color_index = i < ps.color_indices.size() ? ps.color_indices[i] : -1;
+      std::optional<Color4f> color;
+      if (color_index >= 0) {
+        color = ps.colors[color_index];
+      }
+      colorToFaceIndices[color].push_back(i);
+    }
+    auto next_id = manifold::Manifold::ReserveIDs(colorToFaceIndices.size());
+    for (const auto& [color, faceIndices] : colorToFaceIndices) {
+      auto id = next_id++;
+      if (color.has_value()) {
+        originalIDToColor[id] = color.value();
+      }
 
-    for (size_t faceIndex : faceIndices) {
-      auto& face = ps.indices[faceIndex];
-      assert(face.size() == 3);
-      mesh.triVerts.push_back(face[0]);
-      mesh.triVerts.push_back(face[1]);
-      mesh.triVerts.push_back(face[2]);
+      mesh.runIndex.push_back(mesh.triVerts.size());
+      mesh.runOriginalID.push_back(id);
+      originalIDs.insert(id);
+
+      for (size_t faceIndex : faceIndices) addFace(ps.indices[faceIndex]);
     }
   }
   mesh.runIndex.push_back(mesh.triVerts.size());
 
   auto mani = manifold::Manifold(mesh);
 
-  if (mani.Status() != Error::NoError) {
+  if (try_merge && mani.Status() != Error::NoError) {
     PRINTD("Manifold creation initially failed");
     bool merged = mesh.Merge();
     mani = manifold::Manifold(mesh);
@@ -124,13 +142,40 @@ const char *statusToString(Error status)
   }
 }
 
+ConversionStatistics conversionStatistics()
+{
+  return {num_conversions, num_direct_conversions, num_repaired_conversions};
+}
+
+void resetConversionStatistics()
+{
+  num_conversions = 0;
+  num_direct_conversions = 0;
+  num_repaired_conversions = 0;
+}
+
 std::shared_ptr<ManifoldGeometry> createManifoldFromPolySet(const PolySet& ps)
 {
+  num_conversions++;
+
+  // 0. Producers flag PolySets they know to be closed and consistently oriented (primitives,
+  // extrusions, ManifoldGeometry::toPolySet(), ...). These can be handed to Manifold without
+  // tessellation or merging; faces of a convex PolySet are convex, so a fan triangulation will do.
+  // If the flag turns out to be wrong, we fall back to the regular path below.
+  if (ps.isManifold() && (ps.isTriangular() || ps.convexValue())) {
+    auto mani = createManifoldFromPolySetFaces(ps, /*try_merge=*/false);
+    if (mani->getManifold().Status() == Error::NoError) {
+      num_direct_conversions++;
+      return mani;
+    }
+    PRINTD("Direct conversion of manifold PolySet failed");
+  }
+
   // 1. If the PolySet is already manifold, we should be able to build a Manifold object directly
   // (through using manifold::Mesh).
   // We need to make sure our PolySet is triangulated before doing that.
-  // Note: We currently don't have a way of directly checking if a PolySet is manifold,
-  // so we just try converting to a Manifold object and check its status.
+  // Note: Unless flagged by the producer, we don't have a way of directly checking if a PolySet
+  // is manifold, so we just try converting to a Manifold object and check its status.
   std::unique_ptr<const PolySet> triangulated;
   if (!ps.isTriangular()) {
     triangulated = PolySetUtils::tessellate_faces(ps);
@@ -138,7 +183,7 @@ std::shared_ptr<ManifoldGeometry> createManifoldFromPolySet(const PolySet& ps)
   const PolySet& triangle_set = ps.isTriangular() ? ps : *triangulated;
 
   // Note: This function also performs a merge if the first attempt fails.
-  auto mani = createManifoldFromTriangularPolySet(triangle_set);
+  auto mani = createManifoldFromPolySetFaces(triangle_set, /*try_merge=*/true);
   if (mani->getManifold().Status() == Error::NoError) {
     return mani;
   }
@@ -147,6 +192,7 @@ std::shared_ptr<ManifoldGeometry> createManifoldFromPolySet(const PolySet& ps)
       "PolySet -> Manifold conversion failed: %1$s\n"
       "Trying to repair and reconstruct mesh..",
       ManifoldUtils::statusToString(mani->getManifold().Status()));
+  num_repaired_conversions++;
 
   // 2. If the PolySet couldn't be converted into a Manifold object, let's try to repair it.
   // We currently have to utilize some CGAL functions to do this.
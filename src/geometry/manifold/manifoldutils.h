@@ -2,6 +2,7 @@
 
 #include <CGAL/Surface_mesh/Surface_mesh.h>
 
+#include <cstddef>
 #include <memory>
 
 #include "core/enums.h"
@@ -13,6 +14,15 @@ namespace ManifoldUtils {
 
 const char *statusToString(manifold::Manifold::Error status);
 
+// Counts PolySet -> Manifold conversions since the last reset, for the render summary.
+struct ConversionStatistics {
+  size_t conversions;
+  size_t direct;    // flagged as manifold by the producer, converted as-is
+  size_t repaired;  // needed the CGAL based repair fallback
+};
+ConversionStatistics conversionStatistics();
+void resetConversionStatistics();
+
 std::shared_ptr<ManifoldGeometry> createManifoldFromPolySet(const PolySet& ps);
 std::shared_ptr<const ManifoldGeometry> createManifoldFromGeometry(
   const std::shared_ptr<const Geometry>& geom);
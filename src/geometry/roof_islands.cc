@@ -0,0 +1,82 @@
+// This file is a part of openscad. Everything implied is implied.
+
+#include "geometry/roof_islands.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "clipper2/clipper.h"
+#include "geometry/GeometryCache.h"
+#include "geometry/PolySet.h"
+#include "utils/parallel.h"
+
+namespace roof_islands {
+
+namespace {
+
+// The key holds the complete outline, so islands only share an entry if they are identical
+std::string cacheKey(const Clipper2Lib::Paths64& island, const std::string& method)
+{
+  std::string outline;
+  const auto append = [&outline](int64_t value) {
+    outline.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  };
+  for (const auto& path : island) {
+    append(static_cast<int64_t>(path.size()));
+    for (const auto& p : path) {
+      append(p.x);
+      append(p.y);
+    }
+  }
+  return GeometryCache::derivedKey(GeometryCache::derivedKey("roof", method), outline);
+}
+
+}  // namespace
+
+std::vector<Clipper2Lib::Paths64> islands(const Clipper2Lib::PolyTree64& polytree)
+{
+  std::vector<Clipper2Lib::Paths64> ret;
+
+  std::function<void(const Clipper2Lib::PolyPath64&)> walk = [&](const Clipper2Lib::PolyPath64& c) {
+    Clipper2Lib::Paths64 island{c.Polygon()};
+    for (const auto& cc : c) {
+      island.push_back(cc->Polygon());
+      for (const auto& ccc : *cc) walk(*ccc);
+    }
+    ret.push_back(std::move(island));
+  };
+
+  for (const auto& root_node : polytree) walk(*root_node);
+
+  return ret;
+}
+
+std::vector<std::shared_ptr<const PolySet>> roofs(const std::vector<Clipper2Lib::Paths64>& islands,
+                                                  const std::string& method, const IslandRoof& roof)
+{
+  // The cache isn't thread safe, so look up and insert around the parallel part
+  std::vector<std::shared_ptr<const PolySet>> ret(islands.size());
+  std::vector<std::string> keys(islands.size());
+  std::vector<size_t> missing;
+  for (size_t i = 0; i < islands.size(); ++i) {
+    keys[i] = cacheKey(islands[i], method);
+    ret[i] = std::dynamic_pointer_cast<const PolySet>(GeometryCache::instance()->get(keys[i]));
+    if (!ret[i]) missing.push_back(i);
+  }
+
+  std::vector<std::shared_ptr<const PolySet>> computed(missing.size());
+  parallelizable_transform(missing.begin(), missing.end(), computed.begin(),
+                           [&](size_t i) -> std::shared_ptr<const PolySet> { return roof(islands[i]); });
+
+  for (size_t m = 0; m < missing.size(); ++m) {
+    ret[missing[m]] = computed[m];
+    GeometryCache::instance()->insert(keys[missing[m]], computed[m]);
+  }
+  return ret;
+}
+
+}  // namespace roof_islands
@@ -0,0 +1,28 @@
+// This file is a part of openscad. Everything implied is implied.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "clipper2/clipper.h"
+#include "geometry/PolySet.h"
+
+namespace roof_islands {
+
+// Breaks a sanitized polytree into islands, each an outline followed by its holes.
+// Islands nested inside a hole come before the island containing them.
+std::vector<Clipper2Lib::Paths64> islands(const Clipper2Lib::PolyTree64& polytree);
+
+// Computes the roof over a single island, without the floor.
+using IslandRoof = std::function<std::unique_ptr<PolySet>(const Clipper2Lib::Paths64& island)>;
+
+// Computes the roofs of all islands in parallel. Roofs of islands seen before with the same
+// outlines and method are taken from the geometry cache, method has to identify the roof
+// method together with all parameters affecting its result.
+std::vector<std::shared_ptr<const PolySet>> roofs(const std::vector<Clipper2Lib::Paths64>& islands,
+                                                  const std::string& method, const IslandRoof& roof);
+
+}  // namespace roof_islands
@@ -11,9 +11,9 @@
 #include <clipper2/clipper.engine.h>
 
 #include <cmath>
-#include <functional>
 #include <iterator>
 #include <memory>
+#include <string>
 #include <vector>
 #if CGAL_VERSION_NR < CGAL_VERSION_NUMBER(6, 0, 0)
 #include <boost/shared_ptr.hpp>
@@ -28,6 +28,7 @@
 #include "geometry/PolySetBuilder.h"
 #include "geometry/Polygon2d.h"
 #include "geometry/linalg.h"
+#include "geometry/roof_islands.h"
 
 #define RAISE_ROOF_EXCEPTION(message) \
   throw RoofNode::roof_exception(     \
@@ -62,28 +63,63 @@ CGAL_Polygon_2 to_cgal_polygon_2(const Clipper2Lib::Path64& path, int scale_bits
   return poly;
 }
 
-// break a list of outlines into polygons with holes
-std::vector<CGAL_Polygon_with_holes_2> polygons_with_holes(const Clipper2Lib::PolyTree64& polytree,
-                                                           int scale_bits)
+// an island, i.e. an outline followed by its holes, as polygon with holes
+CGAL_Polygon_with_holes_2 polygon_with_holes(const Clipper2Lib::Paths64& island, int scale_bits)
 {
-  std::vector<CGAL_Polygon_with_holes_2> ret;
-
-  // lambda for recursive walk through polytree
-  std::function<void(const Clipper2Lib::PolyPath64&)> walk = [&](const Clipper2Lib::PolyPath64& c) {
-    // outer path
-    CGAL_Polygon_with_holes_2 c_poly(to_cgal_polygon_2(c.Polygon(), scale_bits));
-    // holes
-    for (const auto& cc : c) {
-      c_poly.add_hole(to_cgal_polygon_2(cc->Polygon(), scale_bits));
-      for (const auto& ccc : *cc) walk(*ccc);
-    }
-    ret.push_back(c_poly);
-    return;
+  CGAL_Polygon_with_holes_2 ret(to_cgal_polygon_2(island.front(), scale_bits));
+  for (auto hole = std::next(island.begin()); hole != island.end(); ++hole) {
+    ret.add_hole(to_cgal_polygon_2(*hole, scale_bits));
+  }
+  return ret;
+}
+
+std::unique_ptr<PolySet> island_roof(const Clipper2Lib::Paths64& island, int scale_bits)
+{
+  PolySetBuilder roofbuilder;
+
+  const CGAL_SsPtr ss =
+    CGAL::create_interior_straight_skeleton_2(polygon_with_holes(island, scale_bits));
+  // store heights of vertices
+  auto vector2d_comp = [](const Vector2d& a, const Vector2d& b) {
+    return (a[0] < b[0]) || (a[0] == b[0] && a[1] < b[1]);
   };
+  std::map<Vector2d, double, decltype(vector2d_comp)> heights(vector2d_comp);
+  for (auto v = ss->vertices_begin(); v != ss->vertices_end(); v++) {
+    const Vector2d p(v->point().x(), v->point().y());
+    heights[p] = v->time();
+  }
+
+  for (auto ss_face = ss->faces_begin(); ss_face != ss->faces_end(); ss_face++) {
+    // convert ss_face to cgal polygon
+    CGAL_Polygon_2 face;
+    for (auto h = ss_face->halfedge();;) {
+      const CGAL_Point_2 pp = h->vertex()->point();
+      face.push_back(pp);
+      h = h->next();
+      if (h == ss_face->halfedge()) {
+        break;
+      }
+    }
+    if (!face.is_simple()) {
+      RAISE_ROOF_EXCEPTION("A non-simple face in straight skeleton, likely cause is cgal issue #5177");
+    }
 
-  for (const auto& root_node : polytree) walk(*root_node);
+    // do convex partition if necessary
+    std::vector<CGAL_PT::Polygon_2> facets;
+    CGAL::approx_convex_partition_2(face.vertices_begin(), face.vertices_end(),
+                                    std::back_inserter(facets));
 
-  return ret;
+    for (const auto& facet : facets) {
+      std::vector<int> roof;
+      for (auto v = facet.vertices_begin(); v != facet.vertices_end(); v++) {
+        const Vector2d vv(v->x(), v->y());
+        roof.push_back(roofbuilder.vertexIndex(Vector3d(v->x(), v->y(), heights[vv])));
+      }
+      roofbuilder.appendPolygon(roof);
+    }
+  }
+
+  return roofbuilder.build();
 }
 
 std::unique_ptr<PolySet> straight_skeleton_roof(const Polygon2d& poly)
@@ -97,50 +133,11 @@ std::unique_ptr<PolySet> straight_skeleton_roof(const Polygon2d& poly)
 
   try {
     // roof
-    const std::vector<CGAL_Polygon_with_holes_2> shapes = polygons_with_holes(*polytree, scale_bits);
-    for (const CGAL_Polygon_with_holes_2& shape : shapes) {
-      const CGAL_SsPtr ss = CGAL::create_interior_straight_skeleton_2(shape);
-      // store heights of vertices
-      auto vector2d_comp = [](const Vector2d& a, const Vector2d& b) {
-        return (a[0] < b[0]) || (a[0] == b[0] && a[1] < b[1]);
-      };
-      std::map<Vector2d, double, decltype(vector2d_comp)> heights(vector2d_comp);
-      for (auto v = ss->vertices_begin(); v != ss->vertices_end(); v++) {
-        const Vector2d p(v->point().x(), v->point().y());
-        heights[p] = v->time();
-      }
-
-      for (auto ss_face = ss->faces_begin(); ss_face != ss->faces_end(); ss_face++) {
-        // convert ss_face to cgal polygon
-        CGAL_Polygon_2 face;
-        for (auto h = ss_face->halfedge();;) {
-          const CGAL_Point_2 pp = h->vertex()->point();
-          face.push_back(pp);
-          h = h->next();
-          if (h == ss_face->halfedge()) {
-            break;
-          }
-        }
-        if (!face.is_simple()) {
-          RAISE_ROOF_EXCEPTION(
-            "A non-simple face in straight skeleton, likely cause is cgal issue #5177");
-        }
-
-        // do convex partition if necessary
-        std::vector<CGAL_PT::Polygon_2> facets;
-        CGAL::approx_convex_partition_2(face.vertices_begin(), face.vertices_end(),
-                                        std::back_inserter(facets));
-
-        for (const auto& facet : facets) {
-          std::vector<int> roof;
-          for (auto v = facet.vertices_begin(); v != facet.vertices_end(); v++) {
-            const Vector2d vv(v->x(), v->y());
-            roof.push_back(hatbuilder.vertexIndex(Vector3d(v->x(), v->y(), heights[vv])));
-          }
-          hatbuilder.appendPolygon(roof);
-        }
-      }
-    }
+    // Islands are independent of each other, so their straight skeletons are computed in parallel
+    const auto roofs = roof_islands::roofs(
+      roof_islands::islands(*polytree), "straight:" + std::to_string(scale_bits),
+      [scale_bits](const Clipper2Lib::Paths64& island) { return island_roof(island, scale_bits); });
+    for (const auto& roof : roofs) hatbuilder.appendPolySet(*roof);
 
     // floor
     {
@@ -11,6 +11,8 @@
 #include <map>
 #include <memory>
 #include <ostream>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include "core/CurveDiscretizer.h"
@@ -20,6 +22,7 @@
 #include "geometry/PolySetBuilder.h"
 #include "geometry/Polygon2d.h"
 #include "geometry/linalg.h"
+#include "geometry/roof_islands.h"
 
 #define RAISE_ROOF_EXCEPTION(message) \
   throw RoofNode::roof_exception(     \
@@ -347,6 +350,56 @@ Faces_2_plus_1 vd_inner_faces(const voronoi_diagram& vd, const std::vector<Segme
   return ret;
 }
 
+// roof over an island, i.e. an outline followed by its holes, in fixed point coordinates.
+// Points inside an island are never closer to another island than to its own boundary,
+// so the other islands don't affect its roof.
+std::unique_ptr<PolySet> island_roof(const Clipper2Lib::Paths64& island, double scale,
+                                     const CurveDiscretizer& discretizer)
+{
+  PolySetBuilder roofbuilder;
+
+  std::vector<Segment> segments;
+  for (const auto& path : island) {
+    auto prev = path.back();
+    for (auto p : path) {
+      segments.emplace_back(prev.x, prev.y, p.x, p.y);
+      prev = p;
+    }
+  }
+
+  voronoi_diagram vd;
+  ::boost::polygon::construct_voronoi(segments.begin(), segments.end(), &vd);
+  Faces_2_plus_1 inner_faces = vd_inner_faces(vd, segments, RoofDiscretizer(discretizer, scale));
+
+  for (const std::vector<Vector2d>& face : inner_faces.faces) {
+    if (!(face.size() >= 3)) {
+      RAISE_ROOF_EXCEPTION("Voronoi error");
+    }
+    // convex partition (actually a triangulation - maybe do a proper convex partition later)
+    Polygon2d face_poly;
+    Outline2d outline;
+    outline.vertices.assign(face.begin(), face.end());
+    face_poly.addOutline(outline);
+    auto tess = face_poly.tessellate();
+    for (const IndexedFace& triangle : tess->indices) {
+      std::vector<int> roof;
+      for (int tvind : triangle) {
+        Vector3d tv = tess->vertices[tvind];
+        Vector2d v;
+        v << tv[0], tv[1];
+        if (!(inner_faces.heights.find(v) != inner_faces.heights.end())) {
+          RAISE_ROOF_EXCEPTION("Voronoi error");
+        }
+        roof.push_back(roofbuilder.vertexIndex(
+          Vector3d(v[0] / scale, v[1] / scale, inner_faces.heights[v] / scale)));
+      }
+      roofbuilder.appendPolygon(roof);
+    }
+  }
+
+  return roofbuilder.build();
+}
+
 std::unique_ptr<PolySet> voronoi_diagram_roof(const Polygon2d& poly, const CurveDiscretizer& discretizer)
 {
   PolySetBuilder hatbuilder = PolySetBuilder();
@@ -360,47 +413,18 @@ std::unique_ptr<PolySet> voronoi_diagram_roof(const Polygon2d& poly, const Curve
 
     Clipper2Lib::Paths64 paths = ClipperUtils::fromPolygon2d(poly, scale_bits);
     // sanitize is important e.g. when after converting to 32 bit integers we have double points
-    paths = Clipper2Lib::PolyTreeToPaths64(*ClipperUtils::sanitize(paths));
-    std::vector<Segment> segments;
-
-    for (auto path : paths) {
-      auto prev = path.back();
-      for (auto p : path) {
-        segments.emplace_back(prev.x, prev.y, p.x, p.y);
-        prev = p;
-      }
-    }
-
-    voronoi_diagram vd;
-    ::boost::polygon::construct_voronoi(segments.begin(), segments.end(), &vd);
-    Faces_2_plus_1 inner_faces = vd_inner_faces(vd, segments, RoofDiscretizer(discretizer, scale));
+    const auto polytree = ClipperUtils::sanitize(paths);
+    paths = Clipper2Lib::PolyTreeToPaths64(*polytree);
 
     // roof
-    for (const std::vector<Vector2d>& face : inner_faces.faces) {
-      if (!(face.size() >= 3)) {
-        RAISE_ROOF_EXCEPTION("Voronoi error");
-      }
-      // convex partition (actually a triangulation - maybe do a proper convex partition later)
-      Polygon2d face_poly;
-      Outline2d outline;
-      outline.vertices.assign(face.begin(), face.end());
-      face_poly.addOutline(outline);
-      auto tess = face_poly.tessellate();
-      for (const IndexedFace& triangle : tess->indices) {
-        std::vector<int> roof;
-        for (int tvind : triangle) {
-          Vector3d tv = tess->vertices[tvind];
-          Vector2d v;
-          v << tv[0], tv[1];
-          if (!(inner_faces.heights.find(v) != inner_faces.heights.end())) {
-            RAISE_ROOF_EXCEPTION("Voronoi error");
-          }
-          roof.push_back(hatbuilder.vertexIndex(
-            Vector3d(v[0] / scale, v[1] / scale, inner_faces.heights[v] / scale)));
-        }
-        hatbuilder.appendPolygon(roof);
-      }
-    }
+    std::ostringstream method;
+    method << "voronoi:" << scale_bits << ":" << discretizer;
+    const auto roofs =
+      roof_islands::roofs(roof_islands::islands(*polytree), method.str(),
+                          [scale, &discretizer](const Clipper2Lib::Paths64& island) {
+                            return island_roof(island, scale, discretizer);
+                          });
+    for (const auto& roof : roofs) hatbuilder.appendPolySet(*roof);
 
     // floor
     {
@@ -0,0 +1,231 @@
+#include "geometry/sweep.h"
+
+#include <algorithm>
+#include <boost/logic/tribool.hpp>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "core/SweepNode.h"
+#include "geometry/Geometry.h"
+#include "geometry/GeometryUtils.h"
+#include "geometry/PolySet.h"
+#include "geometry/PolySetBuilder.h"
+#include "geometry/Polygon2d.h"
+#include "geometry/linalg.h"
+#include "geometry/linear_extrude.h"
+#include "glview/RenderSettings.h"
+#include "utils/degree_trig.h"
+#include "utils/parallel.h"
+
+namespace SweepInternals {
+
+std::vector<Matrix3d> rotationMinimizingFrames(const std::vector<Vector3d>& path)
+{
+  assert(path.size() >= 2);
+  const size_t num_segments = path.size() - 1;
+
+  // Along a straight segment a rotation minimizing frame doesn't rotate at all,
+  // so on a polyline it only changes at the corners, by the smallest rotation
+  // taking one segment direction into the next (discrete parallel transport).
+  std::vector<Matrix3d> frames(num_segments);
+  Vector3d t = (path[1] - path[0]).normalized();
+  Vector3d r = Eigen::Quaterniond::FromTwoVectors(Vector3d::UnitZ(), t) * Vector3d::UnitX();
+  for (size_t i = 0; i < num_segments; ++i) {
+    if (i > 0) {
+      const Vector3d t_next = (path[i + 1] - path[i]).normalized();
+      r = Eigen::Quaterniond::FromTwoVectors(t, t_next) * r;
+      // Re-orthonormalize to keep rounding errors from accumulating along long paths
+      r = (r - r.dot(t_next) * t_next).normalized();
+      t = t_next;
+    }
+    frames[i].col(0) = r;
+    frames[i].col(1) = t.cross(r);
+    frames[i].col(2) = t;
+  }
+  return frames;
+}
+
+}  // namespace SweepInternals
+
+using namespace SweepInternals;
+
+namespace {
+
+// Maps 2D profile coordinates onto the plane of a path station.
+// At interior stations the profile is placed using the frame of the incoming segment
+// and then projected along that segment onto the plane bisecting the corner, so
+// consecutive segments meet in a miter joint instead of pinching the profile.
+class StationTransform
+{
+public:
+  StationTransform(const Vector3d& origin, const Matrix3d& frame, const Vector3d& miter_normal,
+                   const Vector2d& scale, double twist)
+    : origin(origin),
+      frame(frame),
+      miter_normal(miter_normal),
+      trans(Eigen::Scaling(scale) * Eigen::Affine2d(rotate_degrees(-twist)))
+  {
+  }
+  [[nodiscard]] Vector3d operator()(const Vector2d& v) const
+  {
+    const Vector2d tmp = trans * v;
+    const Vector3d w = frame.col(0) * tmp[0] + frame.col(1) * tmp[1];
+    return origin + w - frame.col(2) * (w.dot(miter_normal) / frame.col(2).dot(miter_normal));
+  }
+
+private:
+  Vector3d origin;
+  Matrix3d frame;
+  Vector3d miter_normal;
+  Eigen::Affine2d trans;
+};
+
+std::unique_ptr<PolySet> assemblePolySetForCGAL(const Polygon2d& polyref,
+                                                const std::vector<Vector3d>& vertices,
+                                                const PolygonIndices& indices, int convexity,
+                                                boost::tribool isConvex,
+                                                const StationTransform& first,
+                                                const StationTransform& last, bool has_bottom,
+                                                bool has_top)
+{
+  PolySetBuilder builder(0, 0, 3, isConvex);
+  builder.setConvexity(convexity);
+
+  for (const auto& poly : indices) {
+    builder.beginPolygon(poly.size());
+    for (const auto idx : poly) {
+      builder.addVertex(vertices[idx]);
+    }
+  }
+
+  auto placePolySet = [](PolySet& ps, const StationTransform& station) {
+    for (auto& v : ps.vertices) {
+      v = station(Vector2d(v[0], v[1]));
+    }
+  };
+
+  // Create start cap, flipped to face backwards along the path, unless scaled down to zero area
+  if (has_bottom) {
+    auto ps_start = polyref.tessellate();
+    for (auto& p : ps_start->indices) {
+      std::reverse(p.begin(), p.end());
+    }
+    placePolySet(*ps_start, first);
+    builder.appendPolySet(*ps_start);
+  }
+
+  // Create end cap, unless scaled down to zero area
+  if (has_top) {
+    auto ps_end = polyref.tessellate();
+    placePolySet(*ps_end, last);
+    builder.appendPolySet(*ps_end);
+  }
+
+  return builder.build();
+}
+
+}  // namespace
+
+/*!
+   Input to sweep should be sanitized. This means non-intersecting, correct winding order
+   etc., the input coming from a library like Clipper.
+
+   Places one ring of profile vertices at every path station and stitches consecutive
+   rings using the same slice machinery as linear_extrude().
+ */
+std::unique_ptr<Geometry> sweepPolygon(const SweepNode& node, const Polygon2d& poly)
+{
+  assert(poly.isSanitized());
+  if (node.path.size() < 2 || poly.isEmpty()) return PolySet::createEmpty();
+  const auto nonzero = [](const Vector2d& scale) { return scale[0] != 0 && scale[1] != 0; };
+
+  const size_t num_stations = node.path.size();
+  const size_t num_slices = num_stations - 1;
+  assert(node.scale.size() == num_stations && node.twist.size() == num_stations);
+
+  bool non_linear = false;
+  for (size_t i = 0; i < num_stations; ++i) {
+    non_linear |= node.twist[i] != node.twist[0] || node.scale[i][0] != node.scale[i][1];
+  }
+  // Only a single straight, untwisted segment keeps a convex profile convex
+  boost::tribool isConvex = unknown;
+  if (num_slices == 1 && !non_linear) isConvex = poly.is_convex();
+
+  // Like linear_extrude(), add outline vertices if twisting or scaling non-uniformly
+  Polygon2d seg_poly;
+  if (non_linear) {
+    const double twist = node.twist.back() - node.twist.front();
+    for (const auto& o : poly.outlines()) {
+      seg_poly.addOutline(node.discretizer.splitOutline(o, twist, node.scale.back()[0],
+                                                        node.scale.back()[1], num_slices, 0));
+    }
+  }
+  const Polygon2d& polyref = seg_poly.isEmpty() ? poly : seg_poly;
+
+  int slice_stride = 0;
+  for (const auto& o : polyref.outlines()) {
+    slice_stride += o.vertices.size();
+  }
+
+  const auto frames = rotationMinimizingFrames(node.path);
+  std::vector<StationTransform> stations;
+  stations.reserve(num_stations);
+  for (size_t i = 0; i < num_stations; ++i) {
+    const Matrix3d& frame = frames[i == 0 ? 0 : i - 1];
+    Vector3d miter_normal = frame.col(2);
+    if (i > 0 && i < num_slices) {
+      const Vector3d bisector = frame.col(2) + frames[i].col(2);
+      // A path folding back onto itself has no meaningful miter plane
+      if (bisector.squaredNorm() > 1e-12) miter_normal = bisector.normalized();
+    }
+    stations.emplace_back(node.path[i], frame, miter_normal, node.scale[i], node.twist[i]);
+  }
+
+  // Rings are independent of each other, so they can be generated in parallel
+  std::vector<size_t> station_indices(num_stations);
+  std::iota(station_indices.begin(), station_indices.end(), 0);
+  std::vector<std::vector<Vector3d>> rings(num_stations);
+  parallelizable_transform(station_indices.begin(), station_indices.end(), rings.begin(),
+                           [&](size_t station_idx) {
+                             std::vector<Vector3d> ring;
+                             ring.reserve(slice_stride);
+                             for (const auto& o : polyref.outlines()) {
+                               for (const auto& v : o.vertices) {
+                                 ring.push_back(stations[station_idx](v));
+                               }
+                             }
+                             return ring;
+                           });
+
+  std::vector<Vector3d> vertices;
+  vertices.reserve(slice_stride * num_stations);
+  for (const auto& ring : rings) {
+    vertices.insert(vertices.end(), ring.begin(), ring.end());
+  }
+
+  PolygonIndices indices;
+  indices.reserve(slice_stride * num_stations * 2);  // sides + endcaps
+  for (size_t slice_idx = 1; slice_idx <= num_slices; slice_idx++) {
+    LinearExtrudeInternals::add_slice_indices(indices, slice_idx, slice_stride, polyref,
+                                              node.twist[slice_idx - 1], node.twist[slice_idx],
+                                              node.scale[slice_idx - 1], node.scale[slice_idx]);
+  }
+
+#ifdef ENABLE_MANIFOLD
+  if (RenderSettings::inst()->backend3D == RenderBackend3D::ManifoldBackend) {
+    auto ps = LinearExtrudeInternals::assemblePolySetForManifold(
+      polyref, std::move(vertices), std::move(indices), node.convexity, isConvex,
+      slice_stride * num_slices);
+    // Like linear_extrude(), closed by construction unless a station collapses
+    ps->setManifold(std::all_of(node.scale.begin(), node.scale.end(), nonzero));
+    return ps;
+  } else
+#endif
+    return assemblePolySetForCGAL(polyref, vertices, indices, node.convexity, isConvex,
+                                  stations.front(), stations.back(), nonzero(node.scale.front()),
+                                  nonzero(node.scale.back()));
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/SweepNode.h"
+#include "geometry/Geometry.h"
+#include "geometry/Polygon2d.h"
+#include "geometry/linalg.h"
+
+std::unique_ptr<Geometry> sweepPolygon(const SweepNode& node, const Polygon2d& poly);
+
+namespace SweepInternals {
+/**
+ * Rotation minimizing frames for each segment of a polyline.
+ * Each frame has the profile x axis, y axis and segment direction as its columns.
+ * A path along +Z starts with the identity frame, matching linear_extrude().
+ */
+std::vector<Matrix3d> rotationMinimizingFrames(const std::vector<Vector3d>& path);
+}  // namespace SweepInternals
@@ -0,0 +1,138 @@
+#include "geometry/sweep.h"
+
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "core/CurveDiscretizer.h"
+#include "core/ModuleInstantiation.h"
+#include "core/SweepNode.h"
+#include "geometry/PolySet.h"
+#include "geometry/Polygon2d.h"
+#include "geometry/linalg.h"
+#include "glview/RenderSettings.h"
+
+namespace {
+
+const ModuleInstantiation mi("sweep");
+
+// 2x2 square centered on the origin
+Polygon2d square()
+{
+  Outline2d outline;
+  outline.vertices = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+  Polygon2d poly(outline);
+  poly.setSanitized(true);
+  return poly;
+}
+
+SweepNode sweepNode(std::vector<Vector3d> path, std::vector<Vector2d> scale, std::vector<double> twist)
+{
+  SweepNode node(&mi, CurveDiscretizer(32));
+  node.path = std::move(path);
+  node.scale = std::move(scale);
+  node.twist = std::move(twist);
+  return node;
+}
+
+std::unique_ptr<PolySet> sweep(const SweepNode& node, RenderBackend3D backend)
+{
+  const auto previous = RenderSettings::inst()->backend3D;
+  RenderSettings::inst()->backend3D = backend;
+  auto geom = sweepPolygon(node, square());
+  RenderSettings::inst()->backend3D = previous;
+  auto ps = std::unique_ptr<PolySet>(dynamic_cast<PolySet *>(geom.release()));
+  REQUIRE(ps);
+  return ps;
+}
+
+double volume(const PolySet& ps)
+{
+  double volume = 0;
+  for (const auto& polygon : ps.indices) {
+    for (size_t i = 2; i < polygon.size(); ++i) {
+      volume += ps.vertices[polygon[0]].dot(ps.vertices[polygon[i - 1]].cross(ps.vertices[polygon[i]]));
+    }
+  }
+  return volume / 6;
+}
+
+// Number of polygons with all vertices in the plane z = height
+size_t capsAt(const PolySet& ps, double height)
+{
+  size_t caps = 0;
+  for (const auto& polygon : ps.indices) {
+    bool cap = true;
+    for (const auto idx : polygon) cap &= ps.vertices[idx][2] == height;
+    if (cap) ++caps;
+  }
+  return caps;
+}
+
+double maxAbsX(const PolySet& ps, double height)
+{
+  double max = 0;
+  for (const auto& v : ps.vertices) {
+    if (v[2] == height) max = std::max(max, std::abs(v[0]));
+  }
+  return max;
+}
+
+}  // namespace
+
+TEST_CASE("Sweep scales and twists the profile along the path", "[sweep]")
+{
+  const auto node = sweepNode({{0, 0, 0}, {0, 0, 10}}, {{1, 1}, {0.5, 0.5}}, {0, 45});
+  const auto ps = sweep(node, RenderBackend3D::CGALBackend);
+
+  CHECK(maxAbsX(*ps, 0) == Catch::Approx(1));
+  // The corner (0.5, 0.5) rotated by 45 degrees lies on the x axis
+  CHECK(maxAbsX(*ps, 10) == Catch::Approx(0.5 * std::sqrt(2)));
+  CHECK(capsAt(*ps, 0) > 0);
+  CHECK(capsAt(*ps, 10) > 0);
+  CHECK(volume(*ps) > 0);
+}
+
+TEST_CASE("Sweep drops caps scaled down to zero area", "[sweep]")
+{
+  // A pyramid of height 10 on a 2x2 base
+  const double pyramid = 4.0 * 10 / 3;
+  const auto backend = GENERATE(RenderBackend3D::CGALBackend, RenderBackend3D::ManifoldBackend);
+
+  SECTION("Zero scale at the end")
+  {
+    const auto ps = sweep(sweepNode({{0, 0, 0}, {0, 0, 10}}, {{1, 1}, {0, 0}}, {0, 0}), backend);
+    CHECK(volume(*ps) == Catch::Approx(pyramid));
+    CHECK(capsAt(*ps, 0) > 0);
+    if (backend == RenderBackend3D::CGALBackend) CHECK(capsAt(*ps, 10) == 0);
+  }
+
+  SECTION("Zero scale at the start")
+  {
+    const auto ps = sweep(sweepNode({{0, 0, 0}, {0, 0, 10}}, {{0, 0}, {1, 1}}, {0, 0}), backend);
+    CHECK(volume(*ps) == Catch::Approx(pyramid));
+    CHECK(capsAt(*ps, 10) > 0);
+    if (backend == RenderBackend3D::CGALBackend) CHECK(capsAt(*ps, 0) == 0);
+  }
+
+  SECTION("Zero scale at both ends")
+  {
+    const auto ps = sweep(
+      sweepNode({{0, 0, 0}, {0, 0, 10}, {0, 0, 20}}, {{0, 0}, {1, 1}, {0, 0}}, {0, 30, 60}), backend);
+    CHECK(volume(*ps) == Catch::Approx(2 * pyramid));
+    if (backend == RenderBackend3D::CGALBackend) {
+      CHECK(capsAt(*ps, 0) == 0);
+      CHECK(capsAt(*ps, 20) == 0);
+    }
+  }
+
+  SECTION("Zero scale along one axis")
+  {
+    // A wedge with half the volume of the prism
+    const auto ps = sweep(sweepNode({{0, 0, 0}, {0, 0, 10}}, {{1, 0}, {1, 1}}, {0, 0}), backend);
+    CHECK(volume(*ps) == Catch::Approx(20));
+    if (backend == RenderBackend3D::CGALBackend) CHECK(capsAt(*ps, 0) == 0);
+  }
+}
@@ -0,0 +1,317 @@
+#include "glview/PickingBVH.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "geometry/GeometryUtils.h"
+#include "geometry/linalg.h"
+#include "geometry/PolySet.h"
+#include "utils/vector_math.h"
+
+namespace {
+
+constexpr size_t MAX_LEAF_SIZE = 4;
+
+// Whether the line origin + t * dir with t in [tmin, tmax] passes through box
+bool intersects(const BoundingBox& box, const Vector3d& origin, const Vector3d& dir, double tmin,
+                double tmax)
+{
+  for (int i = 0; i < 3; ++i) {
+    if (dir[i] == 0) {
+      if (origin[i] < box.min()[i] || origin[i] > box.max()[i]) return false;
+      continue;
+    }
+    double t1 = (box.min()[i] - origin[i]) / dir[i];
+    double t2 = (box.max()[i] - origin[i]) / dir[i];
+    if (t1 > t2) std::swap(t1, t2);
+    tmin = std::max(tmin, t1);
+    tmax = std::min(tmax, t2);
+    if (tmin > tmax) return false;
+  }
+  return true;
+}
+
+BoundingBox expanded(const BoundingBox& box, double tolerance)
+{
+  return {box.min() - Vector3d::Constant(tolerance), box.max() + Vector3d::Constant(tolerance)};
+}
+
+// Distance along dir from origin to where the ray hits the planar polygon, if it does
+std::optional<double> intersectPolygon(const std::vector<Vector3d>& vertices, const IndexedFace& face,
+                                       const Vector3d& origin, const Vector3d& dir)
+{
+  // Newell's method gives a robust normal for non-convex polygons as well
+  Vector3d normal = Vector3d::Zero();
+  for (size_t i = 0; i < face.size(); ++i) {
+    const Vector3d& a = vertices[face[i]];
+    const Vector3d& b = vertices[face[(i + 1) % face.size()]];
+    normal += (a - b).cross(a + b);
+  }
+  const double denom = normal.dot(dir);
+  if (std::fabs(denom) < std::numeric_limits<double>::epsilon() * normal.norm()) return {};
+  const double t = normal.dot(vertices[face[0]] - origin) / denom;
+  if (t < 0) return {};
+  const Vector3d hit = origin + t * dir;
+
+  // Crossing test in the coordinate plane the polygon is least foreshortened in
+  int axis;
+  normal.cwiseAbs().maxCoeff(&axis);
+  const int u = (axis + 1) % 3;
+  const int v = (axis + 2) % 3;
+  bool inside = false;
+  for (size_t i = 0, j = face.size() - 1; i < face.size(); j = i++) {
+    const Vector3d& a = vertices[face[i]];
+    const Vector3d& b = vertices[face[j]];
+    if ((a[v] > hit[v]) != (b[v] > hit[v]) &&
+        hit[u] < (b[u] - a[u]) * (hit[v] - a[v]) / (b[v] - a[v]) + a[u]) {
+      inside = !inside;
+    }
+  }
+  if (!inside) return {};
+  return t;
+}
+
+}  // namespace
+
+void PickingBVH::Tree::build(const std::vector<BoundingBox>& boxes)
+{
+  nodes.clear();
+  items.resize(boxes.size());
+  for (size_t i = 0; i < items.size(); ++i) items[i] = i;
+  if (boxes.empty()) return;
+  std::vector<Vector3d> centers;
+  centers.reserve(boxes.size());
+  for (const auto& box : boxes) centers.push_back(box.center());
+  nodes.reserve(2 * boxes.size() / MAX_LEAF_SIZE + 1);
+  build(boxes, centers, 0, items.size());
+}
+
+size_t PickingBVH::Tree::build(const std::vector<BoundingBox>& boxes,
+                               const std::vector<Vector3d>& centers, size_t begin, size_t end)
+{
+  const size_t idx = nodes.size();
+  nodes.push_back({.box = BoundingBox(), .first = begin, .count = end - begin});
+  BoundingBox center_box;
+  for (size_t i = begin; i < end; ++i) {
+    nodes[idx].box.extend(boxes[items[i]]);
+    center_box.extend(centers[items[i]]);
+  }
+  if (end - begin <= MAX_LEAF_SIZE) return idx;
+
+  // Median split along the longest extent of the centers keeps the tree balanced
+  int axis;
+  center_box.sizes().maxCoeff(&axis);
+  const size_t mid = begin + (end - begin) / 2;
+  std::nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end,
+                   [&](size_t a, size_t b) { return centers[a][axis] < centers[b][axis]; });
+  nodes[idx].count = 0;
+  build(boxes, centers, begin, mid);
+  const size_t second = build(boxes, centers, mid, end);
+  nodes[idx].first = second;
+  return idx;
+}
+
+template <class Test, class Visit>
+void PickingBVH::Tree::query(const Test& test, const Visit& visit) const
+{
+  if (nodes.empty()) return;
+  std::vector<size_t> stack{0};
+  while (!stack.empty()) {
+    const Node& node = nodes[stack.back()];
+    const size_t idx = stack.back();
+    stack.pop_back();
+    if (!test(node.box)) continue;
+    if (node.count == 0) {
+      stack.push_back(node.first);
+      stack.push_back(idx + 1);
+    } else {
+      for (size_t i = node.first; i < node.first + node.count; ++i) visit(items[i]);
+    }
+  }
+}
+
+PickingBVH::PickingBVH(std::vector<std::shared_ptr<const PolySet>> polysets_)
+  : polysets(std::move(polysets_))
+{
+  std::vector<BoundingBox> boxes;
+  for (size_t p = 0; p < polysets.size(); ++p) {
+    const auto& ps = *polysets[p];
+    for (size_t i = 0; i < ps.vertices.size(); ++i) {
+      vertices.emplace_back(p, i);
+      boxes.emplace_back(ps.vertices[i], ps.vertices[i]);
+    }
+  }
+  vertex_tree.build(boxes);
+
+  boxes.clear();
+  for (size_t p = 0; p < polysets.size(); ++p) {
+    const auto& ps = *polysets[p];
+    for (const auto& pol : ps.indices) {
+      for (size_t i = 0; i < pol.size(); ++i) {
+        const size_t v1 = pol[i];
+        const size_t v2 = pol[(i + 1) % pol.size()];
+        edges.push_back({.polyset = p, .v1 = v1, .v2 = v2});
+        BoundingBox box(ps.vertices[v1], ps.vertices[v1]);
+        box.extend(ps.vertices[v2]);
+        boxes.push_back(box);
+      }
+    }
+  }
+  edge_tree.build(boxes);
+
+  boxes.clear();
+  for (size_t p = 0; p < polysets.size(); ++p) {
+    const auto& ps = *polysets[p];
+    for (size_t i = 0; i < ps.indices.size(); ++i) {
+      if (ps.indices[i].size() < 3) continue;
+      faces.emplace_back(p, i);
+      BoundingBox box;
+      for (const auto idx : ps.indices[i]) box.extend(ps.vertices[idx]);
+      boxes.push_back(box);
+    }
+  }
+  face_tree.build(boxes);
+}
+
+std::optional<Vector3d> PickingBVH::findVertex(const Vector3d& near_pt, const Vector3d& far_pt,
+                                               double tolerance) const
+{
+  const Vector3d dir = far_pt - near_pt;
+  std::optional<size_t> nearest;
+  double dist_nearest = 0;
+  vertex_tree.query(
+    [&](const BoundingBox& box) {
+      return intersects(expanded(box, tolerance), near_pt, dir, 0.0, 1.0);
+    },
+    [&](size_t item) {
+      const auto& [p, i] = vertices[item];
+      double dist_near;
+      const double dist_pt =
+        calculateLinePointDistance(near_pt, far_pt, polysets[p]->vertices[i], dist_near);
+      if (dist_pt < tolerance &&
+          (!nearest || dist_near < dist_nearest || (dist_near == dist_nearest && item < *nearest))) {
+        nearest = item;
+        dist_nearest = dist_near;
+      }
+    });
+  if (!nearest) return {};
+  const auto& [p, i] = vertices[*nearest];
+  return polysets[p]->vertices[i];
+}
+
+std::optional<std::pair<Vector3d, Vector3d>> PickingBVH::findEdge(const Vector3d& near_pt,
+                                                                  const Vector3d& far_pt,
+                                                                  double tolerance) const
+{
+  const Vector3d dir = far_pt - near_pt;
+  const double inf = std::numeric_limits<double>::infinity();
+  std::optional<size_t> last;
+  edge_tree.query(
+    [&](const BoundingBox& box) {
+      return intersects(expanded(box, tolerance), near_pt, dir, -inf, inf);
+    },
+    [&](size_t item) {
+      if (last && item < *last) return;
+      const auto& edge = edges[item];
+      const auto& points = polysets[edge.polyset]->vertices;
+      double parametric_t;
+      const double dist_norm = std::fabs(
+        calculateLineLineDistance(points[edge.v1], points[edge.v2], near_pt, far_pt, parametric_t));
+      if (parametric_t >= 0 && parametric_t <= 1 && dist_norm < tolerance) last = item;
+    });
+  if (!last) return {};
+  const auto& edge = edges[*last];
+  const auto& points = polysets[edge.polyset]->vertices;
+  return std::make_pair(points[edge.v1], points[edge.v2]);
+}
+
+std::optional<PickingBVH::FaceHit> PickingBVH::findFace(const Vector3d& near_pt,
+                                                        const Vector3d& far_pt) const
+{
+  const Vector3d dir = (far_pt - near_pt).normalized();
+  std::optional<size_t> nearest;
+  double dist_nearest = 0;
+  // Boxes further away than the nearest hit so far can't contain a nearer one
+  face_tree.query(
+    [&](const BoundingBox& box) {
+      return intersects(box, near_pt, dir, 0.0,
+                        nearest ? dist_nearest : std::numeric_limits<double>::infinity());
+    },
+    [&](size_t item) {
+      const auto& [p, i] = faces[item];
+      const auto t = intersectPolygon(polysets[p]->vertices, polysets[p]->indices[i], near_pt, dir);
+      if (t && (!nearest || *t < dist_nearest || (*t == dist_nearest && item < *nearest))) {
+        nearest = item;
+        dist_nearest = *t;
+      }
+    });
+  if (!nearest) return {};
+  const auto& [p, i] = faces[*nearest];
+  return FaceHit{
+    .polyset = p, .polygon = i, .distance = dist_nearest, .point = near_pt + dist_nearest * dir};
+}
+
+std::optional<Vector3d> PickingBVH::scanVertex(
+  const std::vector<std::shared_ptr<const PolySet>>& polysets, const Vector3d& near_pt,
+  const Vector3d& far_pt, double tolerance)
+{
+  std::optional<Vector3d> nearest;
+  double dist_nearest = 0;
+  for (const auto& ps : polysets) {
+    for (const auto& pt : ps->vertices) {
+      double dist_near;
+      const double dist_pt = calculateLinePointDistance(near_pt, far_pt, pt, dist_near);
+      if (dist_pt < tolerance && (!nearest || dist_near < dist_nearest)) {
+        dist_nearest = dist_near;
+        nearest = pt;
+      }
+    }
+  }
+  return nearest;
+}
+
+std::optional<std::pair<Vector3d, Vector3d>> PickingBVH::scanEdge(
+  const std::vector<std::shared_ptr<const PolySet>>& polysets, const Vector3d& near_pt,
+  const Vector3d& far_pt, double tolerance)
+{
+  std::optional<std::pair<Vector3d, Vector3d>> last;
+  for (const auto& ps : polysets) {
+    for (const auto& pol : ps->indices) {
+      const size_t n = pol.size();
+      for (size_t i = 0; i < n; ++i) {
+        const Vector3d& p1 = ps->vertices[pol[i]];
+        const Vector3d& p2 = ps->vertices[pol[(i + 1) % n]];
+        double parametric_t;
+        const double dist_norm =
+          std::fabs(calculateLineLineDistance(p1, p2, near_pt, far_pt, parametric_t));
+        if (parametric_t >= 0 && parametric_t <= 1 && dist_norm < tolerance) last = {p1, p2};
+      }
+    }
+  }
+  return last;
+}
+
+std::optional<PickingBVH::FaceHit> PickingBVH::scanFace(
+  const std::vector<std::shared_ptr<const PolySet>>& polysets, const Vector3d& near_pt,
+  const Vector3d& far_pt)
+{
+  const Vector3d dir = (far_pt - near_pt).normalized();
+  std::optional<FaceHit> nearest;
+  for (size_t p = 0; p < polysets.size(); ++p) {
+    const auto& ps = *polysets[p];
+    for (size_t i = 0; i < ps.indices.size(); ++i) {
+      if (ps.indices[i].size() < 3) continue;
+      const auto t = intersectPolygon(ps.vertices, ps.indices[i], near_pt, dir);
+      if (t && (!nearest || *t < nearest->distance)) {
+        nearest = FaceHit{.polyset = p, .polygon = i, .distance = *t, .point = near_pt + *t * dir};
+      }
+    }
+  }
+  return nearest;
+}
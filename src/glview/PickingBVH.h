@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "geometry/linalg.h"
+#include "geometry/PolySet.h"
+
+/*!
+   Bounding volume hierarchies over the vertices, edges and faces of a set of PolySets,
+   answering the picking queries of the measurement tool without visiting every primitive.
+
+   Queries return the same objects as a linear scan in PolySet order would: the vertex
+   nearest to near_pt (the first one on ties), the last matching edge, and the nearest face
+   hit (the first one on ties).
+ */
+class PickingBVH
+{
+public:
+  PickingBVH(std::vector<std::shared_ptr<const PolySet>> polysets);
+
+  struct FaceHit {
+    size_t polyset;
+    size_t polygon;
+    // Distance of the hit from near_pt
+    double distance;
+    Vector3d point;
+  };
+
+  // Vertex within tolerance of the segment near_pt-far_pt, closest to near_pt
+  [[nodiscard]] std::optional<Vector3d> findVertex(const Vector3d& near_pt, const Vector3d& far_pt,
+                                                   double tolerance) const;
+  // Edge passing within tolerance of the line through near_pt and far_pt
+  [[nodiscard]] std::optional<std::pair<Vector3d, Vector3d>> findEdge(const Vector3d& near_pt,
+                                                                      const Vector3d& far_pt,
+                                                                      double tolerance) const;
+  // First face hit by the ray from near_pt towards far_pt
+  [[nodiscard]] std::optional<FaceHit> findFace(const Vector3d& near_pt, const Vector3d& far_pt) const;
+
+  // The same queries as a linear scan over all primitives, for use until a PickingBVH is built
+  static std::optional<Vector3d> scanVertex(const std::vector<std::shared_ptr<const PolySet>>& polysets,
+                                            const Vector3d& near_pt, const Vector3d& far_pt,
+                                            double tolerance);
+  static std::optional<std::pair<Vector3d, Vector3d>> scanEdge(
+    const std::vector<std::shared_ptr<const PolySet>>& polysets, const Vector3d& near_pt,
+    const Vector3d& far_pt, double tolerance);
+  static std::optional<FaceHit> scanFace(const std::vector<std::shared_ptr<const PolySet>>& polysets,
+                                         const Vector3d& near_pt, const Vector3d& far_pt);
+
+private:
+  // Primitives are only referenced by index, so one tree type serves all of them
+  class Tree
+  {
+  public:
+    void build(const std::vector<BoundingBox>& boxes);
+    // Calls visit() for all items in leaves whose boxes pass test()
+    template <class Test, class Visit>
+    void query(const Test& test, const Visit& visit) const;
+
+  private:
+    struct Node {
+      BoundingBox box;
+      // Leaves hold items [first, first + count), inner nodes have count == 0, their
+      // first child directly following them and the second one at index first.
+      size_t first;
+      size_t count;
+    };
+    size_t build(const std::vector<BoundingBox>& boxes, const std::vector<Vector3d>& centers,
+                 size_t begin, size_t end);
+
+    std::vector<Node> nodes;
+    std::vector<size_t> items;
+  };
+
+  struct Edge {
+    size_t polyset;
+    size_t v1;
+    size_t v2;
+  };
+
+  std::vector<std::shared_ptr<const PolySet>> polysets;
+  // Primitives in the order of a linear scan, which decides between equally good picks
+  std::vector<std::pair<size_t, size_t>> vertices;
+  std::vector<Edge> edges;
+  std::vector<std::pair<size_t, size_t>> faces;
+  Tree vertex_tree;
+  Tree edge_tree;
+  Tree face_tree;
+};
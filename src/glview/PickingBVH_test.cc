@@ -0,0 +1,124 @@
+#include "glview/PickingBVH.h"
+
+#include <catch2/catch_all.hpp>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "geometry/PolySet.h"
+#include "geometry/linalg.h"
+
+namespace {
+
+// A grid of quads on a randomly displaced height field, so many vertices and edges are close
+// to any ray and ties between equally near picks are likely. The quads aren't planar, so face
+// picking needs them split into triangles.
+std::shared_ptr<const PolySet> heightField(std::mt19937& rng, int size, double z, bool triangles = false)
+{
+  std::uniform_int_distribution<int> height(0, 3);
+  auto ps = std::make_shared<PolySet>(3);
+  for (int y = 0; y <= size; ++y) {
+    for (int x = 0; x <= size; ++x) ps->vertices.emplace_back(x, y, z + 0.5 * height(rng));
+  }
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      const int i = y * (size + 1) + x;
+      if (triangles) {
+        ps->indices.push_back({i, i + 1, i + size + 2});
+        ps->indices.push_back({i, i + size + 2, i + size + 1});
+      } else {
+        ps->indices.push_back({i, i + 1, i + size + 2, i + size + 1});
+      }
+    }
+  }
+  return ps;
+}
+
+}  // namespace
+
+TEST_CASE("PickingBVH picks the same objects as a linear scan", "[picking]")
+{
+  std::mt19937 rng(42);
+  const std::vector<std::shared_ptr<const PolySet>> polysets = {heightField(rng, 12, 0),
+                                                                heightField(rng, 8, 5)};
+  const PickingBVH bvh(polysets);
+
+  std::uniform_real_distribution<double> coord(-2, 14);
+  std::uniform_int_distribution<int> grid(0, 12);
+  const double tolerance = GENERATE(0.01, 0.2, 1.0);
+  size_t vertex_picks = 0;
+  size_t edge_picks = 0;
+  for (int i = 0; i < 500; ++i) {
+    Vector3d near_pt(coord(rng), coord(rng), 20);
+    Vector3d far_pt(coord(rng), coord(rng), -20);
+    if (i % 2) {
+      // Straight down through a grid point, hitting vertices of both polysets
+      near_pt = Vector3d(grid(rng), grid(rng), 20);
+      far_pt = near_pt - Vector3d(0, 0, 40);
+    }
+
+    const auto expected_vertex = PickingBVH::scanVertex(polysets, near_pt, far_pt, tolerance);
+    const auto vertex = bvh.findVertex(near_pt, far_pt, tolerance);
+    REQUIRE(vertex.has_value() == expected_vertex.has_value());
+    if (vertex) {
+      CHECK(*vertex == *expected_vertex);
+      ++vertex_picks;
+    }
+
+    const auto expected_edge = PickingBVH::scanEdge(polysets, near_pt, far_pt, tolerance);
+    const auto edge = bvh.findEdge(near_pt, far_pt, tolerance);
+    REQUIRE(edge.has_value() == expected_edge.has_value());
+    if (edge) {
+      CHECK(edge->first == expected_edge->first);
+      CHECK(edge->second == expected_edge->second);
+      ++edge_picks;
+    }
+  }
+  // Make sure both kinds of queries were exercised
+  CHECK(vertex_picks > 0);
+  CHECK(edge_picks > 0);
+}
+
+TEST_CASE("PickingBVH picks the same faces as a linear scan", "[picking]")
+{
+  std::mt19937 rng(42);
+  const std::vector<std::shared_ptr<const PolySet>> polysets = {heightField(rng, 12, 0, true),
+                                                                heightField(rng, 8, 5, true)};
+  const PickingBVH bvh(polysets);
+
+  std::uniform_real_distribution<double> coord(-2, 14);
+  std::uniform_int_distribution<int> grid(0, 12);
+  size_t face_picks = 0;
+  for (int i = 0; i < 500; ++i) {
+    Vector3d near_pt(coord(rng), coord(rng), 20);
+    Vector3d far_pt(coord(rng), coord(rng), -20);
+    if (i % 2) {
+      // Straight down through a grid point, where several faces meet
+      near_pt = Vector3d(grid(rng), grid(rng), 20);
+      far_pt = near_pt - Vector3d(0, 0, 40);
+    }
+    if (i % 5 == 0) std::swap(near_pt, far_pt);  // From below
+
+    const auto expected = PickingBVH::scanFace(polysets, near_pt, far_pt);
+    const auto face = bvh.findFace(near_pt, far_pt);
+    REQUIRE(face.has_value() == expected.has_value());
+    if (face) {
+      CHECK(face->polyset == expected->polyset);
+      CHECK(face->polygon == expected->polygon);
+      CHECK(face->distance == expected->distance);
+      CHECK(face->point == expected->point);
+      ++face_picks;
+    }
+  }
+  CHECK(face_picks > 0);
+}
+
+TEST_CASE("PickingBVH handles empty input", "[picking]")
+{
+  const PickingBVH bvh({});
+  CHECK_FALSE(bvh.findVertex({0, 0, 1}, {0, 0, -1}, 1));
+  CHECK_FALSE(bvh.findEdge({0, 0, 1}, {0, 0, -1}, 1));
+  CHECK_FALSE(bvh.findFace({0, 0, 1}, {0, 0, -1}));
+}
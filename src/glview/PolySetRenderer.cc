@@ -27,8 +27,12 @@
 #include "PolySetRenderer.h"
 
 #include <cassert>
-#include <cmath>
+#include <chrono>
 #include <cstddef>
+#include <exception>
+#include <future>
+#include <system_error>
+#include <thread>
 #include <utility>
 #include <memory>
 #include <vector>
@@ -46,12 +50,12 @@
 #include "geometry/PolySet.h"
 #include "geometry/PolySetUtils.h"
 #include "glview/ColorMap.h"
+#include "glview/PickingBVH.h"
 #include "glview/VBORenderer.h"
 #include "glview/Renderer.h"
 #include "glview/ShaderUtils.h"
 #include "glview/VBOBuilder.h"
 #include "glview/VertexState.h"
-#include "utils/vector_math.h"
 
 #ifdef ENABLE_CGAL
 #include "geometry/cgal/CGALNefGeometry.h"
@@ -305,67 +309,41 @@ std::vector<SelectedObject> PolySetRenderer::findModelObject(const Vector3d& nea
                                                              const Vector3d& far_pt, int /*mouse_x*/,
                                                              int /*mouse_y*/, double tolerance)
 {
-  std::vector<SelectedObject> results;
-  double dist_nearest = NAN;
-  Vector3d pt1_nearest;
-  Vector3d pt2_nearest;
-
-  // This only considers vertices near the line containing near_pt and far_pt, and chooses either the
-  // first one it iterates past which is on the near side of `near_pt` (due to clamping of dist_near) or
-  // the one with the closest tangent intersection to `near_pt`, if none are on the near side.
-  for (const auto& ps : this->polysets_) {
-    for (const auto& pt : ps->vertices) {
-      double dist_near;
-      const double dist_pt = calculateLinePointDistance(near_pt, far_pt, pt, dist_near);
-      if (dist_pt < tolerance) {
-        if (isnan(dist_nearest) || dist_near < dist_nearest) {
-          dist_nearest = dist_near;
-          pt1_nearest = pt;
-        }
-      }
+  if (!picking_bvh_.valid()) {
+    // Built on a detached thread, so neither hovering nor destroying the renderer waits for it
+    std::packaged_task<std::shared_ptr<const PickingBVH>()> task(
+      [polysets = this->polysets_]() { return std::make_shared<const PickingBVH>(polysets); });
+    picking_bvh_ = task.get_future().share();
+    try {
+      std::thread(std::move(task)).detach();
+    } catch (const std::system_error&) {
+      // The task is gone, so the future holds a broken_promise error handled below
     }
   }
-  if (!isnan(dist_nearest)) {
-    // We found an acceptable vertex.
-    const SelectedObject obj = {
-      .type = SelectionType::SELECTION_POINT,
-      .p1 = pt1_nearest,
-    };
-    results.push_back(obj);
-    return results;
-  }
-  for (const std::shared_ptr<const PolySet>& ps : this->polysets_) {
-    for (const auto& pol : ps->indices) {
-      const int n = pol.size();
-      for (int i = 0; i < n; i++) {
-        const int ind1 = pol[i];
-        const int ind2 = pol[(i + 1) % n];
-        double parametric_t;
-        const double dist_norm = std::fabs(calculateLineLineDistance(
-          ps->vertices[ind1], ps->vertices[ind2], near_pt, far_pt, parametric_t));
-        if (parametric_t >= 0 && parametric_t <= 1 && dist_norm < tolerance) {
-          // The closest point falls on the line segment from
-          // ps->vertices[ind1] to ps->vertices[ind2],
-          // and it's less than tolerance away.
-          dist_nearest = parametric_t;
-          pt1_nearest = ps->vertices[ind1];
-          pt2_nearest = ps->vertices[ind2];
-          // I don't know why we don't break out of the top for loop.
-          // Is there anything special about picking the last answer instead of the first?
-        }
-      }
+  std::shared_ptr<const PickingBVH> bvh;
+  if (picking_bvh_.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+    try {
+      bvh = picking_bvh_.get();
+    } catch (const std::exception& e) {
+      LOG(message_group::Warning, "Picking without acceleration structure: %1$s", e.what());
+      // Don't retry, keep scanning all vertices and edges from now on
+      std::promise<std::shared_ptr<const PickingBVH>> failed;
+      failed.set_value(nullptr);
+      picking_bvh_ = failed.get_future().share();
     }
   }
 
-  if (!isnan(dist_nearest)) {
-    // We found an acceptable line segment.
-    const SelectedObject obj = {
-      .type = SelectionType::SELECTION_LINE,
-      .p1 = pt1_nearest,
-      .p2 = pt2_nearest,
-    };
-    results.push_back(obj);
+  std::vector<SelectedObject> results;
+  const auto pt = bvh ? bvh->findVertex(near_pt, far_pt, tolerance)
+                      : PickingBVH::scanVertex(this->polysets_, near_pt, far_pt, tolerance);
+  if (pt) {
+    results.push_back({.type = SelectionType::SELECTION_POINT, .p1 = *pt});
     return results;
   }
+  const auto edge = bvh ? bvh->findEdge(near_pt, far_pt, tolerance)
+                        : PickingBVH::scanEdge(this->polysets_, near_pt, far_pt, tolerance);
+  if (edge) {
+    results.push_back({.type = SelectionType::SELECTION_LINE, .p1 = edge->first, .p2 = edge->second});
+  }
   return results;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <future>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -10,6 +11,7 @@
 #include "geometry/Polygon2d.h"
 #include "geometry/PolySet.h"
 #include "glview/ColorMap.h"
+#include "glview/PickingBVH.h"
 #include "glview/ShaderUtils.h"
 #include "glview/VertexState.h"
 #include "glview/VBORenderer.h"
@@ -29,6 +31,8 @@ public:
    * and closest to near_pt. Mostly that's true, but line segment searching seems a little whack. And if
    * there's any points "behind" near_pt but on the near_pt<->far_pt infinite line, which is chosen is
    * likely non-optimal.
+   * The first call starts building a PickingBVH in the background; until it is ready,
+   * or if building it fails, all vertices and edges are scanned.
    */
   std::vector<SelectedObject> findModelObject(const Vector3d& near_pt, const Vector3d& far_pt,
                                               int mouse_x, int mouse_y, double tolerance) override;
@@ -48,4 +52,6 @@ private:
 
   std::vector<VertexStateContainer> polyset_vertex_state_containers_;
   std::vector<VertexStateContainer> polygon_vertex_state_containers_;
+
+  std::shared_future<std::shared_ptr<const PickingBVH>> picking_bvh_;
 };
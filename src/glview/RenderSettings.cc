@@ -39,6 +39,7 @@ RenderSettings::RenderSettings()
 {
   backend3D = DEFAULT_RENDERING_BACKEND_3D;
   openCSGTermLimit = 100000;
+  previewMaxSegments = 0;
   far_gl_clip_limit = 100000.0;
   colorscheme = "Cornfield";
 }
@@ -21,6 +21,8 @@ public:
 
   RenderBackend3D backend3D;
   unsigned int openCSGTermLimit;
+  // Upper bound for segments per full circle while previewing, 0 for no limit
+  unsigned int previewMaxSegments;
   double far_gl_clip_limit;
   std::string colorscheme;
 
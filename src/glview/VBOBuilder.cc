@@ -8,12 +8,18 @@
 #include <utility>
 #include <vector>
 #include <memory>
+#include <optional>
 #include <cstdio>
+#include <ios>
+#include <sstream>
+#include <string>
 
+#include "SharedCache.h"
 #include "geometry/linalg.h"
 #include "geometry/Polygon2d.h"
 #include "utils/printutils.h"
 #include "utils/hash.h"  // IWYU pragma: keep
+#include "utils/parallel.h"
 
 namespace {
 
@@ -31,6 +37,133 @@ Vector3d uniqueMultiply(std::unordered_map<Vector3d, Vector3d>& vert_mult_map, c
   return entry->second;
 }
 
+// Calls emit(face, p0, p1, p2, primitive_index, shape_size) for each triangle the polygons of ps
+// are split into, with the vertices transformed by m.
+template <typename Emit>
+void forEachSurfaceTriangle(const PolySet& ps, const Transform3d& m, const Emit& emit)
+{
+  std::unordered_map<Vector3d, Vector3d> vert_mult_map;
+
+  for (size_t i = 0, n = ps.indices.size(); i < n; i++) {
+    const auto& poly = ps.indices[i];
+    if (poly.size() == 3) {
+      const Vector3d p0 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(0)], m);
+      const Vector3d p1 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(1)], m);
+      const Vector3d p2 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(2)], m);
+
+      emit(i, p0, p1, p2, 0, poly.size());
+    } else if (poly.size() == 4) {
+      const Vector3d p0 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(0)], m);
+      const Vector3d p1 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(1)], m);
+      const Vector3d p2 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(2)], m);
+      const Vector3d p3 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(3)], m);
+
+      emit(i, p0, p1, p3, 0, poly.size());
+      emit(i, p2, p3, p1, 1, poly.size());
+    } else {
+      Vector3d center = Vector3d::Zero();
+      for (const auto& idx : poly) {
+        center += ps.vertices[idx];
+      }
+      center /= poly.size();
+      for (size_t j = 1; j <= poly.size(); j++) {
+        const Vector3d p0 = uniqueMultiply(vert_mult_map, center, m);
+        const Vector3d p1 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(j % poly.size())], m);
+        const Vector3d p2 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(j - 1)], m);
+
+        emit(i, p0, p2, p1, j - 1, poly.size());
+      }
+    }
+  }
+}
+
+// Number of vertices forEachSurfaceTriangle() emits for ps
+size_t surfaceVertexCount(const PolySet& ps)
+{
+  size_t count = 0;
+  for (const auto& poly : ps.indices) {
+    count += poly.size() == 3 ? 3 : poly.size() == 4 ? 6 : 3 * poly.size();
+  }
+  return count;
+}
+
+const Color4f& faceColor(const PolySet& ps, size_t face, const Color4f& default_color,
+                         bool force_default_color)
+{
+  const bool has_colors = !ps.color_indices.empty();
+  const size_t color_index = has_colors && face < ps.color_indices.size() ? ps.color_indices[face] : -1;
+  return !force_default_color && color_index >= 0 && color_index < ps.colors.size() &&
+             ps.colors[color_index].isValid()
+           ? ps.colors[color_index]
+           : default_color;
+}
+
+Vector3d triangleNormal(const Vector3d& p0, const Vector3d& p1, const Vector3d& p2)
+{
+  const double ax = p1[0] - p0[0], bx = p1[0] - p2[0];
+  const double ay = p1[1] - p0[1], by = p1[1] - p2[1];
+  const double az = p1[2] - p0[2], bz = p1[2] - p2[2];
+  const double nx = ay * bz - az * by;
+  const double ny = az * bx - ax * bz;
+  const double nz = ax * by - ay * bx;
+  const double nl = sqrt(nx * nx + ny * ny + nz * nz);
+  return {nx / nl, ny / nl, nz / nl};
+}
+
+std::array<GLubyte, 3> barycentricFlags(size_t active_point_index, size_t primitive_index,
+                                        size_t shape_size, bool outlines)
+{
+  // Get edge states
+  std::array<GLubyte, 3> barycentric_flags;
+
+  if (!outlines) {
+    // top / bottom or 3d object
+    if (shape_size == 3) {
+      // true, true, true
+      barycentric_flags = {0, 0, 0};
+    } else if (shape_size == 4) {
+      // false, true, true
+      barycentric_flags = {1, 0, 0};
+    } else {
+      // true, false, false
+      barycentric_flags = {0, 1, 1};
+    }
+  } else {
+    // sides
+    if (primitive_index == 0) {
+      // true, false, true
+      barycentric_flags = {0, 1, 0};
+    } else {
+      // true, true, false
+      barycentric_flags = {0, 0, 1};
+    }
+  }
+
+  barycentric_flags[active_point_index] = 1;
+  return barycentric_flags;
+}
+
+template <typename T, size_t N>
+void writeAttribute(GLbyte *dst, const std::array<T, N>& values)
+{
+  std::memcpy(dst, values.data(), sizeof(values));
+}
+
+bool hasAttribute(const std::shared_ptr<IAttributeData>& data, GLenum type, size_t count)
+{
+  return data && data->glType() == type && data->count() == count;
+}
+
+// Interleaved vertex data of previously written surfaces. The key contains the address of
+// the PolySet, which may be reused once it's freed, so entries only hold a weak reference
+// to it and are only used while it refers to the same PolySet.
+struct SurfaceCacheEntry {
+  std::weak_ptr<const PolySet> ps;
+  std::shared_ptr<const std::vector<GLbyte>> data;
+};
+
+SharedCache<std::string, SurfaceCacheEntry> surface_cache(128ul * 1024ul * 1024ul);
+
 }  // namespace
 
 void addAttributeValues(IAttributeData&)
@@ -148,6 +281,8 @@ void VBOBuilder::createVertex(const std::array<Vector3d, 3>& points,
 
 void VBOBuilder::createInterleavedVBOs()
 {
+  writeDeferredSurfaces({this});
+
   for (const auto& state : vertex_state_container_.states()) {
     state->setDrawOffset(this->indexOffset(state->drawOffset()));
   }
@@ -353,34 +488,8 @@ void VBOBuilder::add_barycentric_attribute(size_t active_point_index, size_t pri
                                            size_t shape_size, bool outlines)
 {
   const std::shared_ptr<VertexData> vertex_data = data();
-
-  // Get edge states
-  std::array<GLubyte, 3> barycentric_flags;
-
-  if (!outlines) {
-    // top / bottom or 3d object
-    if (shape_size == 3) {
-      // true, true, true
-      barycentric_flags = {0, 0, 0};
-    } else if (shape_size == 4) {
-      // false, true, true
-      barycentric_flags = {1, 0, 0};
-    } else {
-      // true, false, false
-      barycentric_flags = {0, 1, 1};
-    }
-  } else {
-    // sides
-    if (primitive_index == 0) {
-      // true, false, true
-      barycentric_flags = {0, 1, 0};
-    } else {
-      // true, true, false
-      barycentric_flags = {0, 0, 1};
-    }
-  }
-
-  barycentric_flags[active_point_index] = 1;
+  const auto barycentric_flags =
+    barycentricFlags(active_point_index, primitive_index, shape_size, outlines);
 
   addAttributeValues(*(vertex_data->attributes()[shader_attributes_index_ + BARYCENTRIC_ATTRIB]),
                      barycentric_flags[0], barycentric_flags[1], barycentric_flags[2], 0);
@@ -390,14 +499,7 @@ void VBOBuilder::create_triangle(const Color4f& color, const Vector3d& p0, const
                                  const Vector3d& p2, size_t primitive_index, size_t shape_size,
                                  bool outlines, bool enable_barycentric, bool mirror)
 {
-  const double ax = p1[0] - p0[0], bx = p1[0] - p2[0];
-  const double ay = p1[1] - p0[1], by = p1[1] - p2[1];
-  const double az = p1[2] - p0[2], bz = p1[2] - p2[2];
-  const double nx = ay * bz - az * by;
-  const double ny = az * bx - ax * bz;
-  const double nz = ax * by - ay * bx;
-  const double nl = sqrt(nx * nx + ny * ny + nz * nz);
-  const Vector3d n = Vector3d(nx / nl, ny / nl, nz / nl);
+  const Vector3d n = triangleNormal(p0, p1, p2);
 
   if (!data()) return;
 
@@ -424,11 +526,157 @@ void VBOBuilder::create_triangle(const Color4f& color, const Vector3d& p0, const
   }
 }
 
+// Whether create_surface() can reserve the region for the surface and write it later, which
+// needs the vertices to go straight into the preallocated buffer in the layout of addSurfaceData().
+bool VBOBuilder::canDeferSurface(bool enable_barycentric)
+{
+  if (useElements() || interleaved_buffer_.empty() || write_index_ != surface_index_) return false;
+  const auto& vertex_data = *data();
+  const size_t num_attributes = enable_barycentric ? shader_attributes_index_ + 1 : 3;
+  return vertex_data.sizeInBytes() == 0 && vertex_data.attributes().size() == num_attributes &&
+         vertex_data.positionIndex() == 0 && hasAttribute(vertex_data.positionData(), GL_FLOAT, 3) &&
+         hasAttribute(vertex_data.normalData(), GL_FLOAT, 3) &&
+         hasAttribute(vertex_data.colorData(), GL_FLOAT, 4) &&
+         (!enable_barycentric ||
+          hasAttribute(vertex_data.attributes()[shader_attributes_index_ + BARYCENTRIC_ATTRIB],
+                       GL_UNSIGNED_BYTE, 4));
+}
+
+// The cached data only depends on the PolySet, the transform, the colors and the vertex layout
+std::string VBOBuilder::surfaceCacheKey(const DeferredSurface& surface) const
+{
+  std::ostringstream key;
+  key << surface.cached_ps.get() << std::hexfloat;
+  for (Eigen::Index i = 0; i < surface.m.matrix().size(); ++i) key << ':' << surface.m.data()[i];
+  const Color4f& c = surface.default_color;
+  key << ':' << c.r() << ':' << c.g() << ':' << c.b() << ':' << c.a();
+  key << ':' << surface.enable_barycentric << surface.force_default_color << ':'
+      << vertices_[surface_index_]->stride();
+  return key.str();
+}
+
+// Writes the same vertices create_triangle() would, with typed writes to the reserved region,
+// or copies them from the surface cache. Returns the data to cache, if any.
+std::optional<VBOBuilder::SurfaceData> VBOBuilder::writeDeferredSurface(const DeferredSurface& surface)
+{
+  const auto& vertex_data = *vertices_[surface_index_];
+  const size_t stride = vertex_data.stride();
+  const size_t position_offset = vertex_data.interleavedOffset(vertex_data.positionIndex());
+  const size_t normal_offset = vertex_data.interleavedOffset(vertex_data.normalIndex());
+  const size_t color_offset = vertex_data.interleavedOffset(vertex_data.colorIndex());
+  const size_t barycentric_offset =
+    vertex_data.interleavedOffset(shader_attributes_index_ + BARYCENTRIC_ATTRIB);
+  const bool mirrored = surface.m.matrix().determinant() < 0;
+  const std::array<size_t, 3> order = mirrored ? std::array<size_t, 3>{0, 2, 1}
+                                               : std::array<size_t, 3>{0, 1, 2};
+
+  GLbyte *begin = interleaved_buffer_.data() + surface.offset;
+  std::string key;
+  if (surface.cached_ps) {
+    key = surfaceCacheKey(surface);
+    if (const auto entry = surface_cache.find(key)) {
+      const bool same_ps =
+        !entry->ps.owner_before(surface.cached_ps) && !surface.cached_ps.owner_before(entry->ps);
+      if (same_ps && entry->data->size() == surface.size) {
+        std::memcpy(begin, entry->data->data(), surface.size);
+        return {};
+      }
+    }
+  }
+
+  GLbyte *dst = begin;
+  forEachSurfaceTriangle(
+    *surface.ps, surface.m,
+    [&](size_t face, const Vector3d& p0, const Vector3d& p1, const Vector3d& p2, size_t primitive_index,
+        size_t shape_size) {
+      const Color4f& color =
+        faceColor(*surface.ps, face, surface.default_color, surface.force_default_color);
+      const Vector3d n = triangleNormal(p0, p1, p2);
+      const std::array<const Vector3d *, 3> points{&p0, &p1, &p2};
+      for (const size_t active_point_index : order) {
+        const Vector3d& p = *points[active_point_index];
+        writeAttribute(dst + position_offset, std::array<GLfloat, 3>{static_cast<GLfloat>(p[0]),
+                                                                     static_cast<GLfloat>(p[1]),
+                                                                     static_cast<GLfloat>(p[2])});
+        writeAttribute(dst + normal_offset, std::array<GLfloat, 3>{static_cast<GLfloat>(n[0]),
+                                                                   static_cast<GLfloat>(n[1]),
+                                                                   static_cast<GLfloat>(n[2])});
+        writeAttribute(dst + color_offset,
+                       std::array<GLfloat, 4>{color.r(), color.g(), color.b(), color.a()});
+        if (surface.enable_barycentric) {
+          const auto flags = barycentricFlags(active_point_index, primitive_index, shape_size, false);
+          writeAttribute(dst + barycentric_offset,
+                         std::array<GLubyte, 4>{flags[0], flags[1], flags[2], 0});
+        }
+        dst += stride;
+      }
+    });
+
+  if (!surface.cached_ps) return {};
+  return SurfaceData{.key = std::move(key),
+                     .data = std::make_shared<const std::vector<GLbyte>>(begin, begin + surface.size)};
+}
+
+void VBOBuilder::clearSurfaceCache()
+{
+  surface_cache.clear();
+}
+
+void VBOBuilder::writeDeferredSurfaces(const std::vector<VBOBuilder *>& builders)
+{
+  struct Job {
+    VBOBuilder *builder;
+    const DeferredSurface *surface;
+    std::optional<SurfaceData> cached;
+  };
+  std::vector<Job> jobs;
+  for (const auto& builder : builders) {
+    for (const auto& surface : builder->deferred_surfaces_) {
+      jobs.push_back({.builder = builder, .surface = &surface, .cached = std::nullopt});
+    }
+  }
+  // Every surface has its own region of the buffer, so they can be written independently
+  parallelizable_for_each(jobs.begin(), jobs.end(), [](Job& job) {
+    job.cached = job.builder->writeDeferredSurface(*job.surface);
+  });
+
+  // Inserting may evict from the other caches of the memory budget, so it's done here, once
+  std::vector<decltype(surface_cache)::Insertion> insertions;
+  for (auto& job : jobs) {
+    if (!job.cached) continue;
+    const size_t cost = sizeof(SurfaceCacheEntry) + job.cached->key.size() + job.surface->size;
+    insertions.push_back({.key = std::move(job.cached->key),
+                          .entry = {.ps = job.surface->cached_ps, .data = std::move(job.cached->data)},
+                          .cost = cost});
+  }
+  surface_cache.insertAll(std::move(insertions));
+
+  for (const auto& builder : builders) {
+    builder->deferred_surfaces_.clear();
+  }
+}
+
 // Creates a VBO "surface" from the PolySet.
 // This will usually create a new VertexState and append it to our
-// vertex states
+// vertex states.
+// When writing into preallocated buffers, only the region for the vertices is reserved here,
+// so ps must stay alive until createInterleavedVBOs() or writeDeferredSurfaces() fills it.
 void VBOBuilder::create_surface(const PolySet& ps, const Transform3d& m, const Color4f& default_color,
                                 bool enable_barycentric, bool force_default_color)
+{
+  create_surface(ps, nullptr, m, default_color, enable_barycentric, force_default_color);
+}
+
+void VBOBuilder::create_surface(const std::shared_ptr<const PolySet>& ps, const Transform3d& m,
+                                const Color4f& default_color, bool enable_barycentric,
+                                bool force_default_color)
+{
+  create_surface(*ps, ps, m, default_color, enable_barycentric, force_default_color);
+}
+
+void VBOBuilder::create_surface(const PolySet& ps, std::shared_ptr<const PolySet> cached_ps,
+                                const Transform3d& m, const Color4f& default_color,
+                                bool enable_barycentric, bool force_default_color)
 {
   const std::shared_ptr<VertexData> vertex_data = data();
 
@@ -439,7 +687,6 @@ void VBOBuilder::create_surface(const PolySet& ps, const Transform3d& m, const C
   const bool mirrored = m.matrix().determinant() < 0;
   size_t triangle_count = 0;
 
-  std::unordered_map<Vector3d, Vector3d> vert_mult_map;
   const auto last_size = verticesOffset();
 
   size_t elements_offset = 0;
@@ -448,46 +695,28 @@ void VBOBuilder::create_surface(const PolySet& ps, const Transform3d& m, const C
     elementsMap().clear();
   }
 
-  auto has_colors = !ps.color_indices.empty();
-
-  for (size_t i = 0, n = ps.indices.size(); i < n; i++) {
-    const auto& poly = ps.indices[i];
-    const size_t color_index = has_colors && i < ps.color_indices.size() ? ps.color_indices[i] : -1;
-    const auto& color = !force_default_color && color_index >= 0 && color_index < ps.colors.size() &&
-                            ps.colors[color_index].isValid()
-                          ? ps.colors[color_index]
-                          : default_color;
-    if (poly.size() == 3) {
-      const Vector3d p0 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(0)], m);
-      const Vector3d p1 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(1)], m);
-      const Vector3d p2 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(2)], m);
-
-      create_triangle(color, p0, p1, p2, 0, poly.size(), false, enable_barycentric, mirrored);
-      triangle_count++;
-    } else if (poly.size() == 4) {
-      const Vector3d p0 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(0)], m);
-      const Vector3d p1 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(1)], m);
-      const Vector3d p2 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(2)], m);
-      const Vector3d p3 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(3)], m);
-
-      create_triangle(color, p0, p1, p3, 0, poly.size(), false, enable_barycentric, mirrored);
-      create_triangle(color, p2, p3, p1, 1, poly.size(), false, enable_barycentric, mirrored);
-      triangle_count += 2;
-    } else {
-      Vector3d center = Vector3d::Zero();
-      for (const auto& idx : poly) {
-        center += ps.vertices[idx];
-      }
-      center /= poly.size();
-      for (size_t i = 1; i <= poly.size(); i++) {
-        const Vector3d p0 = uniqueMultiply(vert_mult_map, center, m);
-        const Vector3d p1 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(i % poly.size())], m);
-        const Vector3d p2 = uniqueMultiply(vert_mult_map, ps.vertices[poly.at(i - 1)], m);
-
-        create_triangle(color, p0, p2, p1, i - 1, poly.size(), false, enable_barycentric, mirrored);
-        triangle_count++;
-      }
-    }
+  if (canDeferSurface(enable_barycentric)) {
+    const size_t num_vertices = surfaceVertexCount(ps);
+    deferred_surfaces_.push_back({.ps = &ps,
+                                  .cached_ps = std::move(cached_ps),
+                                  .m = m,
+                                  .default_color = default_color,
+                                  .enable_barycentric = enable_barycentric,
+                                  .force_default_color = force_default_color,
+                                  .offset = vertices_offset_,
+                                  .size = num_vertices * vertex_data->stride()});
+    vertices_offset_ += deferred_surfaces_.back().size;
+    assert(vertices_offset_ <= interleaved_buffer_.size());
+    triangle_count = num_vertices / 3;
+  } else {
+    forEachSurfaceTriangle(ps, m,
+                           [&](size_t face, const Vector3d& p0, const Vector3d& p1, const Vector3d& p2,
+                               size_t primitive_index, size_t shape_size) {
+                             create_triangle(faceColor(ps, face, default_color, force_default_color),
+                                             p0, p1, p2, primitive_index, shape_size, false,
+                                             enable_barycentric, mirrored);
+                             triangle_count++;
+                           });
   }
 
   GLenum elements_type = 0;
@@ -3,7 +3,9 @@
 #include <array>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <cstddef>
+#include <string>
 #include <unordered_map>
 #include <boost/functional/hash.hpp>
 #include <utility>
@@ -378,11 +380,45 @@ public:
                        bool mirror);
   void create_surface(const PolySet& ps, const Transform3d& m, const Color4f& default_color,
                       bool enable_barycentric, bool force_default_color = false);
+  // As above, but the vertex data is cached across builders for the same PolySet, transform and
+  // colors, so previews only regenerate the data of leaves which actually changed.
+  void create_surface(const std::shared_ptr<const PolySet>& ps, const Transform3d& m,
+                      const Color4f& default_color, bool enable_barycentric,
+                      bool force_default_color = false);
   void create_edges(const Polygon2d& polygon, const Transform3d& m, const Color4f& color);
   void create_polygons(const PolySet& ps, const Transform3d& m, const Color4f& color);
 
+  // Writes the vertices of the surfaces deferred by create_surface() for all builders, in parallel
+  static void writeDeferredSurfaces(const std::vector<VBOBuilder *>& builders);
+  static void clearSurfaceCache();
+
 private:
+  // A surface whose vertices have a region of interleaved_buffer_ reserved, but are not written yet
+  struct DeferredSurface {
+    const PolySet *ps;
+    // Keeps ps alive while its data is cached, null if the data shouldn't be cached
+    std::shared_ptr<const PolySet> cached_ps;
+    Transform3d m;
+    Color4f default_color;
+    bool enable_barycentric;
+    bool force_default_color;
+    size_t offset;
+    size_t size;
+  };
+
+  // Vertex data written by writeDeferredSurface(), to be added to the surface cache
+  struct SurfaceData {
+    std::string key;
+    std::shared_ptr<const std::vector<GLbyte>> data;
+  };
+
   inline void setElementsSize(size_t elements_size) { elements_size_ = elements_size; }
+  void create_surface(const PolySet& ps, std::shared_ptr<const PolySet> cached_ps,
+                      const Transform3d& m, const Color4f& default_color, bool enable_barycentric,
+                      bool force_default_color);
+  bool canDeferSurface(bool enable_barycentric);
+  std::string surfaceCacheKey(const DeferredSurface& surface) const;
+  std::optional<SurfaceData> writeDeferredSurface(const DeferredSurface& surface);
 
   std::unique_ptr<VertexStateFactory> factory_;
   VertexStateContainer& vertex_state_container_;
@@ -402,4 +438,6 @@ private:
 
   VertexData elements_;
   ElementsMap elements_map_;
+
+  std::vector<DeferredSurface> deferred_surfaces_;
 };
@@ -0,0 +1,110 @@
+#ifndef NULLGL
+
+#include "glview/VBOBuilder.h"
+
+#include <catch2/catch_all.hpp>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "geometry/PolySet.h"
+#include "geometry/linalg.h"
+#include "glview/OffscreenView.h"
+#include "glview/VertexState.h"
+#include "glview/system-gl.h"
+
+namespace {
+
+// A triangle, a quad and a pentagon, with one face colored
+std::shared_ptr<const PolySet> polyset()
+{
+  auto ps = std::make_shared<PolySet>(3);
+  ps->vertices = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {1, 0, 1}, {1, 1, 1},
+                  {0, 1, 1}, {0, 0, 2}, {4, 0, 2}, {4, 4, 2}, {2, 1, 2}, {0, 4, 2}};
+  ps->indices = {{0, 1, 2}, {3, 4, 5, 6}, {7, 8, 9, 10, 11}};
+  ps->colors = {Color4f(0.1f, 0.2f, 0.3f, 1.0f)};
+  ps->color_indices = {-1, 0, -1};
+  return ps;
+}
+
+struct Output {
+  std::vector<GLbyte> vertices;
+  std::vector<GLsizei> sizes;
+  std::vector<size_t> offsets;
+};
+
+enum class Path { Serial, Deferred, Cached };
+
+// Creates the surfaces the way the renderers do, and reads back what ended up in the VBO.
+// Without allocateBuffers() the vertices are created one by one, otherwise they're deferred.
+Output build(Path path, const std::shared_ptr<const PolySet>& ps, const Transform3d& m,
+             bool enable_barycentric, size_t num_vertices)
+{
+  VertexStateContainer container;
+  VBOBuilder builder(std::make_unique<VertexStateFactory>(), container);
+  builder.addSurfaceData();
+  builder.writeSurface();
+  if (enable_barycentric) builder.addShaderData();
+  if (path != Path::Serial) builder.allocateBuffers(2 * num_vertices);
+
+  const Color4f color(0.5f, 0.6f, 0.7f, 1.0f);
+  for (int i = 0; i < 2; ++i) {
+    if (path == Path::Cached) {
+      builder.create_surface(ps, m, color, enable_barycentric);
+    } else {
+      builder.create_surface(*ps, m, color, enable_barycentric);
+    }
+    // The second surface of the cached path is copied from the first
+    if (path == Path::Cached && i == 0) VBOBuilder::writeDeferredSurfaces({&builder});
+  }
+  builder.createInterleavedVBOs();
+
+  Output output;
+  GLint size = 0;
+  glBindBuffer(GL_ARRAY_BUFFER, container.verticesVBO());
+  glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &size);
+  output.vertices.resize(size);
+  glGetBufferSubData(GL_ARRAY_BUFFER, 0, size, output.vertices.data());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  for (const auto& state : container.states()) {
+    output.sizes.push_back(state->drawSize());
+    output.offsets.push_back(state->drawOffset());
+  }
+  return output;
+}
+
+}  // namespace
+
+TEST_CASE("Deferred surfaces match surfaces created vertex by vertex", "[vbo]")
+{
+  std::optional<OffscreenView> view;
+  try {
+    view.emplace(16, 16);
+  } catch (const OffscreenViewException& e) {
+    SKIP("No OpenGL context: " << e.what());
+  }
+
+  const auto ps = polyset();
+  const bool enable_barycentric = GENERATE(false, true);
+  const bool mirrored = GENERATE(false, true);
+  Transform3d m = Transform3d::Identity();
+  // Mirrored triangles are written in {0, 2, 1} order to keep them front facing
+  if (mirrored) m.scale(Vector3d(-1, 1, 1.1));
+
+  VBOBuilder::clearSurfaceCache();
+  const auto serial = build(Path::Serial, ps, m, enable_barycentric, 0);
+  REQUIRE(serial.sizes.size() == 2);
+  // The triangle, two for the quad and a fan of five around the center of the pentagon
+  REQUIRE(serial.sizes[0] == 3 * 8);
+  REQUIRE(serial.sizes[1] == 3 * 8);
+  REQUIRE_FALSE(serial.vertices.empty());
+
+  const auto path = GENERATE(Path::Deferred, Path::Cached);
+  const auto deferred = build(path, ps, m, enable_barycentric, serial.sizes[0]);
+  CHECK(deferred.sizes == serial.sizes);
+  CHECK(deferred.offsets == serial.offsets);
+  CHECK(deferred.vertices == serial.vertices);
+}
+
+#endif  // NULLGL
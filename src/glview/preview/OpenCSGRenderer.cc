@@ -27,6 +27,7 @@
 #include "glview/preview/OpenCSGRenderer.h"
 #include "glview/Renderer.h"
 #include "glview/ShaderUtils.h"
+#include "glview/VBOBuilder.h"
 #include "glview/VertexState.h"
 #include "geometry/linalg.h"
 #include "glview/system-gl.h"
@@ -178,18 +179,23 @@ void OpenCSGRenderer::draw(bool showedges, const ShaderUtils::ShaderInfo *shader
 // reuse VBOs, but that requires some more careful state management.
 // Note: This function can be called multiple times for different products.
 // Each call will add to vbo_vertex_products_.
+// The vertex data of all products is only written once all their states are set up,
+// so the surfaces of all products can be filled in parallel.
 void OpenCSGRenderer::createCSGVBOProducts(const CSGProducts& products, bool highlight_mode,
                                            bool background_mode,
                                            const ShaderUtils::ShaderInfo *shaderinfo)
 {
 #ifdef ENABLE_OPENCSG
   bool enable_barycentric = true;
+  std::vector<std::unique_ptr<VBOBuilder>> vbo_builders;
+  vbo_builders.reserve(products.products.size());
   for (const auto& product : products.products) {
     std::unique_ptr<OpenCSGVBOProduct> vertex_state_container = std::make_unique<OpenCSGVBOProduct>();
 
     Color4f last_color;
     auto& vertex_states = vertex_state_container->states();
-    VBOBuilder vbo_builder(std::make_unique<OpenCSGVertexStateFactory>(), *vertex_state_container.get());
+    VBOBuilder& vbo_builder = *vbo_builders.emplace_back(std::make_unique<VBOBuilder>(
+      std::make_unique<OpenCSGVertexStateFactory>(), *vertex_state_container.get()));
     vbo_builder.addSurfaceData();
     vbo_builder.writeSurface();
     vbo_builder.addShaderData();  // Always enable barycentric coordinates
@@ -234,7 +240,7 @@ void OpenCSGRenderer::createCSGVBOProducts(const CSGProducts& products, bool hig
 
         if (color.a() == 1.0f) {
           // object is opaque, draw normally
-          vbo_builder.create_surface(*csgobj.leaf->polyset, csgobj.leaf->matrix, last_color,
+          vbo_builder.create_surface(csgobj.leaf->polyset, csgobj.leaf->matrix, last_color,
                                      enable_barycentric, override_color);
           if (const auto csg_vs = std::dynamic_pointer_cast<OpenCSGVertexState>(vertex_states.back())) {
             csg_vs->setCsgObjectIndex(csgobj.leaf->index);
@@ -252,7 +258,7 @@ void OpenCSGRenderer::createCSGVBOProducts(const CSGProducts& products, bool hig
           });
           vertex_states.emplace_back(std::move(cull));
 
-          vbo_builder.create_surface(*csgobj.leaf->polyset, csgobj.leaf->matrix, last_color,
+          vbo_builder.create_surface(csgobj.leaf->polyset, csgobj.leaf->matrix, last_color,
                                      enable_barycentric, override_color);
           if (const auto csg_vs = std::dynamic_pointer_cast<OpenCSGVertexState>(vertex_states.back())) {
             csg_vs->setCsgObjectIndex(csgobj.leaf->index);
@@ -321,7 +327,7 @@ void OpenCSGRenderer::createCSGVBOProducts(const CSGProducts& products, bool hig
           // Scale 2D negative objects 10% in the Z direction to avoid z fighting
           tmp *= Eigen::Scaling(1.0, 1.0, 1.1);
         }
-        vbo_builder.create_surface(*csgobj.leaf->polyset, tmp, last_color, enable_barycentric,
+        vbo_builder.create_surface(csgobj.leaf->polyset, tmp, last_color, enable_barycentric,
                                    override_color);
         if (const auto csg_vs = std::dynamic_pointer_cast<OpenCSGVertexState>(vertex_states.back())) {
           csg_vs->setCsgObjectIndex(csgobj.leaf->index);
@@ -347,9 +353,14 @@ void OpenCSGRenderer::createCSGVBOProducts(const CSGProducts& products, bool hig
     GL_TRACE0("glBindBuffer(GL_ARRAY_BUFFER, 0)");
     GL_CHECKD(glBindBuffer(GL_ARRAY_BUFFER, 0));
 
-    vbo_builder.createInterleavedVBOs();
     vertex_state_containers_.push_back(std::move(vertex_state_container));
   }
+
+  std::vector<VBOBuilder *> builders;
+  builders.reserve(vbo_builders.size());
+  for (const auto& vbo_builder : vbo_builders) builders.push_back(vbo_builder.get());
+  VBOBuilder::writeDeferredSurfaces(builders);
+  for (const auto& vbo_builder : vbo_builders) vbo_builder->createInterleavedVBOs();
 #endif  // ENABLE_OPENCSG
 }
 
@@ -8,6 +8,7 @@
 #include "geometry/manifold/ManifoldGeometry.h"
 #endif
 
+#include "RenderStatistic.h"
 #include "core/Tree.h"
 #include "core/progress.h"
 #include "geometry/GeometryEvaluator.h"
@@ -51,6 +52,7 @@ void CGALWorker::work()
 #endif
   std::shared_ptr<const Geometry> root_geom;
   try {
+    const RenderStatistic::Phase phase(RenderStatistic::GEOMETRY_EVALUATION);
     GeometryEvaluator evaluator(*this->tree);
     root_geom = evaluator.evaluateGeometry(*this->tree->root(), true);
 
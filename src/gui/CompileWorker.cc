@@ -0,0 +1,58 @@
+#include "gui/CompileWorker.h"
+
+#include <QThread>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "core/progress.h"
+
+CompileWorker::CompileWorker()
+{
+  this->thread = new QThread();
+  if (this->thread->stackSize() < 1024 * 1024) this->thread->setStackSize(1024 * 1024);
+  connect(this->thread, &QThread::started, this, &CompileWorker::work);
+  moveToThread(this->thread);
+}
+
+CompileWorker::~CompileWorker()
+{
+  cancel();
+  this->thread->quit();
+  this->thread->wait();
+  delete this->thread;
+}
+
+bool CompileWorker::isRunning() const
+{
+  return this->thread->isRunning();
+}
+
+void CompileWorker::cancel()
+{
+  if (this->token) this->token->store(true);
+}
+
+void CompileWorker::start(const std::function<void()>& job)
+{
+  // The previous job may still be returning from work() after emitting done()
+  this->thread->wait();
+  this->job = job;
+  this->token = std::make_shared<std::atomic<bool>>(false);
+  this->thread->start();
+}
+
+void CompileWorker::work()
+{
+  bool cancelled = false;
+  progress_set_cancellation_token(this->token);
+  try {
+    this->job();
+  } catch (const ProgressCancelException&) {
+    cancelled = true;
+  }
+  progress_set_cancellation_token(nullptr);
+  this->job = nullptr;
+  emit done(cancelled || this->token->load());
+  thread->quit();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QObject>
+#include <functional>
+
+#include "core/progress.h"
+
+/*!
+   Runs the stages of a compile which don't need the GUI (instantiation and CSG tree
+   generation) on a separate thread, so the editor stays responsive meanwhile.
+
+   A running job can be cancelled from the GUI thread; it stops at the next cancellation
+   check of the evaluator or progress report. done() is emitted in either case.
+ */
+class CompileWorker : public QObject
+{
+  Q_OBJECT;
+
+public:
+  CompileWorker();
+  ~CompileWorker() override;
+
+  [[nodiscard]] bool isRunning() const;
+  void cancel();
+
+public slots:
+  void start(const std::function<void()>& job);
+
+protected slots:
+  void work();
+
+signals:
+  void done(bool cancelled);
+
+protected:
+  class QThread *thread;
+  std::function<void()> job;
+  CancellationToken token;
+};
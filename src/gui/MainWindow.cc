@@ -86,6 +86,7 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -99,6 +100,7 @@
 #include "core/Context.h"
 #include "core/EvaluationSession.h"
 #include "core/Expression.h"
+#include "core/FreetypeRenderer.h"
 #include "core/RenderVariables.h"
 #include "core/ScopeContext.h"
 #include "core/Settings.h"
@@ -112,6 +114,7 @@
 #include "geometry/GeometryEvaluator.h"
 #include "glview/PolySetRenderer.h"
 #include "glview/RenderSettings.h"
+#include "glview/VBOBuilder.h"
 #if not defined(USE_POLYSET_FOR_CGAL)
 #include "glview/cgal/CGALRenderer.h"
 #endif
@@ -119,6 +122,7 @@
 #include "glview/preview/ThrownTogetherRenderer.h"
 #include "gui/AboutDialog.h"
 #include "gui/CGALWorker.h"
+#include "gui/CompileWorker.h"
 #include "gui/ColorList.h"
 #include "gui/Dock.h"
 #include "gui/ai/AIDock.h"
@@ -147,6 +151,7 @@
 #include "io/dxfdim.h"
 #include "io/export.h"
 #include "io/fileutils.h"
+#include "io/import.h"
 #include "openscad.h"
 #include "platform/PlatformUtils.h"
 #include "utils/exceptions.h"
@@ -212,6 +217,8 @@ QElapsedTimer *MainWindow::progressThrottle = new QElapsedTimer();
 namespace {
 
 const int autoReloadPollingPeriodMS = 200;
+// How long typing has to pause before a preview cancelled by editing is started again
+const int stalePreviewDelayMS = 500;
 
 struct DockFocus {
   Dock *widget;
@@ -538,6 +545,8 @@ void MainWindow::loadDesignSettings()
     GlobalPreferences::inst()->getValue("advanced/renderBackend3D").toString().toStdString();
   RenderSettings::inst()->backend3D =
     renderBackend3DFromString(backend3D).value_or(DEFAULT_RENDERING_BACKEND_3D);
+  RenderSettings::inst()->previewMaxSegments =
+    GlobalPreferences::inst()->getValue("advanced/previewMaxSegments").toUInt();
 }
 
 void MainWindow::updateUndockMode(bool undockMode)
@@ -612,6 +621,7 @@ void MainWindow::updateReorderMode(bool reorderMode)
 
 MainWindow::~MainWindow()
 {
+  delete this->compileworker;
   delete this->cgalworker;
 }
 
@@ -629,6 +639,7 @@ void MainWindow::closeEvent(QCloseEvent *event)
   }
 
   isClosing = true;
+  this->compileworker->cancel();
   progress_report_fin();
 
   if (this->tempFile) {
@@ -742,6 +753,7 @@ void MainWindow::compile(bool reload, bool forcedone)
     compileErrors = 0;
     compileWarnings = 0;
 
+    RenderStatistic::resetPhases();
     this->renderStatistic.start();
 
     // Reload checks the timestamp of the toplevel file and refreshes if necessary,
@@ -786,7 +798,10 @@ void MainWindow::compile(bool reload, bool forcedone)
         this->console->clear();
       }
       if (activeEditor->isContentModified()) saveBackup();
-      parseTopLevelDocument();
+      {
+        const RenderStatistic::Phase phase(RenderStatistic::PARSE);
+        parseTopLevelDocument();
+      }
       didcompile = true;
     }
 
@@ -888,20 +903,12 @@ void MainWindow::updateCompileResult()
 void MainWindow::compileDone(bool didchange)
 {
   OpenSCAD::hardwarnings = GlobalPreferences::inst()->getValue("advanced/enableHardwarnings").toBool();
-  try {
-    const char *callslot;
-    if (didchange) {
-      instantiateRoot();
-      updateCompileResult();
-      callslot = afterCompileSlot;
-    } else {
-      callslot = "compileEnded";
-    }
-
+  if (didchange) {
+    // Continues in instantiateRootDone()
+    instantiateRoot();
+  } else {
     this->procevents = false;
-    QMetaObject::invokeMethod(this, callslot);
-  } catch (const HardWarningException&) {
-    exceptionCleanup();
+    QMetaObject::invokeMethod(this, "compileEnded");
   }
 
   if (didchange) {
@@ -936,6 +943,10 @@ void MainWindow::compileEnded()
   clearCurrentOutput();
   GuiLocker::unlock();
   if (designActionAutoReload->isChecked()) autoReloadTimer->start();
+  if (this->previewPending) {
+    this->previewPending = false;
+    QTimer::singleShot(0, this, &MainWindow::actionRenderPreview);
+  }
 #ifdef ENABLE_GUI_TESTS
   emit compilationDone(this->rootFile.get());
 #endif
@@ -955,9 +966,24 @@ std::shared_ptr<AbstractNode> MainWindow::instantiateRootFromSource(SourceFile *
 }
 #endif  // ifdef ENABLE_GUI_TESTS
 
+struct MainWindow::InstantiateJob {
+  InstantiateJob(const std::string& documentRoot)
+    : session{documentRoot}, builtin_context{Context::create<BuiltinContext>(&session)}
+  {
+  }
+
+  EvaluationSession session;
+  ContextHandle<BuiltinContext> builtin_context;
+  std::shared_ptr<const FileContext> file_context;
+  std::shared_ptr<AbstractNode> root;
+  bool hardwarning{false};
+  // Set if instantiation failed with an exception, empty if its type is unknown
+  std::optional<std::string> error;
+};
+
 void MainWindow::instantiateRoot()
 {
-  // Go on and instantiate root_node, then call the continuation slot
+  // Go on and instantiate root_node on the compile worker, then call instantiateRootDone()
 
   // Invalidate renderers before we kill the CSG tree
   this->qglview->setRenderer(nullptr);
@@ -981,25 +1007,62 @@ void MainWindow::instantiateRoot()
 
   renderedEditor = activeEditor;
 
-  if (this->rootFile) {
-    // Evaluate CSG tree
-    LOG("Compiling design (CSG Tree generation)...");
-    this->processEvents();
+  if (!this->rootFile) {
+    instantiateRootDone(false);
+    return;
+  }
 
-    AbstractNode::resetIndexCounter();
+  // Evaluate CSG tree
+  LOG("Compiling design (CSG Tree generation)...");
+  this->processEvents();
+
+  AbstractNode::resetIndexCounter();
 
-    EvaluationSession session{doc.parent_path().string()};
-    ContextHandle<BuiltinContext> builtin_context{Context::create<BuiltinContext>(&session)};
-    setRenderVariables(builtin_context);
+  // The context is set up here, as the render variables come from the GUI
+  auto job = std::make_shared<InstantiateJob>(doc.parent_path().string());
+  setRenderVariables(job->builtin_context);
+  this->instantiateJob = job;
 
-    std::shared_ptr<const FileContext> file_context;
 #ifdef ENABLE_PYTHON
-    if (python_result_node != NULL && this->python_active) this->absoluteRootNode = python_result_node;
-    else
+  if (python_result_node != NULL && this->python_active) {
+    job->root = python_result_node;
+    instantiateRootDone(false);
+    return;
+  }
 #endif
-      this->absoluteRootNode = this->rootFile->instantiate(*builtin_context, &file_context);
-    if (file_context) {
-      this->qglview->cam.updateView(file_context, false);
+  this->compileworker->start([job, rootFile = this->rootFile]() {
+    try {
+      const RenderStatistic::Phase phase(RenderStatistic::INSTANTIATE);
+      job->root = rootFile->instantiate(*job->builtin_context, &job->file_context);
+    } catch (const HardWarningException&) {
+      job->hardwarning = true;
+    } catch (const std::exception& ex) {
+      job->error = ex.what();
+    }
+  });
+}
+
+void MainWindow::instantiateRootDone(bool cancelled)
+{
+  const auto job = std::move(this->instantiateJob);
+  if (cancelled) {
+    LOG("Compilation cancelled.");
+    compileEnded();
+    return;
+  }
+  if (job && job->hardwarning) {
+    exceptionCleanup();
+    return;
+  }
+  if (job && job->error) {
+    UnknownExceptionCleanup(*job->error);
+    return;
+  }
+
+  if (job) {
+    this->absoluteRootNode = job->root;
+    if (job->file_context) {
+      this->qglview->cam.updateView(job->file_context, false);
       viewportControlWidget->cameraChanged();
     }
 
@@ -1010,7 +1073,7 @@ void MainWindow::instantiateRoot()
         this->rootNode = this->absoluteRootNode;
       }
       if (nextLocation) {
-        LOG(message_group::NONE, *nextLocation, builtin_context->documentRoot(),
+        LOG(message_group::NONE, *nextLocation, job->builtin_context->documentRoot(),
             "More than one Root Modifier (!)");
       }
 
@@ -1029,97 +1092,133 @@ void MainWindow::instantiateRoot()
     LOG(" ");
     this->processEvents();
   }
+
+  updateCompileResult();
+  this->procevents = false;
+  QMetaObject::invokeMethod(this, afterCompileSlot);
 }
 
+struct MainWindow::CSGJob {
+  std::shared_ptr<CSGNode> csgRoot;
+  std::shared_ptr<CSGNode> normalizedRoot;
+  std::shared_ptr<CSGProducts> rootProduct;
+  std::shared_ptr<CSGProducts> highlightsProducts;
+  std::shared_ptr<CSGProducts> backgroundProducts;
+  bool hardwarning{false};
+};
+
 /*!
-   Generates CSG tree for OpenCSG evaluation.
+   Generates CSG tree for OpenCSG evaluation on the compile worker, then calls afterCSGSlot.
    Assumes that the design has been parsed and evaluated (this->root_node is set)
  */
-void MainWindow::compileCSG()
+void MainWindow::compileCSG(const char *afterCSGSlot)
 {
   OpenSCAD::hardwarnings = GlobalPreferences::inst()->getValue("advanced/enableHardwarnings").toBool();
-  try {
-    assert(this->rootNode);
-    LOG("Compiling design (CSG Products generation)...");
-    this->processEvents();
+  this->afterCSGSlot = afterCSGSlot;
+  assert(this->rootNode);
+  LOG("Compiling design (CSG Products generation)...");
+  this->processEvents();
 
-    // Main CSG evaluation
-    this->progresswidget = new ProgressWidget(this);
-    connect(this->progresswidget, &ProgressWidget::requestShow, this, &MainWindow::showProgress);
+  // Main CSG evaluation
+  this->progresswidget = new ProgressWidget(this);
+  connect(this->progresswidget, &ProgressWidget::requestShow, this, &MainWindow::showProgress);
 
-    GeometryEvaluator geomevaluator(this->tree);
-#ifdef ENABLE_OPENCSG
-    CSGTreeEvaluator csgrenderer(this->tree, &geomevaluator);
-#endif
+  if (isClosing) {
+    QMetaObject::invokeMethod(this, afterCSGSlot);
+    return;
+  }
+  progress_report_prep(this->rootNode, report_func, this);
 
-    if (!isClosing) progress_report_prep(this->rootNode, report_func, this);
-    else return;
+  const size_t normalizelimit =
+    2ul * GlobalPreferences::inst()->getValue("advanced/openCSGLimit").toUInt();
+  auto job = std::make_shared<CSGJob>();
+  this->csgJob = job;
+  this->compileworker->start([this, job, normalizelimit]() {
     try {
+      const RenderStatistic::Phase phase(RenderStatistic::CSG_TREE);
+      GeometryEvaluator geomevaluator(this->tree);
 #ifdef ENABLE_OPENCSG
-      this->processEvents();
-      this->csgRoot = csgrenderer.buildCSGTree(*rootNode);
+      CSGTreeEvaluator csgrenderer(this->tree, &geomevaluator);
 #endif
-      renderStatistic.printCacheStatistic();
-      this->processEvents();
-    } catch (const ProgressCancelException&) {
-      LOG("CSG generation cancelled.");
-    } catch (const HardWarningException&) {
-      LOG("CSG generation cancelled due to hardwarning being enabled.");
-    }
-    progress_report_fin();
-    updateStatusBar(nullptr);
 
-    LOG("Compiling design (CSG Products normalization)...");
-    this->processEvents();
+      try {
+#ifdef ENABLE_OPENCSG
+        job->csgRoot = csgrenderer.buildCSGTree(*this->rootNode);
+#endif
+        renderStatistic.printCacheStatistic();
+      } catch (const ProgressCancelException&) {
+        // Only cancelling from the progress widget continues with what has been generated
+        progress_check_cancel();
+        LOG("CSG generation cancelled.");
+      } catch (const HardWarningException&) {
+        LOG("CSG generation cancelled due to hardwarning being enabled.");
+      }
 
-    const size_t normalizelimit =
-      2ul * GlobalPreferences::inst()->getValue("advanced/openCSGLimit").toUInt();
-    CSGTreeNormalizer normalizer(normalizelimit);
+      LOG("Compiling design (CSG Products normalization)...");
+      CSGTreeNormalizer normalizer(normalizelimit);
 
-    if (this->csgRoot) {
-      this->normalizedRoot = normalizer.normalize(this->csgRoot);
-      if (this->normalizedRoot) {
-        this->rootProduct = std::make_shared<CSGProducts>();
-        this->rootProduct->import(this->normalizedRoot);
-      } else {
-        this->rootProduct.reset();
-        LOG(message_group::Warning, "CSG normalization resulted in an empty tree");
-        this->processEvents();
+      if (job->csgRoot) {
+        job->normalizedRoot = normalizer.normalize(job->csgRoot);
+        if (job->normalizedRoot) {
+          job->rootProduct = std::make_shared<CSGProducts>();
+          job->rootProduct->import(job->normalizedRoot);
+        } else {
+          LOG(message_group::Warning, "CSG normalization resulted in an empty tree");
+        }
       }
-    }
 
-    const std::vector<std::shared_ptr<CSGNode>>& highlight_terms = csgrenderer.getHighlightNodes();
-    if (highlight_terms.size() > 0) {
-      LOG("Compiling highlights (%1$d CSG Trees)...", highlight_terms.size());
-      this->processEvents();
+      const std::vector<std::shared_ptr<CSGNode>>& highlight_terms = csgrenderer.getHighlightNodes();
+      if (highlight_terms.size() > 0) {
+        LOG("Compiling highlights (%1$d CSG Trees)...", highlight_terms.size());
 
-      this->highlightsProducts = std::make_shared<CSGProducts>();
-      for (const auto& highlight_term : highlight_terms) {
-        auto nterm = normalizer.normalize(highlight_term);
-        if (nterm) {
-          this->highlightsProducts->import(nterm);
+        job->highlightsProducts = std::make_shared<CSGProducts>();
+        for (const auto& highlight_term : highlight_terms) {
+          auto nterm = normalizer.normalize(highlight_term);
+          if (nterm) {
+            job->highlightsProducts->import(nterm);
+          }
         }
       }
-    } else {
-      this->highlightsProducts.reset();
-    }
 
-    const auto& background_terms = csgrenderer.getBackgroundNodes();
-    if (background_terms.size() > 0) {
-      LOG("Compiling background (%1$d CSG Trees)...", background_terms.size());
-      this->processEvents();
+      const auto& background_terms = csgrenderer.getBackgroundNodes();
+      if (background_terms.size() > 0) {
+        LOG("Compiling background (%1$d CSG Trees)...", background_terms.size());
 
-      this->backgroundProducts = std::make_shared<CSGProducts>();
-      for (const auto& background_term : background_terms) {
-        auto nterm = normalizer.normalize(background_term);
-        if (nterm) {
-          this->backgroundProducts->import(nterm);
+        job->backgroundProducts = std::make_shared<CSGProducts>();
+        for (const auto& background_term : background_terms) {
+          auto nterm = normalizer.normalize(background_term);
+          if (nterm) {
+            job->backgroundProducts->import(nterm);
+          }
         }
       }
-    } else {
-      this->backgroundProducts.reset();
+    } catch (const HardWarningException&) {
+      job->hardwarning = true;
     }
+  });
+}
+
+void MainWindow::compileCSGDone(bool cancelled)
+{
+  progress_report_fin();
+  updateStatusBar(nullptr);
+
+  const auto job = std::move(this->csgJob);
+  if (cancelled) {
+    LOG("Preview cancelled.");
+    compileEnded();
+    return;
+  }
+
+  this->csgRoot = job->csgRoot;
+  this->normalizedRoot = job->normalizedRoot;
+  this->rootProduct = job->rootProduct;
+  this->highlightsProducts = job->highlightsProducts;
+  this->backgroundProducts = job->backgroundProducts;
 
+  if (job->hardwarning) {
+    exceptionCleanup();
+  } else {
     if (this->rootProduct && (this->rootProduct->size() >
                               GlobalPreferences::inst()->getValue("advanced/openCSGLimit").toUInt())) {
       LOG(message_group::UI_Warning, "Normalized tree has %1$d elements!", this->rootProduct->size());
@@ -1137,9 +1236,8 @@ void MainWindow::compileCSG()
     LOG("Compile and preview finished.");
     renderStatistic.printRenderingTime();
     this->processEvents();
-  } catch (const HardWarningException&) {
-    exceptionCleanup();
   }
+  QMetaObject::invokeMethod(this, this->afterCSGSlot);
 }
 
 void MainWindow::on_fileActionOpen_triggered()
@@ -1823,6 +1921,8 @@ void MainWindow::actionReloadRenderPreview()
   if (GuiLocker::isLocked()) return;
   GuiLocker::lock();
   autoReloadTimer->stop();
+  stalePreviewTimer->stop();
+  this->previewPending = false;
   setCurrentOutput();
 
   this->afterCompileSlot = "csgReloadRender";
@@ -1833,8 +1933,12 @@ void MainWindow::actionReloadRenderPreview()
 
 void MainWindow::csgReloadRender()
 {
-  if (this->rootNode) compileCSG();
+  if (this->rootNode) compileCSG("csgReloadRenderDone");
+  else csgReloadRenderDone();
+}
 
+void MainWindow::csgReloadRenderDone()
+{
   // Go to non-CGAL view mode
   if (viewActionThrownTogether->isChecked()) {
     viewModeThrownTogether();
@@ -1852,6 +1956,8 @@ void MainWindow::prepareCompile(const char *afterCompileSlot, bool procevents, b
 {
   setCurrentOutput();
   autoReloadTimer->stop();
+  stalePreviewTimer->stop();
+  this->previewPending = false;
   LOG(" ");
   LOG("Parsing design (AST generation)...");
   this->processEvents();
@@ -1870,7 +1976,15 @@ void MainWindow::actionRenderPreview()
   static bool preview_requested;
   preview_requested = true;
 
-  if (GuiLocker::isLocked()) return;
+  if (GuiLocker::isLocked()) {
+    // Run again once the preview being compiled has finished, right away if the document was
+    // edited meanwhile, which makes the running compile stale.
+    if (this->isPreview && this->compileworker->isRunning()) {
+      this->previewPending = true;
+      if (activeEditor->toPlainText() != this->lastCompiledDoc) this->compileworker->cancel();
+    }
+    return;
+  }
 
   GuiLocker::lock();
   preview_requested = false;
@@ -1891,8 +2005,12 @@ void MainWindow::actionRenderPreview()
 
 void MainWindow::csgRender()
 {
-  if (this->rootNode) compileCSG();
+  if (this->rootNode) compileCSG("csgRenderDone");
+  else csgRenderDone();
+}
 
+void MainWindow::csgRenderDone()
+{
   // Go to non-CGAL view mode
   if (viewActionThrownTogether->isChecked()) {
     viewModeThrownTogether();
@@ -2565,7 +2683,11 @@ void MainWindow::actionExport(unsigned int dim, ExportInfo& exportInfo)
   }
   this->exportPaths[suffix] = exportFilename;
 
-  const bool exportResult = exportFileByName(rootGeom, exportFilename.toStdString(), exportInfo);
+  bool exportResult;
+  {
+    const RenderStatistic::Phase phase(RenderStatistic::EXPORT);
+    exportResult = exportFileByName(rootGeom, exportFilename.toStdString(), exportInfo);
+  }
 
   if (exportResult) fileExportedMessage(type_name, exportFilename);
 }
@@ -2672,9 +2794,14 @@ void MainWindow::on_editActionCopyViewport_triggered()
 
 void MainWindow::on_designActionFlushCaches_triggered()
 {
+  // The workers use the caches while compiling or rendering
+  if (GuiLocker::isLocked()) return;
   auto guard = scopedSetCurrentOutput();
   GeometryCache::instance()->clear();
   CGALCache::instance()->clear();
+  FreetypeRenderer::clearGlyphCache();
+  clear_svg_import_cache();
+  VBOBuilder::clearSurfaceCache();
   dxf_dim_cache.clear();
   dxf_cross_cache.clear();
   SourceFileCache::instance()->clear();
@@ -2795,6 +2922,15 @@ void MainWindow::editorContentChanged()
 
     // removes the live selection feedbacks in both the 3d view and editor.
     clearAllSelectionIndicators();
+
+    // A preview still compiling is stale now, so don't wait for it to finish. It is
+    // started again once the typing pauses.
+    if (this->isPreview && this->compileworker->isRunning()) {
+      this->compileworker->cancel();
+      this->stalePreviewTimer->start();
+    } else if (this->stalePreviewTimer->isActive()) {
+      this->stalePreviewTimer->start();
+    }
   }
 }
 
@@ -3011,6 +3147,10 @@ void MainWindow::onAIDockVisibilityChanged(bool isVisible)
 
 void MainWindow::onExperimentalChanged()
 {
+#ifndef ENABLE_LIB3MF
+  this->fileActionExport3MF->setVisible(Feature::ExperimentalStreaming3mfExport.is_enabled());
+#endif
+
   bool aiEnabled = Feature::ExperimentalAiFeatures.is_enabled();
   if (this->aiDock) {
     this->aiDock->toggleViewAction()->setVisible(aiEnabled);
@@ -3494,6 +3634,12 @@ void MainWindow::setupCoreSubsystems()
   this->cgalworker = new CGALWorker();
   connect(this->cgalworker, &CGALWorker::done, this, &MainWindow::actionRenderDone);
 
+  this->compileworker = new CompileWorker();
+  connect(this->compileworker, &CompileWorker::done, this, [this](bool cancelled) {
+    if (this->instantiateJob) instantiateRootDone(cancelled);
+    else compileCSGDone(cancelled);
+  });
+
   autoReloadTimer = new QTimer(this);
   autoReloadTimer->setSingleShot(false);
   autoReloadTimer->setInterval(autoReloadPollingPeriodMS);
@@ -3504,6 +3650,11 @@ void MainWindow::setupCoreSubsystems()
   waitAfterReloadTimer->setInterval(autoReloadPollingPeriodMS);
   connect(waitAfterReloadTimer, &QTimer::timeout, this, &MainWindow::waitAfterReload);
 
+  stalePreviewTimer = new QTimer(this);
+  stalePreviewTimer->setSingleShot(true);
+  stalePreviewTimer->setInterval(stalePreviewDelayMS);
+  connect(stalePreviewTimer, &QTimer::timeout, this, &MainWindow::actionRenderPreview);
+
   consoleUpdater = new QTimer(this);
   consoleUpdater->setSingleShot(true);
   connect(consoleUpdater, &QTimer::timeout, this->console, &Console::update);
@@ -3900,10 +4051,6 @@ void MainWindow::setupMenusAndActions()
     this->exportFormatMapper->setMapping(action, int(format));
   }
 
-#ifndef ENABLE_LIB3MF
-  this->fileActionExport3MF->setVisible(false);
-#endif
-
   //
   // View menu
   //
@@ -45,6 +45,7 @@ Q_IMPORT_PLUGIN(QSvgPlugin)
 
 class BuiltinContext;
 class CGALWorker;
+class CompileWorker;
 class CSGNode;
 class CSGProducts;
 class FontListDialog;
@@ -83,10 +84,11 @@ public:
 
   QTimer *consoleUpdater;
 
-  bool isPreview;
+  bool isPreview{false};
 
   QTimer *autoReloadTimer;
   QTimer *waitAfterReloadTimer;
+  QTimer *stalePreviewTimer;
   RenderStatistic renderStatistic;
 
   std::shared_ptr<SourceFile> rootFile;            // Result of parsing
@@ -221,7 +223,7 @@ private:
   void setRenderVariables(ContextHandle<BuiltinContext>& context);
   void updateCompileResult();
   void compile(bool reload, bool forcedone = false);
-  void compileCSG();
+  void compileCSG(const char *afterCSGSlot);
   bool checkEditorModified();
   QString dumpCSGTree(const std::shared_ptr<AbstractNode>& root);
 
@@ -277,6 +279,8 @@ private slots:
   void on_editActionCopy_triggered();
 
   void instantiateRoot();
+  void instantiateRootDone(bool cancelled);
+  void compileCSGDone(bool cancelled);
   void compileDone(bool didchange);
   void compileEnded();
 
@@ -346,7 +350,9 @@ public slots:
   void on_designActionPreview_triggered();
 private slots:
   void csgRender();
+  void csgRenderDone();
   void csgReloadRender();
+  void csgReloadRenderDone();
   void on_designAction3DPrint_triggered();
   void sendToExternalTool(class ExternalToolInterface& externalToolService);
   void on_designActionRender_triggered();
@@ -456,10 +462,18 @@ private:
   int currentlySelectedObject{-1};
 
   char const *afterCompileSlot;
+  char const *afterCSGSlot;
   bool procevents{false};
   QTemporaryFile *tempFile{nullptr};
   ProgressWidget *progresswidget{nullptr};
   CGALWorker *cgalworker;
+  CompileWorker *compileworker;
+  // Results of the compile stage running on compileworker
+  struct InstantiateJob;
+  struct CSGJob;
+  std::shared_ptr<InstantiateJob> instantiateJob;
+  std::shared_ptr<CSGJob> csgJob;
+  bool previewPending{false};  // preview requested while compiling, started once that has ended
   QMutex consolemutex;
   EditorInterface *renderedEditor;  // stores pointer to editor which has been most recently rendered
   time_t includesMTime{0};          // latest include mod time
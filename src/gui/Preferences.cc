@@ -212,6 +212,7 @@ void Preferences::init()
     getValue("advanced/cgalCacheSize").toULongLong() /
     (1024ul * 1024ul);  // carry over old settings if they exist
   this->defaultmap["advanced/openCSGLimit"] = RenderSettings::inst()->openCSGTermLimit;
+  this->defaultmap["advanced/previewMaxSegments"] = RenderSettings::inst()->previewMaxSegments;
   this->defaultmap["advanced/forceGoldfeather"] = false;
   this->defaultmap["advanced/undockableWindows"] = false;
   this->defaultmap["advanced/reorderWindows"] = true;
@@ -384,6 +385,7 @@ void Preferences::init()
 #endif
   this->polysetCacheSizeMBEdit->setValidator(memvalidator);
   this->opencsgLimitEdit->setValidator(uintValidator);
+  this->previewMaxSegmentsEdit->setValidator(uintValidator);
   this->timeThresholdOnRenderCompleteSoundEdit->setValidator(uintValidator);
   this->consoleMaxLinesEdit->setValidator(uintValidator);
   this->lineEditCharacterThreshold->setValidator(validator1);
@@ -735,6 +737,13 @@ void Preferences::on_opencsgLimitEdit_textChanged(const QString& text)
   // FIXME: Set this globally?
 }
 
+void Preferences::on_previewMaxSegmentsEdit_textChanged(const QString& text)
+{
+  QSettingsCached settings;
+  settings.setValue("advanced/previewMaxSegments", text);
+  RenderSettings::inst()->previewMaxSegments = text.toUInt();
+}
+
 void Preferences::on_localizationCheckBox_toggled(bool state)
 {
   QSettingsCached settings;
@@ -1881,6 +1890,8 @@ void Preferences::updateGUI()
     ->setText(getValue("advanced/polysetCacheSizeMB").toString());
   BlockSignals<QLineEdit *>(this->opencsgLimitEdit)
     ->setText(getValue("advanced/openCSGLimit").toString());
+  BlockSignals<QLineEdit *>(this->previewMaxSegmentsEdit)
+    ->setText(getValue("advanced/previewMaxSegments").toString());
   BlockSignals<QCheckBox *>(this->localizationCheckBox)
     ->setChecked(getValue("advanced/localization").toBool());
   BlockSignals<QCheckBox *>(this->autoReloadRaiseCheckBox)
@@ -55,6 +55,7 @@ public slots:
   void on_cgalCacheSizeMBEdit_textChanged(const QString&);
   void on_polysetCacheSizeMBEdit_textChanged(const QString&);
   void on_opencsgLimitEdit_textChanged(const QString&);
+  void on_previewMaxSegmentsEdit_textChanged(const QString&);
   void on_forceGoldfeatherBox_toggled(bool);
   void on_mouseWheelZoomBox_toggled(bool);
   void on_localizationCheckBox_toggled(bool);
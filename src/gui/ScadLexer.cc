@@ -39,7 +39,7 @@ ScadLexer::ScadLexer(QObject *parent) : QsciLexerCPP(parent)
     "minkowski hull resize child children echo union difference "
     "intersection linear_extrude rotate_extrude import group "
     "projection render surface scale rotate mirror translate "
-    "multmatrix color offset intersection_for roof fill";
+    "multmatrix color offset intersection_for roof sweep fill";
 
   setFoldComments(true);
   setFoldAtElse(true);
@@ -127,7 +127,7 @@ void Lex::default_rules()
   std::string transformations(
     "translate rotate scale linear_extrude "
     "rotate_extrude resize mirror multmatrix color "
-    "offset hull minkowski children");
+    "offset hull minkowski sweep children");
   defineRules(transformations, etransformation);
 
   std::string booleans("union difference intersection intersection_for");
@@ -0,0 +1,250 @@
+#include "io/ZipWriter.h"
+
+#include <zlib.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils/parallel.h"
+
+namespace {
+
+// Queued chunks are compressed in parallel once this many have accumulated
+constexpr size_t CHUNKS_PER_BATCH = 32;
+// Literal text is merged into one chunk up to this size
+constexpr size_t MAX_TEXT_CHUNK_SIZE = 1ul << 20;
+constexpr uint32_t ZIP32_LIMIT = 0xffffffff;
+
+constexpr uint16_t VERSION_DEFAULT = 20;
+constexpr uint16_t VERSION_ZIP64 = 45;
+constexpr uint16_t FLAG_DATA_DESCRIPTOR = 0x0008;
+constexpr uint16_t METHOD_DEFLATE = 8;
+// Entries are dated 1980-01-01 00:00, so identical content gives identical archives
+constexpr uint16_t DOS_TIME = 0;
+constexpr uint16_t DOS_DATE = (1 << 5) | 1;
+
+void put16(std::string& s, uint16_t v)
+{
+  s.push_back(static_cast<char>(v & 0xff));
+  s.push_back(static_cast<char>(v >> 8));
+}
+
+void put32(std::string& s, uint32_t v)
+{
+  put16(s, v & 0xffff);
+  put16(s, v >> 16);
+}
+
+void put64(std::string& s, uint64_t v)
+{
+  put32(s, v & 0xffffffff);
+  put32(s, v >> 32);
+}
+
+struct DeflatedChunk {
+  std::string data;
+  uint32_t crc;
+  uint64_t size;
+};
+
+// Deflates text as a piece of a larger raw deflate stream. Each piece starts with a
+// fresh dictionary and ends byte aligned on a sync flush, so pieces compressed
+// independently can simply be concatenated.
+DeflatedChunk deflateChunk(const std::string& text)
+{
+  DeflatedChunk ret;
+  ret.size = text.size();
+  ret.crc = crc32(0, reinterpret_cast<const Bytef *>(text.data()), text.size());
+
+  z_stream zs{};
+  deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+  ret.data.resize(deflateBound(&zs, text.size()) + 16);
+  zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(text.data()));
+  zs.avail_in = text.size();
+  size_t written = 0;
+  while (true) {
+    zs.next_out = reinterpret_cast<Bytef *>(ret.data.data() + written);
+    zs.avail_out = ret.data.size() - written;
+    deflate(&zs, Z_SYNC_FLUSH);
+    written = ret.data.size() - zs.avail_out;
+    if (zs.avail_out != 0) break;
+    ret.data.resize(ret.data.size() * 2);
+  }
+  deflateEnd(&zs);
+  ret.data.resize(written);
+  return ret;
+}
+
+}  // namespace
+
+void ZipWriter::put(const std::string& data)
+{
+  output.write(data.data(), static_cast<std::streamsize>(data.size()));
+  offset += data.size();
+}
+
+void ZipWriter::beginEntry(const std::string& name, bool zip64)
+{
+  assert(queue.empty());
+  entries.push_back({.name = name, .zip64 = zip64, .offset = offset});
+
+  std::string header;
+  put32(header, 0x04034b50);
+  put16(header, zip64 ? VERSION_ZIP64 : VERSION_DEFAULT);
+  put16(header, FLAG_DATA_DESCRIPTOR);
+  put16(header, METHOD_DEFLATE);
+  put16(header, DOS_TIME);
+  put16(header, DOS_DATE);
+  // crc and sizes follow the data in the data descriptor
+  put32(header, 0);
+  put32(header, zip64 ? ZIP32_LIMIT : 0);
+  put32(header, zip64 ? ZIP32_LIMIT : 0);
+  put16(header, name.size());
+  put16(header, zip64 ? 20 : 0);
+  header += name;
+  if (zip64) {
+    put16(header, 0x0001);
+    put16(header, 16);
+    put64(header, 0);
+    put64(header, 0);
+  }
+  put(header);
+}
+
+void ZipWriter::write(std::string text)
+{
+  if (!queue.empty() && !queue.back().generator &&
+      queue.back().text.size() + text.size() <= MAX_TEXT_CHUNK_SIZE) {
+    queue.back().text += text;
+    return;
+  }
+  queue.push_back({.text = std::move(text)});
+  if (queue.size() >= CHUNKS_PER_BATCH) flush();
+}
+
+void ZipWriter::write(std::function<std::string()> generator)
+{
+  queue.push_back({.generator = std::move(generator)});
+  if (queue.size() >= CHUNKS_PER_BATCH) flush();
+}
+
+void ZipWriter::flush()
+{
+  std::vector<DeflatedChunk> deflated(queue.size());
+  parallelizable_transform(queue.begin(), queue.end(), deflated.begin(), [](const Chunk& chunk) {
+    return deflateChunk(chunk.generator ? chunk.generator() : chunk.text);
+  });
+  queue.clear();
+
+  auto& entry = entries.back();
+  for (const auto& chunk : deflated) {
+    entry.crc = crc32_combine(entry.crc, chunk.crc, chunk.size);
+    entry.size += chunk.size;
+    entry.compressed_size += chunk.data.size();
+    put(chunk.data);
+  }
+}
+
+bool ZipWriter::endEntry()
+{
+  flush();
+  auto& entry = entries.back();
+  // Terminate the deflate stream with an empty final block using fixed codes
+  const std::string final_block("\x03\x00", 2);
+  entry.compressed_size += final_block.size();
+  put(final_block);
+
+  std::string descriptor;
+  put32(descriptor, 0x08074b50);
+  put32(descriptor, entry.crc);
+  if (entry.zip64) {
+    put64(descriptor, entry.compressed_size);
+    put64(descriptor, entry.size);
+  } else {
+    put32(descriptor, entry.compressed_size);
+    put32(descriptor, entry.size);
+  }
+  put(descriptor);
+  return entry.zip64 || (entry.compressed_size < ZIP32_LIMIT && entry.size < ZIP32_LIMIT);
+}
+
+bool ZipWriter::finish()
+{
+  const uint64_t cd_offset = offset;
+  for (const auto& entry : entries) {
+    const bool large_offset = entry.offset >= ZIP32_LIMIT;
+    std::string extra;
+    if (entry.zip64) {
+      put64(extra, entry.size);
+      put64(extra, entry.compressed_size);
+    }
+    if (large_offset) put64(extra, entry.offset);
+    if (!extra.empty()) {
+      std::string field;
+      put16(field, 0x0001);
+      put16(field, extra.size());
+      extra = field + extra;
+    }
+
+    const uint16_t version = entry.zip64 || large_offset ? VERSION_ZIP64 : VERSION_DEFAULT;
+    std::string header;
+    put32(header, 0x02014b50);
+    put16(header, version);
+    put16(header, version);
+    put16(header, FLAG_DATA_DESCRIPTOR);
+    put16(header, METHOD_DEFLATE);
+    put16(header, DOS_TIME);
+    put16(header, DOS_DATE);
+    put32(header, entry.crc);
+    put32(header, entry.zip64 ? ZIP32_LIMIT : entry.compressed_size);
+    put32(header, entry.zip64 ? ZIP32_LIMIT : entry.size);
+    put16(header, entry.name.size());
+    put16(header, extra.size());
+    put16(header, 0);  // comment length
+    put16(header, 0);  // disk number
+    put16(header, 0);  // internal attributes
+    put32(header, 0);  // external attributes
+    put32(header, large_offset ? ZIP32_LIMIT : entry.offset);
+    header += entry.name;
+    header += extra;
+    put(header);
+  }
+  const uint64_t cd_size = offset - cd_offset;
+
+  std::string end;
+  const bool zip64 = cd_offset >= ZIP32_LIMIT || cd_size >= ZIP32_LIMIT || entries.size() >= 0xffff;
+  if (zip64) {
+    const uint64_t zip64_end_offset = offset;
+    put32(end, 0x06064b50);
+    put64(end, 44);  // size of the remaining record
+    put16(end, VERSION_ZIP64);
+    put16(end, VERSION_ZIP64);
+    put32(end, 0);  // disk number
+    put32(end, 0);  // disk with central directory
+    put64(end, entries.size());
+    put64(end, entries.size());
+    put64(end, cd_size);
+    put64(end, cd_offset);
+
+    put32(end, 0x07064b50);
+    put32(end, 0);  // disk with zip64 end of central directory
+    put64(end, zip64_end_offset);
+    put32(end, 1);  // number of disks
+  }
+  put32(end, 0x06054b50);
+  put16(end, 0);  // disk number
+  put16(end, 0);  // disk with central directory
+  put16(end, zip64 ? 0xffff : entries.size());
+  put16(end, zip64 ? 0xffff : entries.size());
+  put32(end, zip64 ? ZIP32_LIMIT : cd_size);
+  put32(end, zip64 ? ZIP32_LIMIT : cd_offset);
+  put16(end, 0);  // comment length
+  put(end);
+  output.flush();
+  return output.good();
+}
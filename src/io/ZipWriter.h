@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*!
+   Writes a zip archive sequentially to a stream, which doesn't need to be seekable.
+
+   The content of an entry is appended in chunks, either as text or as a generator
+   producing the text. Queued chunks are generated and deflated in parallel as
+   independent pieces of a single deflate stream, and written out in order, so the
+   memory used is bounded by the queue instead of the size of the entry.
+ */
+class ZipWriter
+{
+public:
+  ZipWriter(std::ostream& output) : output(output) {}
+
+  // zip64 has to be requested for entries which may reach 4 GiB
+  void beginEntry(const std::string& name, bool zip64 = false);
+  void write(std::string text);
+  void write(std::function<std::string()> generator);
+  // Returns false if the entry got too large for its format
+  bool endEntry();
+  // Writes the central directory. Returns false if writing to the stream failed.
+  bool finish();
+
+private:
+  struct Chunk {
+    std::string text;
+    std::function<std::string()> generator;
+  };
+
+  struct Entry {
+    std::string name;
+    bool zip64;
+    uint64_t offset;
+    uint32_t crc{0};
+    uint64_t compressed_size{0};
+    uint64_t size{0};
+  };
+
+  void flush();
+  void put(const std::string& data);
+
+  std::ostream& output;
+  uint64_t offset{0};
+  std::vector<Entry> entries;
+  std::vector<Chunk> queue;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+class PolySet;
+
+/*!
+   OpenSCAD's native binary mesh format, laid out so it can be mapped into memory
+   and copied into a PolySet without parsing.
+
+   The file is a Header followed by these sections, each starting at a
+   multiple of 8 bytes:
+
+   - key: key_size bytes identifying the source a cached mesh was made from,
+     empty in exported files
+   - vertices: num_vertices * 3 doubles
+   - indices: num_indices int32 vertex indices of all polygons, concatenated
+   - polygon sizes: num_polygons uint32 vertex counts
+   - colors: num_colors * 4 floats (RGBA)
+   - color indices: num_polygons int32 indices into colors, -1 for no color
+     (only present if FLAG_COLOR_INDICES is set)
+
+   All values are stored in the byte order of the machine writing the file,
+   which is recorded in the header. This is meant as a fast cache and exchange
+   format between OpenSCAD runs, not as a portable archival format.
+ */
+namespace binmesh {
+
+constexpr char MAGIC[8] = {'O', 'S', 'C', 'M', 'E', 'S', 'H', '\0'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint32_t VERSION = 2;
+
+constexpr uint32_t FLAG_TRIANGULAR = 1 << 0;
+constexpr uint32_t FLAG_MANIFOLD = 1 << 1;
+constexpr uint32_t FLAG_COLOR_INDICES = 1 << 2;
+
+struct Header {
+  char magic[8];
+  uint32_t byte_order;
+  uint32_t version;
+  uint32_t flags;
+  uint32_t dimension;
+  uint64_t num_vertices;
+  uint64_t num_indices;
+  uint64_t num_polygons;
+  uint64_t num_colors;
+  uint64_t key_size;
+};
+static_assert(sizeof(Header) == 64, "Unexpected padding in binmesh::Header");
+
+constexpr size_t align(size_t size)
+{
+  return (size + 7) & ~size_t{7};
+}
+
+// Size of the file described by header
+size_t fileSize(const Header& header);
+
+void write(const PolySet& ps, std::ostream& output, const std::string& key = {});
+
+}  // namespace binmesh
@@ -0,0 +1,191 @@
+#include "io/binmesh.h"
+
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "core/AST.h"
+#include "geometry/PolySet.h"
+#include "io/import.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::unique_ptr<PolySet> tetrahedron(double size)
+{
+  auto ps = std::make_unique<PolySet>(3);
+  ps->vertices = {{0, 0, 0}, {size, 0, 0}, {0, size, 0}, {0, 0, size}};
+  ps->indices = {{0, 2, 1}, {0, 1, 3}, {0, 3, 2}, {1, 2, 3}};
+  ps->setTriangular(true);
+  ps->setManifold(true);
+  return ps;
+}
+
+struct TempDir {
+  fs::path path;
+  TempDir()
+  {
+    path = fs::temp_directory_path() /
+           ("openscad-binmesh-test-" +
+            std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()));
+    fs::create_directories(path);
+  }
+  ~TempDir()
+  {
+    std::error_code ec;
+    fs::remove_all(path, ec);
+  }
+};
+
+void writeFile(const fs::path& path, const std::string& contents)
+{
+  std::ofstream output(path, std::ios::binary | std::ios::trunc);
+  output << contents;
+}
+
+std::string serialize(const PolySet& ps, const std::string& key = {})
+{
+  std::ostringstream output;
+  binmesh::write(ps, output, key);
+  return output.str();
+}
+
+}  // namespace
+
+TEST_CASE("Import mesh cache reuses entries until the source changes", "[binmesh]")
+{
+  TempDir dir;
+  const auto source = dir.path / "model.stl";
+  const auto cachedir = dir.path / "cache";
+  writeFile(source, "solid a");
+
+  int imports = 0;
+  double size = 1;
+  const auto importer = [&]() {
+    ++imports;
+    return tetrahedron(size);
+  };
+
+  auto ps = import_mesh_cached(source.string(), "stl", importer, cachedir);
+  REQUIRE(imports == 1);
+  REQUIRE(ps->vertices[1].x() == 1);
+#ifndef _WIN32
+  CHECK((fs::status(cachedir).permissions() & (fs::perms::group_all | fs::perms::others_all)) ==
+        fs::perms::none);
+#endif
+
+  SECTION("Hit")
+  {
+    ps = import_mesh_cached(source.string(), "stl", importer, cachedir);
+    CHECK(imports == 1);
+    CHECK(ps->vertices[1].x() == 1);
+    CHECK(ps->indices.size() == 4);
+    CHECK(ps->isManifold());
+  }
+
+  SECTION("Other format of the same file misses")
+  {
+    import_mesh_cached(source.string(), "off", importer, cachedir);
+    CHECK(imports == 2);
+  }
+
+  SECTION("Changed source misses and replaces the entry")
+  {
+    size = 2;
+    writeFile(source, "solid ab");
+    ps = import_mesh_cached(source.string(), "stl", importer, cachedir);
+    CHECK(imports == 2);
+    CHECK(ps->vertices[1].x() == 2);
+    CHECK(std::distance(fs::directory_iterator(cachedir), fs::directory_iterator()) == 1);
+    ps = import_mesh_cached(source.string(), "stl", importer, cachedir);
+    CHECK(imports == 2);
+  }
+
+  SECTION("Entry made from another source is ignored")
+  {
+    // Same file name in the cache, but keyed to some other file
+    for (const auto& entry : fs::directory_iterator(cachedir)) {
+      writeFile(entry.path(), serialize(*tetrahedron(3), "stl:7:0:/elsewhere/model.stl"));
+    }
+    ps = import_mesh_cached(source.string(), "stl", importer, cachedir);
+    CHECK(imports == 2);
+    CHECK(ps->vertices[1].x() == 1);
+  }
+
+  SECTION("Truncated entry is ignored")
+  {
+    for (const auto& entry : fs::directory_iterator(cachedir)) {
+      fs::resize_file(entry.path(), fs::file_size(entry.path()) - 8);
+    }
+    ps = import_mesh_cached(source.string(), "stl", importer, cachedir);
+    CHECK(imports == 2);
+    CHECK(ps->vertices[1].x() == 1);
+  }
+}
+
+TEST_CASE("Imported binmesh files are validated", "[binmesh]")
+{
+  TempDir dir;
+  const auto file = dir.path / "mesh.binmesh";
+  const auto data = serialize(*tetrahedron(1));
+
+  SECTION("Valid file")
+  {
+    writeFile(file, data);
+    auto ps = import_binmesh(file.string(), Location::NONE);
+    CHECK(ps->indices.size() == 4);
+    CHECK(ps->vertices.size() == 4);
+    // Only our own cache entries are trusted to be manifold
+    CHECK_FALSE(ps->isManifold());
+  }
+
+  SECTION("Truncated file")
+  {
+    writeFile(file, data.substr(0, data.size() - 4));
+    CHECK(import_binmesh(file.string(), Location::NONE)->isEmpty());
+  }
+
+  SECTION("Header only")
+  {
+    writeFile(file, data.substr(0, sizeof(binmesh::Header)));
+    CHECK(import_binmesh(file.string(), Location::NONE)->isEmpty());
+  }
+
+  SECTION("Bad magic")
+  {
+    auto bad = data;
+    bad[0] = 'X';
+    writeFile(file, bad);
+    CHECK(import_binmesh(file.string(), Location::NONE)->isEmpty());
+  }
+
+  SECTION("Vertex index out of range")
+  {
+    auto bad = data;
+    // The first index follows the header and the vertices
+    const auto offset = binmesh::align(sizeof(binmesh::Header)) + 4 * 3 * sizeof(double);
+    const int32_t index = 4;
+    bad.replace(offset, sizeof(index), reinterpret_cast<const char *>(&index), sizeof(index));
+    writeFile(file, bad);
+    CHECK(import_binmesh(file.string(), Location::NONE)->isEmpty());
+  }
+
+  SECTION("Huge counts")
+  {
+    auto bad = data;
+    binmesh::Header header;
+    std::memcpy(&header, bad.data(), sizeof(header));
+    header.num_indices = ~uint64_t{0};
+    bad.replace(0, sizeof(header), reinterpret_cast<const char *>(&header), sizeof(header));
+    writeFile(file, bad);
+    CHECK(import_binmesh(file.string(), Location::NONE)->isEmpty());
+  }
+}
@@ -48,6 +48,7 @@
 #include <io.h>
 #endif
 
+#include "Feature.h"
 #include "geometry/Geometry.h"
 #include "geometry/GeometryUtils.h"
 #include "geometry/PolySet.h"
@@ -97,6 +98,7 @@ Containers& containers()
     add_item(*containers, {FileFormat::PNG, "png", "png", "PNG"});
     add_item(*containers, {FileFormat::PDF, "pdf", "pdf", "PDF"});
     add_item(*containers, {FileFormat::POV, "pov", "pov", "POV"});
+    add_item(*containers, {FileFormat::BINMESH, "binmesh", "binmesh", "Binary mesh"});
 
     // Alias
     containers->identifierToInfo["stl"] = containers->identifierToInfo["asciistl"];
@@ -169,7 +171,7 @@ bool is3D(FileFormat format)
   return format == FileFormat::ASCII_STL || format == FileFormat::BINARY_STL ||
          format == FileFormat::OBJ || format == FileFormat::OFF || format == FileFormat::WRL ||
          format == FileFormat::AMF || format == FileFormat::_3MF || format == FileFormat::NEFDBG ||
-         format == FileFormat::NEF3 || format == FileFormat::POV;
+         format == FileFormat::NEF3 || format == FileFormat::POV || format == FileFormat::BINMESH;
 }
 
 bool is2D(FileFormat format)
@@ -205,7 +207,8 @@ ExportInfo createExportInfo(const FileFormat& format, const FileFormatInfo& info
   return exportInfo;
 }
 
-static void exportFile(const std::shared_ptr<const Geometry>& root_geom, std::ostream& output,
+// Returns false if the exporter reported a failure
+static bool exportFile(const std::shared_ptr<const Geometry>& root_geom, std::ostream& output,
                        const ExportInfo& exportInfo)
 {
   switch (exportInfo.format) {
@@ -215,17 +218,24 @@ static void exportFile(const std::shared_ptr<const Geometry>& root_geom, std::os
   case FileFormat::OFF:        export_off(root_geom, output); break;
   case FileFormat::WRL:        export_wrl(root_geom, output); break;
   case FileFormat::AMF:        export_amf(root_geom, output); break;
-  case FileFormat::_3MF:       export_3mf(root_geom, output, exportInfo); break;
+  case FileFormat::_3MF:
+    if (Feature::ExperimentalStreaming3mfExport.is_enabled()) {
+      return export_3mf_streaming(root_geom, output, exportInfo);
+    }
+    export_3mf(root_geom, output, exportInfo);
+    break;
   case FileFormat::DXF:        export_dxf(root_geom, output); break;
   case FileFormat::SVG:        export_svg(root_geom, output, exportInfo); break;
   case FileFormat::PDF:        export_pdf(root_geom, output, exportInfo); break;
   case FileFormat::POV:        export_pov(root_geom, output, exportInfo); break;
+  case FileFormat::BINMESH:    export_binmesh(root_geom, output); break;
 #ifdef ENABLE_CGAL
   case FileFormat::NEFDBG: export_nefdbg(root_geom, output); break;
   case FileFormat::NEF3:   export_nef3(root_geom, output); break;
 #endif
   default: assert(false && "Unknown file format");
   }
+  return true;
 }
 
 bool exportFileStdOut(const std::shared_ptr<const Geometry>& root_geom, const ExportInfo& exportInfo)
@@ -233,8 +243,7 @@ bool exportFileStdOut(const std::shared_ptr<const Geometry>& root_geom, const Ex
 #ifdef _WIN32
   _setmode(_fileno(stdout), _O_BINARY);
 #endif
-  exportFile(root_geom, std::cout, exportInfo);
-  return true;
+  return exportFile(root_geom, std::cout, exportInfo);
 }
 
 bool exportFileByName(const std::shared_ptr<const Geometry>& root_geom, const std::string& filename,
@@ -242,7 +251,7 @@ bool exportFileByName(const std::shared_ptr<const Geometry>& root_geom, const st
 {
   std::ios::openmode mode = std::ios::out | std::ios::trunc;
   if (exportInfo.format == FileFormat::_3MF || exportInfo.format == FileFormat::BINARY_STL ||
-      exportInfo.format == FileFormat::PDF) {
+      exportInfo.format == FileFormat::PDF || exportInfo.format == FileFormat::BINMESH) {
     mode |= std::ios::binary;
   }
   const std::filesystem::path path(filename);
@@ -252,9 +261,10 @@ bool exportFileByName(const std::shared_ptr<const Geometry>& root_geom, const st
     return false;
   } else {
     bool onerror = false;
+    bool exported = false;
     fstream.exceptions(std::ios::badbit | std::ios::failbit);
     try {
-      exportFile(root_geom, fstream, exportInfo);
+      exported = exportFile(root_geom, fstream, exportInfo);
     } catch (std::ios::failure&) {
       onerror = true;
     }
@@ -266,7 +276,7 @@ bool exportFileByName(const std::shared_ptr<const Geometry>& root_geom, const st
     if (onerror) {
       LOG(message_group::Error, _("\"%1$s\" write error. (Disk full?)"), filename);
     }
-    return !onerror;
+    return exported && !onerror;
   }
 }
 
@@ -44,7 +44,8 @@ enum class FileFormat {
   PNG,
   PDF,
   POV,
-  PARAM
+  PARAM,
+  BINMESH
 };
 
 struct FileFormatInfo {
@@ -311,8 +312,11 @@ bool exportFileStdOut(const std::shared_ptr<const class Geometry>& root_geom,
 void export_stl(const std::shared_ptr<const Geometry>& geom, std::ostream& output, bool binary = true);
 void export_3mf(const std::shared_ptr<const Geometry>& geom, std::ostream& output,
                 const ExportInfo& exportInfo);
+bool export_3mf_streaming(const std::shared_ptr<const Geometry>& geom, std::ostream& output,
+                          const ExportInfo& exportInfo);
 void export_obj(const std::shared_ptr<const Geometry>& geom, std::ostream& output);
 void export_off(const std::shared_ptr<const Geometry>& geom, std::ostream& output);
+void export_binmesh(const std::shared_ptr<const Geometry>& geom, std::ostream& output);
 void export_wrl(const std::shared_ptr<const Geometry>& geom, std::ostream& output);
 void export_amf(const std::shared_ptr<const Geometry>& geom, std::ostream& output);
 void export_dxf(const std::shared_ptr<const Geometry>& geom, std::ostream& output);
@@ -364,6 +368,23 @@ std::unique_ptr<OffscreenView> prepare_preview(Tree& tree, const ViewOptions& op
 bool export_png(const std::shared_ptr<const class Geometry>& root_geom, const ViewOptions& options,
                 Camera& camera, std::ostream& output);
 bool export_png(const OffscreenView& glview, std::ostream& output);
+
+// One image of a batch rendered by export_png_views()
+struct PngView {
+  std::string filename;
+  Camera camera;
+  ViewOptions options;
+  // Empty for the current render color scheme
+  std::string colorscheme;
+};
+
+// Reads a list of views from a JSON file, using camera and options as defaults
+bool read_png_views(const std::string& filename, const Camera& camera, const ViewOptions& options,
+                    std::vector<PngView>& views);
+// Renders each view into its own PNG file, sharing offscreen contexts between views
+bool export_png_views(const std::shared_ptr<const class Geometry>& root_geom,
+                      std::vector<PngView>& views);
+bool export_png_views(Tree& tree, Previewer previewer, std::vector<PngView>& views);
 bool export_param(SourceFile *root, const fs::path& path, std::ostream& output);
 
 std::unique_ptr<PolySet> createSortedPolySet(const PolySet& ps);
@@ -0,0 +1,509 @@
+/*
+ *  OpenSCAD (www.openscad.org)
+ *  Copyright (C) 2009-2025 Clifford Wolf <clifford@clifford.at> and
+ *                          Marius Kintel <marius@kintel.net>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  As a special exception, you have permission to link this program
+ *  with the CGAL library and distribute executables, as long as you
+ *  follow the requirements of the GNU GPL in regard to all of the
+ *  software in the executable aside from CGAL.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Feature.h"
+#include "core/ColorUtil.h"
+#include "export_enums.h"
+#include "geometry/Geometry.h"
+#include "geometry/PolySet.h"
+#include "geometry/PolySetUtils.h"
+#include "geometry/linalg.h"
+#include "io/ZipWriter.h"
+#include "io/export.h"
+#include "utils/printutils.h"
+
+#ifdef ENABLE_CGAL
+#include "geometry/cgal/CGALNefGeometry.h"
+#include "geometry/cgal/cgalutils.h"
+#endif
+#ifdef ENABLE_MANIFOLD
+#include "geometry/manifold/ManifoldGeometry.h"
+#endif
+
+namespace {
+
+// Number of vertices or triangles formatted and compressed as one chunk
+constexpr size_t ELEMENTS_PER_CHUNK = 16384;
+
+// One <object> of the model. Its geometry is only converted to a mesh while it's written.
+struct Part {
+  std::shared_ptr<const Geometry> geom;
+  std::string name;
+  std::string partnumber;
+  // Index into the material group for each color of the mesh, or -1 if unused
+  std::vector<int> materials;
+};
+
+// A part converted to a triangle mesh
+struct Mesh {
+  std::shared_ptr<const PolySet> ps;
+  std::vector<int> materials;
+};
+
+struct ExportContext {
+  std::vector<Part> parts;
+  int modelcount;
+};
+
+// Base materials or colors, referenced by the triangles
+struct MaterialGroup {
+  Export3mfMaterialType type;
+  std::vector<Color4f> colors;
+  std::unordered_map<Color4f, int> index;
+};
+
+std::string quote_xml(const std::string& value)
+{
+  std::string quoted;
+  quoted.reserve(value.size());
+
+  for (const char c : value) {
+    switch (c) {
+    case '&':  quoted += "&amp;"; break;
+    case '<':  quoted += "&lt;"; break;
+    case '>':  quoted += "&gt;"; break;
+    case '"':  quoted += "&quot;"; break;
+    case '\'': quoted += "&apos;"; break;
+    default:   quoted += c; break;
+    }
+  }
+
+  return quoted;
+}
+
+std::string color_to_hex(const Color4f& col, bool opaque = false)
+{
+  uint8_t r, g, b, a;
+  if (!col.getRgba(r, g, b, a)) {
+    LOG(message_group::Warning, "Invalid color in 3MF export");
+  }
+  if (opaque) a = 0xff;
+  char buf[10];
+  snprintf(buf, sizeof(buf), "#%02X%02X%02X%02X", r, g, b, a);
+  return buf;
+}
+
+class UuidGenerator
+{
+public:
+  std::string operator()()
+  {
+    std::uniform_int_distribution<uint32_t> dist(0, 0xffff);
+    uint16_t w[8];
+    for (auto& v : w) v = dist(engine);
+    w[3] = (w[3] & 0x0fff) | 0x4000;  // version 4
+    w[4] = (w[4] & 0x3fff) | 0x8000;  // RFC 4122 variant
+    char buf[40];
+    snprintf(buf, sizeof(buf), "%04x%04x-%04x-%04x-%04x-%04x%04x%04x", w[0], w[1], w[2], w[3], w[4],
+             w[5], w[6], w[7]);
+    return buf;
+  }
+
+private:
+  // Predictible output gets the same UUIDs on every export
+  std::mt19937 engine{Feature::ExperimentalPredictibleOutput.is_enabled() ? std::mt19937::default_seed
+                                                                          : std::random_device{}()};
+};
+
+void append_float(std::string& out, float value, int precision)
+{
+  if (value == 0) {
+    out += '0';
+    return;
+  }
+  char buf[64];
+  const int len = snprintf(buf, sizeof(buf), "%.*f", precision, value);
+  out.append(buf, std::min<size_t>(len, sizeof(buf) - 1));
+}
+
+std::string vertices_xml(const PolySet& ps, size_t begin, size_t end, int precision)
+{
+  std::string xml;
+  for (size_t i = begin; i < end; ++i) {
+    const auto f = ps.vertices[i].cast<float>();
+    xml += "\t\t\t\t\t<vertex x=\"";
+    append_float(xml, f[0], precision);
+    xml += "\" y=\"";
+    append_float(xml, f[1], precision);
+    xml += "\" z=\"";
+    append_float(xml, f[2], precision);
+    xml += "\" />\n";
+  }
+  return xml;
+}
+
+std::string triangles_xml(const Mesh& mesh, size_t begin, size_t end, int material_group_id)
+{
+  const auto& ps = *mesh.ps;
+  std::string xml;
+  for (size_t i = begin; i < end; ++i) {
+    const auto& t = ps.indices[i];
+    xml += "\t\t\t\t\t<triangle v1=\"" + std::to_string(t[0]) + "\" v2=\"" + std::to_string(t[1]) +
+           "\" v3=\"" + std::to_string(t[2]) + "\"";
+    const int color_index = i < ps.color_indices.size() ? ps.color_indices[i] : -1;
+    if (color_index >= 0 && static_cast<size_t>(color_index) < mesh.materials.size() &&
+        mesh.materials[color_index] >= 0) {
+      xml += " pid=\"" + std::to_string(material_group_id) + "\" p1=\"" +
+             std::to_string(mesh.materials[color_index]) + "\"";
+    }
+    xml += " />\n";
+  }
+  return xml;
+}
+
+bool append_part(const std::shared_ptr<const Geometry>& geom, ExportContext& ctx)
+{
+  const int part_count = ctx.parts.size() + 1;
+  Part part;
+  part.geom = geom;
+  part.name = ctx.modelcount == 1 ? "OpenSCAD Model" : "OpenSCAD Model " + std::to_string(part_count);
+  part.partnumber = ctx.modelcount == 1 ? "" : "Part " + std::to_string(part_count);
+  ctx.parts.push_back(std::move(part));
+  return true;
+}
+
+#ifdef ENABLE_CGAL
+bool append_nef(const std::shared_ptr<const CGALNefGeometry>& root_N, ExportContext& ctx)
+{
+  if (!root_N->p3) {
+    LOG(message_group::Export_Error, "Export failed, empty geometry.");
+    return false;
+  }
+
+  if (!root_N->p3->is_simple()) {
+    LOG(message_group::Export_Warning,
+        "Exported object may not be a valid 2-manifold and may need repair");
+  }
+  return append_part(root_N, ctx);
+}
+#endif  // ifdef ENABLE_CGAL
+
+bool append_3mf(const std::shared_ptr<const Geometry>& geom, ExportContext& ctx)
+{
+  if (const auto geomlist = std::dynamic_pointer_cast<const GeometryList>(geom)) {
+    ctx.modelcount = geomlist->getChildren().size();
+    for (const auto& item : geomlist->getChildren()) {
+      if (!append_3mf(item.second, ctx)) return false;
+    }
+#ifdef ENABLE_CGAL
+  } else if (const auto N = std::dynamic_pointer_cast<const CGALNefGeometry>(geom)) {
+    return append_nef(N, ctx);
+#endif
+  } else if (std::dynamic_pointer_cast<const Polygon2d>(geom)) {
+    assert(false && "Unsupported file format");
+  } else {
+    return append_part(geom, ctx);
+  }
+
+  return true;
+}
+
+// Converts the geometry of a part to a triangle mesh, or returns nullptr on failure
+std::shared_ptr<const PolySet> to_mesh(const Geometry& geom)
+{
+  std::shared_ptr<const PolySet> ps;
+#ifdef ENABLE_CGAL
+  if (const auto N = dynamic_cast<const CGALNefGeometry *>(&geom)) {
+    ps = CGALUtils::createPolySetFromNefPolyhedron3(*N->p3);
+    if (!ps) LOG(message_group::Export_Error, "Error converting NEF Polyhedron.");
+  }
+#endif
+#ifdef ENABLE_MANIFOLD
+  if (const auto mani = dynamic_cast<const ManifoldGeometry *>(&geom)) {
+    ps = mani->toPolySet();
+  }
+#endif
+  if (const auto polyset = dynamic_cast<const PolySet *>(&geom)) {
+    ps = PolySetUtils::tessellate_faces(*polyset);
+  }
+  if (ps && Feature::ExperimentalPredictibleOutput.is_enabled()) return createSortedPolySet(*ps);
+  return ps;
+}
+
+// Only meshes of these geometries can have colors
+bool may_have_colors(const Geometry& geom)
+{
+#ifdef ENABLE_MANIFOLD
+  if (dynamic_cast<const ManifoldGeometry *>(&geom)) return true;
+#endif
+  return dynamic_cast<const PolySet *>(&geom) != nullptr;
+}
+
+// Assigns material indices to the colors used by the parts, in the order they are
+// first referenced by a triangle. The materials have to be written before the objects,
+// so this converts each colored part once more, one at a time.
+bool assign_materials(ExportContext& ctx, MaterialGroup& group)
+{
+  for (auto& part : ctx.parts) {
+    if (!may_have_colors(*part.geom)) continue;
+    const auto mesh = to_mesh(*part.geom);
+    if (!mesh) return false;
+    const auto& ps = *mesh;
+    part.materials.assign(ps.colors.size(), -1);
+    for (size_t i = 0; i < ps.indices.size() && i < ps.color_indices.size(); ++i) {
+      const int color_index = ps.color_indices[i];
+      if (color_index < 0 || part.materials[color_index] >= 0) continue;
+      const Color4f& col = ps.colors[color_index];
+      const auto it = group.index.find(col);
+      if (it != group.index.end()) {
+        part.materials[color_index] = it->second;
+      } else {
+        part.materials[color_index] = group.colors.size();
+        group.index.emplace(col, group.colors.size());
+        group.colors.push_back(col);
+      }
+    }
+  }
+  return true;
+}
+
+std::string material_group_xml(const MaterialGroup& group)
+{
+  std::string xml;
+  if (group.type == Export3mfMaterialType::basematerial) {
+    xml += "\t\t<basematerials id=\"1\">\n";
+    for (size_t i = 0; i < group.colors.size(); ++i) {
+      const auto name = i == 0 ? std::string("Default") : "Color " + std::to_string(i);
+      xml += "\t\t\t<base name=\"" + name + "\" displaycolor=\"" +
+             color_to_hex(group.colors[i], i == 0) + "\" />\n";
+    }
+    xml += "\t\t</basematerials>\n";
+  } else {
+    xml += "\t\t<m:colorgroup id=\"1\">\n";
+    for (const auto& col : group.colors) {
+      xml += "\t\t\t<m:color color=\"" + color_to_hex(col) + "\" />\n";
+    }
+    xml += "\t\t</m:colorgroup>\n";
+  }
+  return xml;
+}
+
+// Upper bound of the size of the model XML, to decide whether it needs zip64. Only uses
+// what the geometries know without converting them.
+uint64_t estimate_model_size(const ExportContext& ctx, int precision)
+{
+  uint64_t size = 1ul << 20;  // headers, metadata and materials
+  for (const auto& part : ctx.parts) {
+    const auto bbox = part.geom->getBoundingBox();
+    double max_abs = 1;
+    if (!bbox.isEmpty()) {
+      max_abs = std::max({max_abs, bbox.min().cwiseAbs().maxCoeff(), bbox.max().cwiseAbs().maxCoeff()});
+    }
+    // Triangulating a polygon of n vertices gives n - 2 triangles, and every triangle
+    // adds at most 3 vertices
+    uint64_t triangles = part.geom->numFacets();
+    if (const auto ps = std::dynamic_pointer_cast<const PolySet>(part.geom)) {
+      triangles = 0;
+      for (const auto& poly : ps->indices) triangles += std::max<size_t>(poly.size(), 3) - 2;
+    }
+#ifdef ENABLE_CGAL
+    if (const auto N = std::dynamic_pointer_cast<const CGALNefGeometry>(part.geom)) {
+      // Holes in facets add triangles, but never more than there are halfedges
+      triangles = N->p3->number_of_halfedges();
+    }
+#endif
+    const uint64_t vertices = 3 * triangles;
+    const uint64_t float_size = std::ceil(std::log10(max_abs + 1)) + precision + 3;
+    const uint64_t index_size = std::to_string(std::max<uint64_t>(vertices, 1)).size();
+    size += 1024 + vertices * (40 + 3 * float_size) + triangles * (80 + 3 * index_size);
+  }
+  return size;
+}
+
+void add_meta_data(std::string& xml, const std::string& name, const std::string& value,
+                   const std::string& value2 = "")
+{
+  const std::string v = value.empty() ? value2 : value;
+  if (v.empty()) {
+    return;
+  }
+
+  xml += "\t<metadata name=\"" + name + "\" preserve=\"1\">" + quote_xml(v) + "</metadata>\n";
+}
+
+std::string unit_name(Export3mfUnit unit)
+{
+  switch (unit) {
+  case Export3mfUnit::micron:     return "micron";
+  case Export3mfUnit::centimeter: return "centimeter";
+  case Export3mfUnit::meter:      return "meter";
+  case Export3mfUnit::inch:       return "inch";
+  case Export3mfUnit::foot:       return "foot";
+  default:                        return "millimeter";
+  }
+}
+
+const std::string CONTENT_TYPES_XML =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+  "<Default Extension=\"rels\" "
+  "ContentType=\"application/vnd.openxmlformats-package.relationships+xml\" />"
+  "<Default Extension=\"model\" "
+  "ContentType=\"application/vnd.ms-package.3dmanufacturing-3dmodel+xml\" />"
+  "</Types>\n";
+
+const std::string RELS_XML =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+  "<Relationship Type=\"http://schemas.microsoft.com/3dmanufacturing/2013/01/3dmodel\" "
+  "Target=\"/3D/3dmodel.model\" Id=\"rel0\" />"
+  "</Relationships>\n";
+
+}  // namespace
+
+/*!
+    Saves the current 3D Geometry as 3MF to the given file.
+    The file must be open.
+
+    The model is streamed into the zip package in chunks, which are formatted and
+    compressed in parallel. Each part is only converted to a mesh when its object is
+    written, and released once its chunks are compressed.
+
+    Returns false if the export failed.
+ */
+bool export_3mf_streaming(const std::shared_ptr<const Geometry>& geom, std::ostream& output,
+                          const ExportInfo& exportInfo)
+{
+  ExportContext ctx{.modelcount = 1};
+  if (!append_3mf(geom, ctx)) {
+    return false;
+  }
+
+  const auto& options3mf =
+    exportInfo.options3mf ? exportInfo.options3mf : std::make_shared<Export3mfOptions>();
+  const int precision = options3mf->decimalPrecision;
+
+  // use default color that ultimately should come from the color scheme
+  Color4f color = exportInfo.defaultColor;
+
+  std::unique_ptr<MaterialGroup> group;
+  if (options3mf->colorMode != Export3mfColorMode::none) {
+    if (options3mf->colorMode != Export3mfColorMode::model) {
+      // use color selected in the export dialog and stored in settings (if valid)
+      color = OpenSCAD::getColor(options3mf->color, exportInfo.defaultColor);
+    }
+    group = std::make_unique<MaterialGroup>();
+    group->type = options3mf->materialType;
+    group->colors.push_back(color);
+    // A triangle of the default color references the default base material,
+    // while a color group gets an additional entry for it.
+    if (group->type == Export3mfMaterialType::basematerial) group->index.emplace(color, 0);
+    if (options3mf->colorMode != Export3mfColorMode::selected_only) {
+      if (!assign_materials(ctx, *group)) return false;
+    }
+  }
+  const int first_object_id = group ? 2 : 1;
+
+  UuidGenerator uuid;
+  std::string xml = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
+  xml += "<model xmlns=\"http://schemas.microsoft.com/3dmanufacturing/core/2015/02\" unit=\"" +
+         unit_name(options3mf->unit) +
+         "\" xml:lang=\"en-US\""
+         " xmlns:m=\"http://schemas.microsoft.com/3dmanufacturing/material/2015/02\""
+         " xmlns:p=\"http://schemas.microsoft.com/3dmanufacturing/production/2015/06\">\n";
+  if (options3mf->addMetaData) {
+    add_meta_data(xml, "Title", options3mf->metaDataTitle, exportInfo.title);
+    add_meta_data(xml, "Application", EXPORT_CREATOR);
+    add_meta_data(xml, "CreationDate", get_current_iso8601_date_time_utc());
+    add_meta_data(xml, "Designer", options3mf->metaDataDesigner);
+    add_meta_data(xml, "Description", options3mf->metaDataDescription);
+    add_meta_data(xml, "Copyright", options3mf->metaDataCopyright);
+    add_meta_data(xml, "LicenseTerms", options3mf->metaDataLicenseTerms);
+    add_meta_data(xml, "Rating", options3mf->metaDataRating);
+  }
+  xml += "\t<resources>\n";
+  if (group) xml += material_group_xml(*group);
+
+  ZipWriter zip(output);
+  zip.beginEntry("[Content_Types].xml");
+  zip.write(CONTENT_TYPES_XML);
+  zip.endEntry();
+  zip.beginEntry("_rels/.rels");
+  zip.write(RELS_XML);
+  zip.endEntry();
+
+  zip.beginEntry("3D/3dmodel.model", estimate_model_size(ctx, precision) >= 0xf0000000ul);
+  zip.write(std::move(xml));
+  for (size_t m = 0; m < ctx.parts.size() && output.good(); ++m) {
+    auto& part = ctx.parts[m];
+    // The chunks share the mesh, which is released once the last of them is compressed
+    auto mesh = std::make_shared<Mesh>();
+    mesh->ps = to_mesh(*part.geom);
+    if (!mesh->ps) return false;
+    mesh->materials = std::move(part.materials);
+    const size_t num_vertices = mesh->ps->vertices.size();
+    const size_t num_triangles = mesh->ps->indices.size();
+
+    std::string header = "\t\t<object id=\"" + std::to_string(first_object_id + m) + "\" name=\"" +
+                         quote_xml(part.name) + "\" type=\"model\" p:UUID=\"" + uuid() + "\"";
+    if (group) header += " pid=\"1\" pindex=\"0\"";
+    header += ">\n\t\t\t<mesh>\n\t\t\t\t<vertices>\n";
+    zip.write(std::move(header));
+    for (size_t i = 0; i < num_vertices; i += ELEMENTS_PER_CHUNK) {
+      const size_t end = std::min(i + ELEMENTS_PER_CHUNK, num_vertices);
+      zip.write([mesh, i, end, precision]() { return vertices_xml(*mesh->ps, i, end, precision); });
+    }
+    zip.write(std::string("\t\t\t\t</vertices>\n\t\t\t\t<triangles>\n"));
+    for (size_t i = 0; i < num_triangles; i += ELEMENTS_PER_CHUNK) {
+      const size_t end = std::min(i + ELEMENTS_PER_CHUNK, num_triangles);
+      zip.write([mesh, i, end]() { return triangles_xml(*mesh, i, end, 1); });
+    }
+    zip.write(std::string("\t\t\t\t</triangles>\n\t\t\t</mesh>\n\t\t</object>\n"));
+  }
+  std::string footer = "\t</resources>\n\t<build p:UUID=\"" + uuid() + "\">\n";
+  for (size_t m = 0; m < ctx.parts.size(); ++m) {
+    footer += "\t\t<item objectid=\"" + std::to_string(first_object_id + m) + "\"";
+    if (!ctx.parts[m].partnumber.empty()) {
+      footer += " partnumber=\"" + quote_xml(ctx.parts[m].partnumber) + "\"";
+    }
+    footer += " p:UUID=\"" + uuid() + "\" />\n";
+  }
+  footer += "\t</build>\n</model>\n";
+  zip.write(std::move(footer));
+  if (!zip.endEntry()) {
+    LOG(message_group::Export_Error, "3MF model too large for export.");
+    return false;
+  }
+  if (!zip.finish()) {
+    LOG(message_group::Export_Error, "Error writing 3MF package.");
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,108 @@
+#include "io/binmesh.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "Feature.h"
+#include "geometry/Geometry.h"
+#include "geometry/PolySet.h"
+#include "geometry/PolySetUtils.h"
+#include "geometry/linalg.h"
+#include "io/export.h"
+
+static_assert(sizeof(Vector3d) == 3 * sizeof(double), "Vector3d must be tightly packed");
+static_assert(sizeof(int) == sizeof(int32_t), "Vertex indices must be 32 bit");
+
+namespace {
+
+void pad(std::ostream& output, size_t written)
+{
+  static const char zeros[8] = {};
+  output.write(zeros, static_cast<std::streamsize>(binmesh::align(written) - written));
+}
+
+}  // namespace
+
+namespace binmesh {
+
+size_t fileSize(const Header& header)
+{
+  size_t size = align(sizeof(Header));
+  size += align(header.key_size);
+  size += align(header.num_vertices * 3 * sizeof(double));
+  size += align(header.num_indices * sizeof(int32_t));
+  size += align(header.num_polygons * sizeof(uint32_t));
+  size += align(header.num_colors * 4 * sizeof(float));
+  if (header.flags & FLAG_COLOR_INDICES) size += align(header.num_polygons * sizeof(int32_t));
+  return size;
+}
+
+void write(const PolySet& ps, std::ostream& output, const std::string& key)
+{
+  Header header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.byte_order = BYTE_ORDER_MARK;
+  header.version = VERSION;
+  header.dimension = ps.getDimension();
+  header.num_vertices = ps.vertices.size();
+  header.num_polygons = ps.indices.size();
+  header.num_colors = ps.colors.size();
+  header.key_size = key.size();
+  for (const auto& poly : ps.indices) header.num_indices += poly.size();
+  if (ps.isTriangular()) header.flags |= FLAG_TRIANGULAR;
+  if (ps.isManifold()) header.flags |= FLAG_MANIFOLD;
+  if (!ps.color_indices.empty()) header.flags |= FLAG_COLOR_INDICES;
+
+  output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  pad(output, sizeof(header));
+
+  output.write(key.data(), static_cast<std::streamsize>(key.size()));
+  pad(output, key.size());
+
+  const size_t vertices_size = ps.vertices.size() * sizeof(Vector3d);
+  output.write(reinterpret_cast<const char *>(ps.vertices.data()),
+               static_cast<std::streamsize>(vertices_size));
+  pad(output, vertices_size);
+
+  for (const auto& poly : ps.indices) {
+    output.write(reinterpret_cast<const char *>(poly.data()),
+                 static_cast<std::streamsize>(poly.size() * sizeof(int32_t)));
+  }
+  pad(output, header.num_indices * sizeof(int32_t));
+
+  for (const auto& poly : ps.indices) {
+    const auto size = static_cast<uint32_t>(poly.size());
+    output.write(reinterpret_cast<const char *>(&size), sizeof(size));
+  }
+  pad(output, header.num_polygons * sizeof(uint32_t));
+
+  for (const auto& color : ps.colors) {
+    const float rgba[4] = {color.r(), color.g(), color.b(), color.a()};
+    output.write(reinterpret_cast<const char *>(rgba), sizeof(rgba));
+  }
+  pad(output, header.num_colors * 4 * sizeof(float));
+
+  if (header.flags & FLAG_COLOR_INDICES) {
+    // Polygons past the end of color_indices have no color
+    for (size_t i = 0; i < ps.indices.size(); ++i) {
+      const int32_t color_index = i < ps.color_indices.size() ? ps.color_indices[i] : -1;
+      output.write(reinterpret_cast<const char *>(&color_index), sizeof(color_index));
+    }
+    pad(output, header.num_polygons * sizeof(int32_t));
+  }
+}
+
+}  // namespace binmesh
+
+void export_binmesh(const std::shared_ptr<const Geometry>& geom, std::ostream& output)
+{
+  auto ps = PolySetUtils::getGeometryAsPolySet(geom);
+  if (Feature::ExperimentalPredictibleOutput.is_enabled()) {
+    ps = createSortedPolySet(*ps);
+  }
+  binmesh::write(*ps, output);
+}
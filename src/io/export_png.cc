@@ -1,8 +1,17 @@
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <memory>
+#include <numeric>
 #include <ostream>
+#include <utility>
+#include <vector>
 
+#include "RenderStatistic.h"
 #include "core/Tree.h"
 #include "geometry/Geometry.h"
 #include "geometry/linalg.h"
@@ -35,6 +44,106 @@ void setupCamera(Camera& cam, const BoundingBox& bbox)
   if (cam.viewall) cam.viewAll(bbox);
 }
 
+std::shared_ptr<Renderer> createGeometryRenderer(const std::shared_ptr<const Geometry>& root_geom)
+{
+#if defined(USE_POLYSET_FOR_CGAL)
+  return std::make_shared<PolySetRenderer>(root_geom);
+#else
+  // Choose PolySetRenderer for PolySet and Polygon2d, and for Manifold since we
+  // know that all geometries are convertible to PolySet.
+  if (RenderSettings::inst()->backend3D == RenderBackend3D::ManifoldBackend ||
+      std::dynamic_pointer_cast<const PolySet>(root_geom) ||
+      std::dynamic_pointer_cast<const Polygon2d>(root_geom)) {
+    return std::make_shared<PolySetRenderer>(root_geom);
+  }
+  return std::make_shared<CGALRenderer>(root_geom);
+#endif
+}
+
+std::shared_ptr<Renderer> createPreviewRenderer(const CsgInfo& csgInfo, Previewer previewer)
+{
+  if (previewer == Previewer::OPENCSG) {
+#ifdef ENABLE_OPENCSG
+    PRINTD("Initializing OpenCSGRenderer");
+    return std::make_shared<OpenCSGRenderer>(csgInfo.root_products, csgInfo.highlights_products,
+                                             csgInfo.background_products);
+#else
+    fprintf(stderr, "This openscad was built without OpenCSG support\n");
+    return nullptr;
+#endif
+  }
+  PRINTD("Initializing ThrownTogetherRenderer");
+  return std::make_shared<ThrownTogetherRenderer>(csgInfo.root_products, csgInfo.highlights_products,
+                                                  csgInfo.background_products);
+}
+
+/*!
+   Renders all views with renderers made by createRenderer.
+
+   Views are rendered grouped by image size, so only one offscreen context is created,
+   and one renderer prepared, for each distinct size instead of for each image.
+ */
+bool renderViews(std::vector<PngView>& views,
+                 const std::function<std::shared_ptr<Renderer>()>& createRenderer)
+{
+  std::vector<size_t> order(views.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&views](size_t a, size_t b) {
+    return std::make_pair(views[a].camera.pixel_width, views[a].camera.pixel_height) <
+           std::make_pair(views[b].camera.pixel_width, views[b].camera.pixel_height);
+  });
+
+  bool success = true;
+  std::unique_ptr<OffscreenView> glview;
+  for (const auto i : order) {
+    auto& view = views[i];
+    auto& camera = view.camera;
+    if (!glview || glview->ctx->width() != camera.pixel_width ||
+        glview->ctx->height() != camera.pixel_height) {
+      if (glview) {
+        // Release the renderer's GL resources while its context is still alive
+        glview->ctx->makeCurrent();
+        glview->setRenderer(nullptr);
+        glview.reset();
+      }
+      try {
+        glview = std::make_unique<OffscreenView>(camera.pixel_width, camera.pixel_height);
+      } catch (const OffscreenViewException& ex) {
+        LOG("Can't create OffscreenView: %1$s.", ex.what());
+        return false;
+      }
+      auto renderer = createRenderer();
+      if (!renderer) return false;
+      glview->setRenderer(renderer);
+#ifdef ENABLE_OPENCSG
+      OpenCSG::setOption(OpenCSG::OffscreenSetting, OpenCSG::FrameBufferObject);
+#endif
+    }
+
+    setupCamera(camera, glview->getRenderer()->getBoundingBox());
+    glview->setCamera(camera);
+    if (view.colorscheme.empty()) {
+      glview->setColorScheme(RenderSettings::inst()->colorscheme);
+    } else {
+      glview->setColorScheme(view.colorscheme);
+    }
+    glview->setShowCrosshairs(view.options["crosshairs"]);
+    glview->setShowAxes(view.options["axes"]);
+    glview->setShowScaleProportional(view.options["scales"]);
+    glview->setShowEdges(view.options["edges"]);
+    glview->paintGL();
+
+    std::ofstream output(std::filesystem::u8path(view.filename), std::ios::out | std::ios::binary);
+    if (!output.is_open()) {
+      LOG("Can't open file \"%1$s\" for export", view.filename);
+      success = false;
+      continue;
+    }
+    success &= glview->save(output);
+  }
+  return success;
+}
+
 }  // namespace
 
 bool export_png(const std::shared_ptr<const Geometry>& root_geom, const ViewOptions& options,
@@ -49,20 +158,7 @@ bool export_png(const std::shared_ptr<const Geometry>& root_geom, const ViewOpti
     fprintf(stderr, "Can't create OffscreenView: %s.\n", ex.what());
     return false;
   }
-  std::shared_ptr<Renderer> geomRenderer;
-#if defined(USE_POLYSET_FOR_CGAL)
-  geomRenderer = std::make_shared<PolySetRenderer>(root_geom);
-#else
-  // Choose PolySetRenderer for PolySet and Polygon2d, and for Manifold since we
-  // know that all geometries are convertible to PolySet.
-  if (RenderSettings::inst()->backend3D == RenderBackend3D::ManifoldBackend ||
-      std::dynamic_pointer_cast<const PolySet>(root_geom) ||
-      std::dynamic_pointer_cast<const Polygon2d>(root_geom)) {
-    geomRenderer = std::make_shared<PolySetRenderer>(root_geom);
-  } else {
-    geomRenderer = std::make_shared<CGALRenderer>(root_geom);
-  }
-#endif
+  auto geomRenderer = createGeometryRenderer(root_geom);
   const BoundingBox bbox = geomRenderer->getBoundingBox();
   setupCamera(camera, bbox);
 
@@ -82,7 +178,10 @@ std::unique_ptr<OffscreenView> prepare_preview(Tree& tree, const ViewOptions& op
 {
   PRINTD("prepare_preview_common");
   CsgInfo csgInfo = CsgInfo();
-  csgInfo.compile_products(tree);
+  {
+    const RenderStatistic::Phase phase(RenderStatistic::CSG_TREE);
+    csgInfo.compile_products(tree);
+  }
 
   std::unique_ptr<OffscreenView> glview;
   try {
@@ -92,22 +191,8 @@ std::unique_ptr<OffscreenView> prepare_preview(Tree& tree, const ViewOptions& op
     return nullptr;
   }
 
-  std::shared_ptr<Renderer> renderer;
-  if (options.previewer == Previewer::OPENCSG) {
-#ifdef ENABLE_OPENCSG
-    PRINTD("Initializing OpenCSGRenderer");
-    renderer = std::make_shared<OpenCSGRenderer>(csgInfo.root_products, csgInfo.highlights_products,
-                                                 csgInfo.background_products);
-#else
-    fprintf(stderr, "This openscad was built without OpenCSG support\n");
-    return 0;
-#endif
-  } else {
-    PRINTD("Initializing ThrownTogetherRenderer");
-    renderer = std::make_shared<ThrownTogetherRenderer>(
-      csgInfo.root_products, csgInfo.highlights_products, csgInfo.background_products);
-  }
-
+  auto renderer = createPreviewRenderer(csgInfo, options.previewer);
+  if (!renderer) return nullptr;
   glview->setRenderer(renderer);
 
 #ifdef ENABLE_OPENCSG
@@ -133,6 +218,23 @@ bool export_png(const OffscreenView& glview, std::ostream& output)
   return true;
 }
 
+bool export_png_views(const std::shared_ptr<const Geometry>& root_geom, std::vector<PngView>& views)
+{
+  assert(root_geom != nullptr);
+  return renderViews(views, [&root_geom]() { return createGeometryRenderer(root_geom); });
+}
+
+bool export_png_views(Tree& tree, Previewer previewer, std::vector<PngView>& views)
+{
+  CsgInfo csgInfo = CsgInfo();
+  {
+    const RenderStatistic::Phase phase(RenderStatistic::CSG_TREE);
+    csgInfo.compile_products(tree);
+  }
+  return renderViews(views,
+                     [&csgInfo, previewer]() { return createPreviewRenderer(csgInfo, previewer); });
+}
+
 #else  // NULLGL
 
 bool export_png(const std::shared_ptr<const Geometry>& root_geom, const ViewOptions& options,
@@ -148,5 +250,13 @@ bool export_png(const OffscreenView& glview, std::ostream& output)
 {
   return false;
 }
+bool export_png_views(const std::shared_ptr<const Geometry>& root_geom, std::vector<PngView>& views)
+{
+  return false;
+}
+bool export_png_views(Tree& tree, Previewer previewer, std::vector<PngView>& views)
+{
+  return false;
+}
 
 #endif  // NULLGL
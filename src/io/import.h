@@ -1,6 +1,9 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -12,11 +15,24 @@ std::unique_ptr<class PolySet> import_obj(const std::string& filename, const Loc
 std::unique_ptr<class PolySet> import_off(const std::string& filename, const Location& loc);
 std::unique_ptr<class PolySet> import_amf(const std::string&, const Location& loc);
 std::unique_ptr<class PolySet> import_3mf(const std::string&, const Location& loc);
+std::unique_ptr<class PolySet> import_binmesh(const std::string& filename, const Location& loc);
+// Runs importer, unless the mesh it imports from filename is already in the import mesh cache
+std::unique_ptr<class PolySet> import_mesh_cached(
+  const std::string& filename, const std::string& format,
+  const std::function<std::unique_ptr<class PolySet>()>& importer);
+// As above, with the cache in cachedir, regardless of the feature being enabled
+std::unique_ptr<class PolySet> import_mesh_cached(
+  const std::string& filename, const std::string& format,
+  const std::function<std::unique_ptr<class PolySet>()>& importer,
+  const std::filesystem::path& cachedir);
 
 std::unique_ptr<class Polygon2d> import_svg(CurveDiscretizer discretizer, const std::string& filename,
                                             const boost::optional<std::string>& id,
                                             const boost::optional<std::string>& layer, const double dpi,
                                             const bool center, const Location& loc);
+void clear_svg_import_cache();
+// Number of SVG imports served from the cache
+size_t svg_import_cache_hits();
 
 #ifdef ENABLE_CGAL
 std::unique_ptr<class CGALNefGeometry> import_nef3(const std::string& filename, const Location& loc);
@@ -0,0 +1,319 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Feature.h"
+#include "core/AST.h"
+#include "geometry/PolySet.h"
+#include "geometry/linalg.h"
+#include "io/binmesh.h"
+#include "io/import.h"
+#include "platform/PlatformUtils.h"
+#include "utils/printutils.h"
+
+namespace {
+
+// Larger counts can't come from a valid file and could overflow size calculations
+constexpr uint64_t MAX_COUNT = uint64_t{1} << 40;
+
+// Read-only memory mapping of an entire file
+class MappedFile
+{
+public:
+  explicit MappedFile(const std::filesystem::path& path)
+  {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return;
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+      HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      if (mapping) {
+        data_ = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (data_) size_ = static_cast<size_t>(size.QuadPart);
+        CloseHandle(mapping);
+      }
+    }
+    CloseHandle(file);
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        data_ = static_cast<const char *>(data);
+        size_ = static_cast<size_t>(st.st_size);
+      }
+    }
+    close(fd);
+#endif
+  }
+
+  ~MappedFile()
+  {
+    if (!data_) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    munmap(const_cast<char *>(data_), size_);
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  [[nodiscard]] const char *data() const { return data_; }
+  [[nodiscard]] size_t size() const { return size_; }
+
+private:
+  const char *data_{nullptr};
+  size_t size_{0};
+};
+
+/*!
+   Copies the mesh in data into a new PolySet, or returns nullptr and sets error if it's invalid.
+
+   Without a key, data comes from a file given by the user. Its manifold flag is ignored, as
+   meshes flagged manifold skip the checks of the Manifold conversion. With a key, data is a
+   cache entry written by us, which is only accepted if it was made from the source identified
+   by key.
+ */
+std::unique_ptr<PolySet> readBinMesh(const char *data, size_t size, const std::string *key,
+                                     std::string& error)
+{
+  binmesh::Header header;
+  if (size < sizeof(header)) {
+    error = "file too short";
+    return nullptr;
+  }
+  std::memcpy(&header, data, sizeof(header));
+  if (std::memcmp(header.magic, binmesh::MAGIC, sizeof(binmesh::MAGIC)) != 0) {
+    error = "not a binary mesh file";
+    return nullptr;
+  }
+  if (header.byte_order != binmesh::BYTE_ORDER_MARK) {
+    error = "file was written on a machine with a different byte order";
+    return nullptr;
+  }
+  if (header.version != binmesh::VERSION) {
+    error = "unsupported version " + std::to_string(header.version);
+    return nullptr;
+  }
+  if ((header.dimension != 2 && header.dimension != 3) || header.num_vertices > MAX_COUNT ||
+      header.num_indices > MAX_COUNT || header.num_polygons > MAX_COUNT ||
+      header.num_colors > MAX_COUNT || header.key_size > MAX_COUNT ||
+      binmesh::fileSize(header) != size) {
+    error = "invalid header";
+    return nullptr;
+  }
+
+  const char *section = data + binmesh::align(sizeof(header));
+  if (key && std::string_view(section, header.key_size) != *key) {
+    error = "made from a different source";
+    return nullptr;
+  }
+  section += binmesh::align(header.key_size);
+  const auto *vertices = reinterpret_cast<const double *>(section);
+  section += binmesh::align(header.num_vertices * 3 * sizeof(double));
+  const auto *indices = reinterpret_cast<const int32_t *>(section);
+  section += binmesh::align(header.num_indices * sizeof(int32_t));
+  const auto *sizes = reinterpret_cast<const uint32_t *>(section);
+  section += binmesh::align(header.num_polygons * sizeof(uint32_t));
+  const auto *colors = reinterpret_cast<const float *>(section);
+  section += binmesh::align(header.num_colors * 4 * sizeof(float));
+  const auto *color_indices = reinterpret_cast<const int32_t *>(section);
+
+  auto ps = std::make_unique<PolySet>(header.dimension);
+  ps->vertices.resize(header.num_vertices);
+  std::memcpy(ps->vertices.data(), vertices, header.num_vertices * 3 * sizeof(double));
+
+  ps->indices.reserve(header.num_polygons);
+  const auto num_vertices = static_cast<int64_t>(header.num_vertices);
+  uint64_t remaining = header.num_indices;
+  for (uint64_t i = 0; i < header.num_polygons; ++i) {
+    if (sizes[i] > remaining) {
+      error = "polygon sizes exceed the number of indices";
+      return nullptr;
+    }
+    remaining -= sizes[i];
+    for (uint32_t j = 0; j < sizes[i]; ++j) {
+      if (indices[j] < 0 || indices[j] >= num_vertices) {
+        error = "vertex index out of range";
+        return nullptr;
+      }
+    }
+    ps->indices.emplace_back(indices, indices + sizes[i]);
+    indices += sizes[i];
+  }
+  if (remaining != 0) {
+    error = "polygon sizes don't match the number of indices";
+    return nullptr;
+  }
+
+  ps->colors.reserve(header.num_colors);
+  for (uint64_t i = 0; i < header.num_colors; ++i) {
+    ps->colors.emplace_back(colors[4 * i], colors[4 * i + 1], colors[4 * i + 2], colors[4 * i + 3]);
+  }
+  if (header.flags & binmesh::FLAG_COLOR_INDICES) {
+    ps->color_indices.assign(color_indices, color_indices + header.num_polygons);
+    for (const auto color_index : ps->color_indices) {
+      if (color_index < -1 || color_index >= static_cast<int64_t>(header.num_colors)) {
+        error = "color index out of range";
+        return nullptr;
+      }
+    }
+  }
+
+  ps->setTriangular(header.flags & binmesh::FLAG_TRIANGULAR);
+  if (key) ps->setManifold(header.flags & binmesh::FLAG_MANIFOLD);
+  return ps;
+}
+
+// Identifies the state of the imported file, empty if it can't be determined. file is set to
+// the part which only identifies the file, and not its state.
+std::string sourceKey(const std::string& filename, const std::string& format, std::string& file)
+{
+  std::error_code ec;
+  const auto path = std::filesystem::canonical(std::filesystem::u8path(filename), ec);
+  if (ec) return {};
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec) return {};
+  const auto mtime = std::filesystem::last_write_time(path, ec);
+  if (ec) return {};
+
+  file = format + ':' + path.generic_string();
+  std::ostringstream key;
+  key << format << ':' << size << ':'
+      << std::chrono::duration_cast<std::chrono::nanoseconds>(mtime.time_since_epoch()).count() << ':'
+      << path.generic_string();
+  return key.str();
+}
+
+// Creates the cache directory if needed. Returns false if it may be writable by other users,
+// who could then plant meshes in it.
+bool prepareCacheDir(const std::filesystem::path& dir)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(dir, ec);
+  if (ec) return false;
+  std::filesystem::permissions(dir, std::filesystem::perms::owner_all,
+                               std::filesystem::perm_options::replace, ec);
+  if (ec) return false;
+#ifndef _WIN32
+  struct stat st;
+  if (lstat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode) || st.st_uid != geteuid() ||
+      (st.st_mode & (S_IRWXG | S_IRWXO)) != 0) {
+    return false;
+  }
+#endif
+  return true;
+}
+
+}  // namespace
+
+std::unique_ptr<PolySet> import_binmesh(const std::string& filename, const Location& loc)
+{
+  const MappedFile file(std::filesystem::u8path(filename));
+  if (!file.data()) {
+    LOG(message_group::Warning, "Can't open import file '%1$s', import() at line %2$d", filename,
+        loc.firstLine());
+    return PolySet::createEmpty();
+  }
+  std::string error;
+  auto ps = readBinMesh(file.data(), file.size(), nullptr, error);
+  if (!ps) {
+    LOG(message_group::Error, loc, "", "Binary mesh '%1$s' error: %2$s", filename, error);
+    return PolySet::createEmpty();
+  }
+  return ps;
+}
+
+std::unique_ptr<PolySet> import_mesh_cached(const std::string& filename, const std::string& format,
+                                            const std::function<std::unique_ptr<PolySet>()>& importer)
+{
+  if (!Feature::ExperimentalImportMeshCache.is_enabled()) return importer();
+
+  const auto cachepath = PlatformUtils::userCachePath();
+  if (cachepath.empty()) return importer();
+  return import_mesh_cached(filename, format, importer,
+                            std::filesystem::u8path(cachepath) / "mesh-cache");
+}
+
+std::unique_ptr<PolySet> import_mesh_cached(const std::string& filename, const std::string& format,
+                                            const std::function<std::unique_ptr<PolySet>()>& importer,
+                                            const std::filesystem::path& cachedir)
+{
+  std::string file;
+  const auto key = sourceKey(filename, format, file);
+  if (key.empty() || !prepareCacheDir(cachedir)) return importer();
+
+  // The name only depends on the file and format, so an entry for a changed file replaces the
+  // old one. The key stored inside decides whether an entry matches.
+  std::ostringstream name;
+  name << std::hex << std::setw(16) << std::setfill('0') << std::hash<std::string>{}(file)
+       << ".binmesh";
+  const auto cached = cachedir / name.str();
+
+  {
+    const MappedFile file(cached);
+    if (file.data()) {
+      std::string error;
+      if (auto ps = readBinMesh(file.data(), file.size(), &key, error)) {
+        PRINTDB("Imported '%1$s' from cache '%2$s'", filename % cached.string());
+        return ps;
+      }
+      PRINTDB("Ignoring cached mesh '%1$s': %2$s", cached.string() % error);
+    }
+  }
+
+  auto ps = importer();
+  if (ps->isEmpty()) return ps;
+
+  // Write to a file of our own process and thread first, so concurrent imports never see a
+  // partial cache entry
+  std::error_code ec;
+  auto tmp = cached;
+#ifdef _WIN32
+  const auto pid = _getpid();
+#else
+  const auto pid = getpid();
+#endif
+  tmp += "." + std::to_string(pid) + "-" +
+         std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+  {
+    std::ofstream output(tmp, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!output.is_open()) return ps;
+    binmesh::write(*ps, output, key);
+    if (!output.good()) {
+      output.close();
+      std::filesystem::remove(tmp, ec);
+      return ps;
+    }
+  }
+  std::filesystem::rename(tmp, cached, ec);
+  if (ec) std::filesystem::remove(tmp, ec);
+  return ps;
+}
@@ -29,11 +29,19 @@
 
 #include <Eigen/Core>
 #include <Eigen/Geometry>
+#include <cstddef>
 #include <exception>
+#include <fstream>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <numeric>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "SharedCache.h"
 #include "core/AST.h"
 #include "core/CurveDiscretizer.h"
 #include "geometry/ClipperUtils.h"
@@ -42,6 +50,7 @@
 #include "libsvg/shape.h"
 #include "libsvg/svgpage.h"
 #include "libsvg/util.h"
+#include "utils/parallel.h"
 #include "utils/printutils.h"
 
 namespace {
@@ -79,42 +88,175 @@ double calc_alignment(const libsvg::align_t alignment, double page_mm, double sc
   }
 }
 
+// Imports are cached by file content and import() parameters, so re-evaluating a design
+// doesn't parse and flatten unchanged SVG files again.
+struct SvgCacheEntry {
+  std::shared_ptr<const Polygon2d> polygon;
+  bool has_matches;
+};
+
+SharedCache<std::string, SvgCacheEntry> svg_cache(64ul * 1024ul * 1024ul);
+
+struct ShapeOutlines {
+  std::vector<Outline2d> outlines;
+  Eigen::AlignedBox<double, 2> bbox{2};
+};
+
+std::shared_ptr<const Polygon2d> read_svg(const std::string& data, const CurveDiscretizer& discretizer,
+                                          const std::string& filename,
+                                          const boost::optional<std::string>& id,
+                                          const boost::optional<std::string>& layer, const double dpi,
+                                          const bool center, bool& has_matches)
+{
+  fnContext scadContext(
+    [&discretizer](double r, double angle) { return discretizer.getCircularSegmentCount(r, angle); },
+    discretizer.getPathSegmentCount());
+  if (id) {
+    scadContext.selector = [&scadContext, id, layer](const libsvg::shape *s) {
+      bool layer_match = true;
+      if (layer) {
+        layer_match = false;
+        for (const libsvg::shape *shape = s; shape->get_parent() != nullptr;
+             shape = shape->get_parent()) {
+          if (shape->has_layer() && shape->get_layer() == layer.get()) {
+            layer_match = true;
+            break;
+          }
+        }
+      }
+      return scadContext.match(layer_match && s->has_id() && s->get_id() == id.get());
+    };
+  } else if (layer) {
+    scadContext.selector = [&scadContext, layer](const libsvg::shape *s) {
+      return scadContext.match(s->has_layer() && s->get_layer() == layer.get());
+    };
+  } else {
+    // no selection means selecting the root
+    scadContext.selector = [&scadContext](const libsvg::shape *s) {
+      return scadContext.match(s->get_parent() == nullptr);
+    };
+  }
+
+  const auto shapes = libsvg::libsvg_read_memory(data, filename.c_str(), (void *)&scadContext);
+  has_matches = scadContext.has_matches();
+
+  double width_mm = 0.0;
+  double height_mm = 0.0;
+
+  Eigen::Vector2d scale{1.0, 1.0};
+  Eigen::Vector2d align{0.0, 0.0};
+  Eigen::Vector2d viewbox{0.0, 0.0};
+
+  // The bounding box of each shape uses the scale of the last page before it
+  std::vector<Eigen::Vector2d> shape_scales;
+  shape_scales.reserve(shapes->size());
+  for (const auto& shape_ptr : *shapes) {
+    const auto page = dynamic_cast<libsvg::svgpage *>(shape_ptr.get());
+    if (page) {
+      const auto w = page->get_width();
+      const auto h = page->get_height();
+      const auto alignment = page->get_alignment();
+
+      const bool viewbox_valid = page->get_viewbox().is_valid;
+      width_mm = to_mm(w, page->get_viewbox().width, viewbox_valid, dpi);
+      height_mm = to_mm(h, page->get_viewbox().height, viewbox_valid, dpi);
+
+      if (viewbox_valid) {
+        const double px = w.unit == libsvg::unit_t::PERCENT ? w.number / 100.0 : 1.0;
+        const double py = h.unit == libsvg::unit_t::PERCENT ? h.number / 100.0 : 1.0;
+        viewbox << px * page->get_viewbox().x, py * page->get_viewbox().y;
+
+        scale << width_mm / page->get_viewbox().width, height_mm / page->get_viewbox().height;
+
+        if (alignment.x != libsvg::align_t::NONE) {
+          double scaling;
+          if (alignment.meet) {
+            // preserve aspect ratio and fit into viewport, so
+            // select the smaller of the 2 scale factors
+            scaling = scale.x() < scale.y() ? scale.x() : scale.y();
+          } else {
+            // preserve aspect ratio and fill viewport, so select
+            // the bigger of the 2 scale factors
+            scaling = scale.x() > scale.y() ? scale.x() : scale.y();
+          }
+          scale = Eigen::Vector2d{scaling, scaling};
+
+          align << calc_alignment(alignment.x, width_mm, scale.x(), page->get_viewbox().width),
+            calc_alignment(alignment.y, height_mm, scale.y(), page->get_viewbox().height);
+        }
+      }
+    }
+    shape_scales.push_back(scale);
+  }
+
+  // Outlines are built relative to the unknown center together with the bounding box,
+  // so all points are visited only once, and shapes are independent of each other.
+  std::vector<size_t> indices(shapes->size());
+  std::iota(indices.begin(), indices.end(), 0);
+  std::vector<ShapeOutlines> shape_outlines(shapes->size());
+  parallelizable_transform(indices.begin(), indices.end(), shape_outlines.begin(), [&](size_t idx) {
+    ShapeOutlines result;
+    const auto& s = *(*shapes)[idx];
+    if (s.is_excluded()) return result;
+    const Eigen::Vector2d& shape_scale = shape_scales[idx];
+    for (const auto& p : s.get_path_list()) {
+      Outline2d outline;
+      outline.vertices.reserve(p.size());
+      for (const auto& v : p) {
+        result.bbox.extend(Eigen::Vector2d{shape_scale.x() * v.x(), shape_scale.y() * v.y()});
+        outline.vertices.emplace_back(scale.x() * (-viewbox.x() + v.x()),
+                                      scale.y() * (-viewbox.y() - v.y()));
+      }
+      result.outlines.push_back(std::move(outline));
+    }
+    return result;
+  });
+  libsvg_free(shapes);
+
+  Eigen::AlignedBox<double, 2> bbox{2};
+  for (const auto& s : shape_outlines) bbox.extend(s.bbox);
+  const double cx = center ? bbox.center().x() : -align.x();
+  const double cy = center ? bbox.center().y() : height_mm - align.y();
+
+  std::vector<std::shared_ptr<const Polygon2d>> polygons;
+  for (auto& s : shape_outlines) {
+    auto poly = std::make_shared<Polygon2d>();
+    for (auto& outline : s.outlines) {
+      for (auto& v : outline.vertices) {
+        v.x() -= cx;
+        v.y() += cy;
+      }
+      outline.positive = true;
+      poly->addOutline(std::move(outline));
+    }
+    if (!poly->isEmpty()) polygons.push_back(poly);
+  }
+  return ClipperUtils::apply(polygons, Clipper2Lib::ClipType::Union);
+}
+
 }  // namespace
 
+void clear_svg_import_cache()
+{
+  svg_cache.clear();
+}
+
+size_t svg_import_cache_hits()
+{
+  return svg_cache.hits();
+}
+
 std::unique_ptr<Polygon2d> import_svg(CurveDiscretizer discretizer, const std::string& filename,
                                       const boost::optional<std::string>& id,
                                       const boost::optional<std::string>& layer, const double dpi,
                                       const bool center, const Location& loc)
 {
   try {
-    fnContext scadContext(
-      [&discretizer](double r, double angle) { return discretizer.getCircularSegmentCount(r, angle); },
-      discretizer.getPathSegmentCount());
-    if (id) {
-      scadContext.selector = [&scadContext, id, layer](const libsvg::shape *s) {
-        bool layer_match = true;
-        if (layer) {
-          layer_match = false;
-          for (const libsvg::shape *shape = s; shape->get_parent() != nullptr;
-               shape = shape->get_parent()) {
-            if (shape->has_layer() && shape->get_layer() == layer.get()) {
-              layer_match = true;
-              break;
-            }
-          }
-        }
-        return scadContext.match(layer_match && s->has_id() && s->get_id() == id.get());
-      };
-    } else if (layer) {
-      scadContext.selector = [&scadContext, layer](const libsvg::shape *s) {
-        return scadContext.match(s->has_layer() && s->get_layer() == layer.get());
-      };
-    } else {
-      // no selection means selecting the root
-      scadContext.selector = [&scadContext](const libsvg::shape *s) {
-        return scadContext.match(s->get_parent() == nullptr);
-      };
+    std::ifstream f(filename, std::ios::in | std::ios::binary);
+    if (!f.good()) {
+      throw libsvg::SvgException("Can't open file '" + filename + "'");
     }
+    const std::string data{std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
 
     std::string match_args;
     if (id) {
@@ -125,90 +267,32 @@ std::unique_ptr<Polygon2d> import_svg(CurveDiscretizer discretizer, const std::s
       match_args += "layer = \"" + layer.get() + "\"";
     }
 
-    const auto shapes = libsvg::libsvg_read_file(filename.c_str(), (void *)&scadContext);
-    if (!match_args.empty() && !scadContext.has_matches()) {
-      LOG(message_group::Warning, loc, "", "import() filter %2$s did not match anything", filename,
-          match_args);
-    }
-
-    double width_mm = 0.0;
-    double height_mm = 0.0;
-
-    Eigen::AlignedBox<double, 2> bbox{2};
-
-    Eigen::Vector2d scale{1.0, 1.0};
-    Eigen::Vector2d align{0.0, 0.0};
-    Eigen::Vector2d viewbox{0.0, 0.0};
-
-    for (const auto& shape_ptr : *shapes) {
-      const auto page = dynamic_cast<libsvg::svgpage *>(shape_ptr.get());
-      if (page) {
-        const auto w = page->get_width();
-        const auto h = page->get_height();
-        const auto alignment = page->get_alignment();
-
-        const bool viewbox_valid = page->get_viewbox().is_valid;
-        width_mm = to_mm(w, page->get_viewbox().width, viewbox_valid, dpi);
-        height_mm = to_mm(h, page->get_viewbox().height, viewbox_valid, dpi);
-
-        if (viewbox_valid) {
-          const double px = w.unit == libsvg::unit_t::PERCENT ? w.number / 100.0 : 1.0;
-          const double py = h.unit == libsvg::unit_t::PERCENT ? h.number / 100.0 : 1.0;
-          viewbox << px * page->get_viewbox().x, py * page->get_viewbox().y;
-
-          scale << width_mm / page->get_viewbox().width, height_mm / page->get_viewbox().height;
-
-          if (alignment.x != libsvg::align_t::NONE) {
-            double scaling;
-            if (alignment.meet) {
-              // preserve aspect ratio and fit into viewport, so
-              // select the smaller of the 2 scale factors
-              scaling = scale.x() < scale.y() ? scale.x() : scale.y();
-            } else {
-              // preserve aspect ratio and fill viewport, so select
-              // the bigger of the 2 scale factors
-              scaling = scale.x() > scale.y() ? scale.x() : scale.y();
-            }
-            scale = Eigen::Vector2d{scaling, scaling};
-
-            align << calc_alignment(alignment.x, width_mm, scale.x(), page->get_viewbox().width),
-              calc_alignment(alignment.y, height_mm, scale.y(), page->get_viewbox().height);
-          }
-        }
-      }
+    // The key ends with the whole document, so only identical files share an entry
+    std::ostringstream params;
+    params << discretizer << ":" << dpi << ":" << center << ":" << (id ? "#" + id.get() : "") << ":"
+           << (layer ? "#" + layer.get() : "");
+    const std::string key = params.str() + '\0' + data;
 
-      if (!shape_ptr->is_excluded()) {
-        const auto& s = *shape_ptr;
-        for (const auto& p : s.get_path_list()) {
-          for (const auto& v : p) {
-            bbox.extend(Eigen::Vector2d{scale.x() * v.x(), scale.y() * v.y()});
-          }
-        }
-      }
+    std::shared_ptr<const Polygon2d> polygon;
+    bool has_matches = false;
+    if (const auto entry = svg_cache.find(key)) {
+      polygon = entry->polygon;
+      has_matches = entry->has_matches;
     }
-    const double cx = center ? bbox.center().x() : -align.x();
-    const double cy = center ? bbox.center().y() : height_mm - align.y();
-
-    std::vector<std::shared_ptr<const Polygon2d>> polygons;
-    for (const auto& shape_ptr : *shapes) {
-      if (!shape_ptr->is_excluded()) {
-        auto poly = std::make_shared<Polygon2d>();
-        const auto& s = *shape_ptr;
-        for (const auto& p : s.get_path_list()) {
-          Outline2d outline;
-          for (const auto& v : p) {
-            const double x = scale.x() * (-viewbox.x() + v.x()) - cx;
-            const double y = scale.y() * (-viewbox.y() - v.y()) + cy;
-            outline.vertices.emplace_back(x, y);
-            outline.positive = true;
-          }
-          poly->addOutline(outline);
-        }
-        if (!poly->isEmpty()) polygons.push_back(poly);
+    if (!polygon) {
+      polygon = read_svg(data, discretizer, filename, id, layer, dpi, center, has_matches);
+      size_t cost = sizeof(SvgCacheEntry) + key.size();
+      for (const auto& o : polygon->outlines()) {
+        cost += sizeof(Outline2d) + o.vertices.size() * sizeof(Vector2d);
       }
+      svg_cache.insert(key, {.polygon = polygon, .has_matches = has_matches}, cost);
+    }
+
+    if (!match_args.empty() && !has_matches) {
+      LOG(message_group::Warning, loc, "", "import() filter %2$s did not match anything", filename,
+          match_args);
     }
-    libsvg_free(shapes);
-    return ClipperUtils::apply(polygons, Clipper2Lib::ClipType::Union);
+    return std::make_unique<Polygon2d>(*polygon);
   } catch (const std::exception& e) {
     LOG(message_group::Error, "%1$s, import() at line %2$d", e.what(), loc.firstLine());
     return std::make_unique<Polygon2d>();
@@ -0,0 +1,67 @@
+#include <catch2/catch_all.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "core/AST.h"
+#include "core/CurveDiscretizer.h"
+#include "geometry/Polygon2d.h"
+#include "io/import.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void writeSquare(const fs::path& path, int size)
+{
+  std::ofstream output(path, std::ios::trunc);
+  output << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"100\" height=\"100\">"
+         << "<rect x=\"0\" y=\"0\" width=\"" << size << "\" height=\"" << size << "\"/></svg>\n";
+}
+
+double importedWidth(const fs::path& path, double dpi = 72)
+{
+  const auto polygon = import_svg(CurveDiscretizer(32), path.string(), boost::none, boost::none, dpi,
+                                  false, Location::NONE);
+  const auto bbox = polygon->getBoundingBox();
+  return bbox.isEmpty() ? 0 : bbox.sizes()[0];
+}
+
+}  // namespace
+
+TEST_CASE("SVG import cache reuses unchanged files", "[svg]")
+{
+  const auto path = fs::temp_directory_path() /
+                    ("openscad-svg-cache-test-" +
+                     std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".svg");
+  clear_svg_import_cache();
+  writeSquare(path, 10);
+
+  const double width = importedWidth(path);
+  REQUIRE(width > 0);
+  const size_t hits = svg_import_cache_hits();
+
+  SECTION("Unchanged file hits")
+  {
+    CHECK(importedWidth(path) == Catch::Approx(width));
+    CHECK(svg_import_cache_hits() == hits + 1);
+  }
+
+  SECTION("Changed file misses")
+  {
+    // Same file size, different content
+    writeSquare(path, 20);
+    CHECK(importedWidth(path) == Catch::Approx(2 * width));
+    CHECK(svg_import_cache_hits() == hits);
+  }
+
+  SECTION("Other parameters miss")
+  {
+    CHECK(importedWidth(path, 144) == Catch::Approx(width / 2));
+    CHECK(svg_import_cache_hits() == hits);
+  }
+
+  std::error_code ec;
+  fs::remove(path, ec);
+}
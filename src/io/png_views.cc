@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "glview/Camera.h"
+#include "io/export.h"
+#include "json/json.hpp"
+#include "utils/printutils.h"
+
+using json = nlohmann::json;
+
+namespace {
+
+// Numbers of a JSON array, or of a comma separated string as given on the command line
+std::vector<double> numbers(const json& j)
+{
+  std::vector<double> result;
+  if (j.is_string()) {
+    std::string::size_type pos = 0;
+    const auto str = j.get<std::string>();
+    while (pos <= str.size()) {
+      const auto end = std::min(str.find(',', pos), str.size());
+      result.push_back(std::stod(str.substr(pos, end - pos)));
+      pos = end + 1;
+    }
+  } else {
+    for (const auto& elem : j) result.push_back(elem.get<double>());
+  }
+  return result;
+}
+
+/*!
+   Reads one view. Keys not present keep the values of view, which holds the defaults
+   given on the command line:
+
+     "output":      PNG file to write (required)
+     "camera":      7 numbers for a gimbal camera or 6 for a vector camera, as for --camera
+     "imgsize":     [width, height]
+     "projection":  "ortho" or "perspective"
+     "viewall":     true/false
+     "autocenter":  true/false
+     "view":        list of view options to enable, as for --view
+     "colorscheme": name of a color scheme
+ */
+void readView(const json& j, PngView& view)
+{
+  view.filename = j.at("output").get<std::string>();
+  if (j.contains("camera")) {
+    const auto params = numbers(j["camera"]);
+    if (params.size() != 6 && params.size() != 7) {
+      throw std::runtime_error("camera needs 7 numbers for a gimbal camera or 6 for a vector camera");
+    }
+    view.camera.setup(params);
+    view.camera.viewall = false;
+    view.camera.autocenter = false;
+  }
+  if (j.contains("imgsize")) {
+    const auto size = numbers(j["imgsize"]);
+    if (size.size() != 2 || size[0] < 1 || size[1] < 1) {
+      throw std::runtime_error("imgsize needs 2 positive numbers");
+    }
+    view.camera.pixel_width = static_cast<unsigned int>(size[0]);
+    view.camera.pixel_height = static_cast<unsigned int>(size[1]);
+  }
+  if (j.contains("projection")) {
+    const auto proj = j["projection"].get<std::string>();
+    if (proj == "o" || proj == "ortho" || proj == "orthogonal") {
+      view.camera.projection = Camera::ProjectionType::ORTHOGONAL;
+    } else if (proj == "p" || proj == "perspective") {
+      view.camera.projection = Camera::ProjectionType::PERSPECTIVE;
+    } else {
+      throw std::runtime_error("projection needs to be 'ortho' or 'perspective'");
+    }
+  }
+  if (j.contains("viewall")) view.camera.viewall = j["viewall"].get<bool>();
+  if (j.contains("autocenter")) view.camera.autocenter = j["autocenter"].get<bool>();
+  if (j.contains("view")) {
+    for (auto& flag : view.options.flags) flag.second = false;
+    for (const auto& option : j["view"]) {
+      const auto name = option.get<std::string>();
+      if (!view.options.flags.count(name)) {
+        throw std::runtime_error("unknown view option '" + name + "'");
+      }
+      view.options[name] = true;
+    }
+  }
+  if (j.contains("colorscheme")) view.colorscheme = j["colorscheme"].get<std::string>();
+}
+
+}  // namespace
+
+bool read_png_views(const std::string& filename, const Camera& camera, const ViewOptions& options,
+                    std::vector<PngView>& views)
+{
+  std::ifstream input(std::filesystem::u8path(filename));
+  if (!input) {
+    LOG("Can't open views file '%1$s'", filename);
+    return false;
+  }
+  try {
+    json j;
+    input >> j;
+    // Either a list of views or an object holding it as "views"
+    const auto& list = j.is_object() ? j.at("views") : j;
+    if (!list.is_array() || list.empty()) throw std::runtime_error("expected a non-empty list of views");
+    views.clear();
+    for (const auto& elem : list) {
+      PngView view{.filename = "", .camera = camera, .options = options, .colorscheme = ""};
+      readView(elem, view);
+      views.push_back(std::move(view));
+    }
+  } catch (const std::exception& e) {
+    LOG("Failed to read views file '%1$s': %2$s", filename, e.what());
+    return false;
+  }
+  return true;
+}
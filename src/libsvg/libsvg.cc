@@ -38,6 +38,7 @@
 
 #include "libsvg/shape.h"
 #include "libsvg/use.h"
+#include "utils/parallel.h"
 
 namespace libsvg {
 
@@ -166,16 +167,13 @@ void processNode(xmlTextReaderPtr reader, shapes_defs_list_t *defs_lookup_list,
   xmlFree((void *)(name));
 }
 
-int streamFile(const char *filename, void *context)
+void streamReader(xmlTextReaderPtr reader, const char *filename, void *context)
 {
-  xmlTextReaderPtr reader;
   // The temp storage is needed for items in a def that don't have an id, but have a parent with an id
   shapes_list_t temp_defs_storage;
   shapes_defs_list_t defs_lookup_list;
 
   in_defs = false;
-  reader = xmlNewTextReaderFilename(filename);
-  xmlTextReaderSetParserProp(reader, XML_PARSER_SUBST_ENTITIES, 1);
   if (reader != nullptr) {
     int ret = xmlTextReaderRead(reader);
     while (ret == 1) {
@@ -190,10 +188,21 @@ int streamFile(const char *filename, void *context)
     throw SvgException((boost::format("Can't open file '%1%'") % filename).str());
   }
 
-  for (const auto& shape : (*shape_list)) {
-    shape->apply_transform();
-  }
+  // Paths only depend on their own shape and its ancestors, so the shapes are flattened
+  // and transformed in parallel. Excluded shapes are never imported, so skip them.
+  parallelizable_for_each(shape_list->begin(), shape_list->end(),
+                          [context](const std::shared_ptr<shape>& s) {
+                            if (s->is_excluded()) return;
+                            s->flatten(context);
+                            s->apply_transform();
+                          });
+}
 
+int streamFile(const char *filename, void *context)
+{
+  xmlTextReaderPtr reader = xmlNewTextReaderFilename(filename);
+  if (reader != nullptr) xmlTextReaderSetParserProp(reader, XML_PARSER_SUBST_ENTITIES, 1);
+  streamReader(reader, filename, context);
   return 0;
 }
 
@@ -222,6 +231,15 @@ shapes_list_t *libsvg_read_file(const char *filename, void *context)
   return shape_list;
 }
 
+shapes_list_t *libsvg_read_memory(const std::string& data, const char *filename, void *context)
+{
+  shape_list = new shapes_list_t();
+  xmlTextReaderPtr reader =
+    xmlReaderForMemory(data.data(), data.size(), filename, nullptr, XML_PARSE_NOENT);
+  streamReader(reader, filename, context);
+  return shape_list;
+}
+
 void libsvg_free(shapes_list_t *shapes)
 {
   delete shapes;
@@ -47,7 +47,10 @@ private:
 
 using shapes_list_t = std::vector<std::shared_ptr<shape>>;
 
+// The paths of shapes excluded from the selection in context are left empty.
 shapes_list_t *libsvg_read_file(const char *filename, void *context);
+// Like libsvg_read_file(), for a document already read into memory.
+shapes_list_t *libsvg_read_memory(const std::string& data, const char *filename, void *context);
 
 void libsvg_free(shapes_list_t *shapes);
 
@@ -51,6 +51,7 @@ public:
   path() = default;
 
   void set_attrs(attr_map_t& attrs, void *context) override;
+  void flatten(void *context) override;
   [[nodiscard]] const std::string dump() const override;
   [[nodiscard]] const std::string& get_name() const override { return path::name; }
 
@@ -129,6 +129,9 @@ public:
   [[nodiscard]] virtual bool is_excluded() const;
   [[nodiscard]] virtual bool is_container() const { return false; }
 
+  // Computes the path list of shapes which don't already do so in set_attrs(). Only depends
+  // on the shape itself, so it is called for all shapes in parallel once the file is parsed.
+  virtual void flatten(void *context) {}
   virtual void apply_transform();
 
   [[nodiscard]] virtual const std::string& get_name() const = 0;
@@ -66,6 +66,7 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
@@ -79,8 +80,10 @@
 #include <CGAL/assertions_behaviour.h>
 #endif
 
+#include "Cache.h"
 #include "Feature.h"
 #include "LibraryInfo.h"
+#include "MemoryBudget.h"
 #include "RenderStatistic.h"
 #include "core/AST.h"
 #include "core/BuiltinContext.h"
@@ -178,6 +181,7 @@ struct CommandLine {
   const AnimateArgs animate;
   const std::vector<std::string> summaryOptions;
   const std::string summaryFile;
+  const std::vector<PngView>& views;
 };
 
 namespace {
@@ -415,6 +419,7 @@ int do_export(const CommandLine& cmd, const RenderVariables& render_variables, F
     absolute_root_node = python_result_node;
   } else {
 #endif
+    const RenderStatistic::Phase phase(RenderStatistic::INSTANTIATE);
     absolute_root_node = root_file->instantiate(*builtin_context, &file_context);
 #ifdef ENABLE_PYTHON
   }
@@ -460,8 +465,12 @@ int do_export(const CommandLine& cmd, const RenderVariables& render_variables, F
     with_output(cmd.is_stdout, filename_str,
                 [&root_file, &fpath](std::ostream& stream) { export_param(root_file, fpath, stream); });
   } else if (export_format == FileFormat::TERM) {
-    CSGTreeEvaluator csgRenderer(tree);
-    auto root_raw_term = csgRenderer.buildCSGTree(*root_node);
+    std::shared_ptr<CSGNode> root_raw_term;
+    {
+      const RenderStatistic::Phase phase(RenderStatistic::CSG_TREE);
+      CSGTreeEvaluator csgRenderer(tree);
+      root_raw_term = csgRenderer.buildCSGTree(*root_node);
+    }
     with_output(cmd.is_stdout, filename_str, [root_raw_term](std::ostream& stream) {
       if (!root_raw_term || root_raw_term->isEmptySet()) {
         stream << "No top-level CSG object\n";
@@ -481,17 +490,24 @@ int do_export(const CommandLine& cmd, const RenderVariables& render_variables, F
         (cmd.viewOptions.renderer == RenderType::OPENCSG ||
          cmd.viewOptions.renderer == RenderType::THROWNTOGETHER)) {
       // OpenCSG or throwntogether png -> just render a preview
-      glview = prepare_preview(tree, cmd.viewOptions, camera);
-      if (!glview) return 1;
+      // (batches of views prepare their own)
+      if (cmd.views.empty()) {
+        glview = prepare_preview(tree, cmd.viewOptions, camera);
+        if (!glview) return 1;
+      }
     } else {
       // Force creation of concrete geometry (mostly for testing)
       // FIXME: Consider adding MANIFOLD as a valid --render argument and ViewOption, to be able to
       // distinguish from CGAL
 
       constexpr bool allownef = true;
-      root_geom = geomevaluator.evaluateGeometry(*tree.root(), allownef);
+      {
+        const RenderStatistic::Phase phase(RenderStatistic::GEOMETRY_EVALUATION);
+        root_geom = geomevaluator.evaluateGeometry(*tree.root(), allownef);
+      }
       if (!root_geom) root_geom = std::make_shared<PolySet>(3);
       if (cmd.viewOptions.renderer == RenderType::BACKEND_SPECIFIC && root_geom->getDimension() == 3) {
+        const RenderStatistic::Phase phase(RenderStatistic::BACKEND_CONVERSION);
         if (auto geomlist = std::dynamic_pointer_cast<const GeometryList>(root_geom)) {
           auto flatlist = geomlist->flatten();
           for (auto& child : flatlist) {
@@ -512,11 +528,20 @@ int do_export(const CommandLine& cmd, const RenderVariables& render_variables, F
     const int dim = fileformat::is3D(export_format) ? 3 : fileformat::is2D(export_format) ? 2 : 0;
     ExportInfo exportInfo = createExportInfo(export_format, fileformat::info(export_format),
                                              input_filename, &cmd.camera, cmd.exportOptions);
+    std::optional<RenderStatistic::Phase> exportPhase(RenderStatistic::EXPORT);
     if (dim > 0 && !checkAndExport(root_geom, dim, exportInfo, cmd.is_stdout, filename_str)) {
       return 1;
     }
 
-    if (export_format == FileFormat::PNG) {
+    if (export_format == FileFormat::PNG && !cmd.views.empty()) {
+      auto views = cmd.views;
+      if (file_context) {
+        for (auto& view : views) view.camera.updateView(file_context, false);
+      }
+      const bool success = root_geom ? export_png_views(root_geom, views)
+                                     : export_png_views(tree, cmd.viewOptions.previewer, views);
+      if (!success) return 1;
+    } else if (export_format == FileFormat::PNG) {
       bool success = true;
       bool const wrote = with_output(
         cmd.is_stdout, filename_str,
@@ -533,6 +558,7 @@ int do_export(const CommandLine& cmd, const RenderVariables& render_variables, F
         return 1;
       }
     }
+    exportPhase.reset();
 
     renderStatistic.printAll(root_geom, camera, cmd.summaryOptions, cmd.summaryFile);
   }
@@ -541,6 +567,7 @@ int do_export(const CommandLine& cmd, const RenderVariables& render_variables, F
 
 int cmdline(const CommandLine& cmd)
 {
+  RenderStatistic::resetPhases();
   FileFormat export_format;
 
   // Determine output file format and assign it to formatName
@@ -613,9 +640,12 @@ int cmdline(const CommandLine& cmd)
   text += "\n\x03\n" + commandline_commands;
 
   SourceFile *root_file = nullptr;
-  if (!parse(root_file, text, cmd.filename, cmd.filename, false)) {
-    delete root_file;  // parse failed
-    root_file = nullptr;
+  {
+    const RenderStatistic::Phase phase(RenderStatistic::PARSE);
+    if (!parse(root_file, text, cmd.filename, cmd.filename, false)) {
+      delete root_file;  // parse failed
+      root_file = nullptr;
+    }
   }
   if (!root_file) {
     LOG("Can't parse file '%1$s'!\n", cmd.filename);
@@ -893,13 +923,25 @@ int openscad_main(int argc, char **argv)
       "Parameter <shard>/<num_shards> - Divide work into <num_shards> and only output frames for "
       "<shard>. E.g. 2/5 only outputs the second 1/5 of frames. Use to parallelize work on multiple "
       "cores or machines.")
+    ("views", po::value<std::string>(),
+      "=file.json -export one png per view listed in the JSON file instead of using '-o'. The model is "
+      "evaluated once and offscreen contexts are shared between views of the same size.")
     ("view", po::value<CommaSeparatedVector>(),
       ("=view options: " + boost::algorithm::join(viewOptions.names(), " | ")).c_str())
     ("projection", po::value<std::string>(), "=(o)rtho or (p)erspective when exporting png")
     ("csglimit", po::value<unsigned int>(), "=n -stop rendering at n CSG elements when exporting png")
+    ("preview-max-segments", po::value<unsigned int>(),
+      "=n -limit circles to n segments when $preview is true, 0 for no limit")
+    ("cache-limit", po::value<unsigned int>(),
+      "=n -limit all geometry caches together to n MB, 0 for no limit")
+    ("memory-limit", po::value<unsigned int>(),
+      "=n -evict cached geometry while the process occupies more than n MB of memory, 0 for no limit")
+    ("cache-policy", po::value<std::string>(),
+      "=lru | gds -evict the least recently used cached geometry (default), or the geometry that is "
+      "cheapest to recompute per byte (GreedyDual-Size)")
     ("summary", po::value<std::vector<std::string>>(),
-      "enable additional render summary and statistics: all | cache | time | camera | geometry | "
-      "bounding-box | area")
+      "enable additional render summary and statistics: all | cache | time | memory | operations | "
+      "camera | geometry | bounding-box | area")
     ("summary-file", po::value<std::string>(),
       "output summary information in JSON format to the given file, using '-' outputs to stdout")
     ("colorscheme", po::value<std::string>(),
@@ -1058,6 +1100,26 @@ int openscad_main(int argc, char **argv)
   if (vm.count("csglimit")) {
     RenderSettings::inst()->openCSGTermLimit = vm["csglimit"].as<unsigned int>();
   }
+  if (vm.count("preview-max-segments")) {
+    RenderSettings::inst()->previewMaxSegments = vm["preview-max-segments"].as<unsigned int>();
+  }
+  if (vm.count("cache-limit")) {
+    MemoryBudget::instance()->setLimitMB(vm["cache-limit"].as<unsigned int>());
+  }
+  if (vm.count("memory-limit")) {
+    MemoryBudget::instance()->setSoftRSSLimitMB(vm["memory-limit"].as<unsigned int>());
+  }
+  if (vm.count("cache-policy")) {
+    const auto policy = vm["cache-policy"].as<std::string>();
+    if (policy == "lru") {
+      cacheEvictionPolicy = CacheEvictionPolicy::LRU;
+    } else if (policy == "gds") {
+      cacheEvictionPolicy = CacheEvictionPolicy::GreedyDualSize;
+    } else {
+      LOG(message_group::Error, "Unknown cache policy '%1$s', use 'lru' or 'gds'.", policy);
+      return 1;
+    }
+  }
 
   if (vm.count("o")) {
     output_files = vm["o"].as<std::vector<std::string>>();
@@ -1127,6 +1189,17 @@ int openscad_main(int argc, char **argv)
   AnimateArgs const animate = get_animate(vm);
   const Camera camera = get_camera(vm);
 
+  std::vector<PngView> png_views;
+  if (vm.count("views")) {
+    if (!output_files.empty() || animate.frames) {
+      LOG("Option --views can't be combined with -o or --animate.");
+      return 1;
+    }
+    if (!read_png_views(vm["views"].as<std::string>(), camera, viewOptions, png_views)) return 1;
+    export_format.emplace(FileFormat::PNG);
+    output_files.push_back(png_views.front().filename);
+  }
+
   if (animate.frames) {
     for (const auto& filename : output_files) {
       if (filename == "-") {
@@ -1175,7 +1248,8 @@ int openscad_main(int argc, char **argv)
                                 animate,
                                 vm.count("summary") ? vm["summary"].as<std::vector<std::string>>()
                                                     : std::vector<std::string>{},
-                                vm.count("summary-file") ? vm["summary-file"].as<std::string>() : ""};
+                                vm.count("summary-file") ? vm["summary-file"].as<std::string>() : "",
+                                png_views};
           rc |= cmdline(cmd);
         }
       }
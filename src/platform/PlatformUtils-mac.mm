@@ -3,8 +3,10 @@
 #include <sstream>
 
 #include <sys/types.h>
+#include <sys/resource.h>
 #include <sys/sysctl.h>
 #include <sys/utsname.h>
+#include <mach/mach.h>
 #include <boost/lexical_cast.hpp>
 
 #import <Foundation/Foundation.h>
@@ -36,6 +38,16 @@ std::string PlatformUtils::userConfigPath()
   return std::string([[appSupportDir path] UTF8String]) + std::string("/") + PlatformUtils::OPENSCAD_FOLDER_NAME;
 }
 
+std::string PlatformUtils::userCachePath()
+{
+  NSError *error = nullptr;
+  NSURL *cachesDir = [[NSFileManager defaultManager] URLForDirectory:NSCachesDirectory inDomain:NSUserDomainMask appropriateForURL:nil create:YES error:&error];
+  if (error) {
+    return "";
+  }
+  return std::string([[cachesDir path] UTF8String]) + std::string("/") + PlatformUtils::OPENSCAD_FOLDER_NAME;
+}
+
 unsigned long PlatformUtils::stackLimit()
 {
   struct rlimit limit;        
@@ -53,6 +65,37 @@ unsigned long PlatformUtils::stackLimit()
   return STACK_LIMIT_DEFAULT;
 }
 
+uint64_t PlatformUtils::residentMemory()
+{
+  mach_task_basic_info_data_t info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) ==
+      KERN_SUCCESS) {
+    return info.resident_size;
+  }
+  return 0;
+}
+
+uint64_t PlatformUtils::peakResidentMemory()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    // macOS reports bytes
+    return static_cast<uint64_t>(usage.ru_maxrss);
+  }
+  return 0;
+}
+
+double PlatformUtils::processCPUTime()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+  }
+  return 0;
+}
+
 const std::string PlatformUtils::user_agent()
 {
   std::ostringstream result;
@@ -48,6 +48,21 @@ static fs::path getXdgConfigDir()
   return fs::path{};
 }
 
+static fs::path getXdgCacheDir()
+{
+  const char *xdg_env = getenv("XDG_CACHE_HOME");
+  if (xdg_env && fs::path{xdg_env}.is_absolute()) {
+    return fs::path{xdg_env};
+  } else {
+    const char *home = getenv("HOME");
+    if (home) {
+      return fs::path{home} / ".cache";
+    }
+  }
+
+  return fs::path{};
+}
+
 // see https://www.freedesktop.org/wiki/Software/xdg-user-dirs/
 // This partially implements the xdg-user-dir handling by reading the
 // user-dirs.dirs file generated by the xdg-user-dirs-update tool. Missing
@@ -122,6 +137,13 @@ std::string PlatformUtils::userConfigPath()
   return "";
 }
 
+std::string PlatformUtils::userCachePath()
+{
+  const fs::path cache_dir{getXdgCacheDir()};
+  if (cache_dir.empty()) return "";
+  return (cache_dir / OPENSCAD_FOLDER_NAME).generic_string();
+}
+
 unsigned long PlatformUtils::stackLimit()
 {
 #ifndef __EMSCRIPTEN__
@@ -147,6 +169,43 @@ unsigned long PlatformUtils::stackLimit()
   return STACK_LIMIT_DEFAULT;
 }
 
+uint64_t PlatformUtils::residentMemory()
+{
+#ifdef __linux__
+  // Second field of statm is the number of resident pages
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0, resident = 0;
+  if (statm >> size >> resident) {
+    return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  }
+#endif  // __linux__
+  return 0;
+}
+
+uint64_t PlatformUtils::peakResidentMemory()
+{
+#ifndef __EMSCRIPTEN__
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    // Linux and the BSDs report kilobytes
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+  }
+#endif  // __EMSCRIPTEN__
+  return 0;
+}
+
+double PlatformUtils::processCPUTime()
+{
+#ifndef __EMSCRIPTEN__
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+  }
+#endif  // __EMSCRIPTEN__
+  return 0;
+}
+
 /**
  * Check /etc/os-release as defined by systemd.
  * @see http://0pointer.de/blog/projects/os-release.html
@@ -21,6 +21,7 @@
 #define __IPreviewHandlerVisuals_INTERFACE_DEFINED__
 #define __IVisualProperties_INTERFACE_DEFINED__
 #include <shlobj.h>
+#include <psapi.h>
 
 #include "version.h"
 
@@ -80,11 +81,49 @@ std::string PlatformUtils::userConfigPath()
   return retval + std::string("/") + PlatformUtils::OPENSCAD_FOLDER_NAME;
 }
 
+std::string PlatformUtils::userCachePath()
+{
+  const std::string retval = getFolderPath(CSIDL_LOCAL_APPDATA);
+  if (retval.empty()) return "";
+  return retval + std::string("/") + PlatformUtils::OPENSCAD_FOLDER_NAME + std::string("/cache");
+}
+
 unsigned long PlatformUtils::stackLimit()
 {
   return STACK_LIMIT_DEFAULT;
 }
 
+uint64_t PlatformUtils::residentMemory()
+{
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    return counters.WorkingSetSize;
+  }
+  return 0;
+}
+
+uint64_t PlatformUtils::peakResidentMemory()
+{
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    return counters.PeakWorkingSetSize;
+  }
+  return 0;
+}
+
+double PlatformUtils::processCPUTime()
+{
+  FILETIME creation, exit, kernel, user;
+  if (GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+    // FILETIMEs count 100 ns intervals
+    const auto ticks = [](const FILETIME& time) {
+      return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+    return (ticks(kernel) + ticks(user)) / 1e7;
+  }
+  return 0;
+}
+
 // NOLINTNEXTLINE(modernize-use-using)
 typedef BOOL(WINAPI *LPFN_ISWOW64PROCESS)(HANDLE, PBOOL);
 
@@ -52,6 +52,18 @@ std::string userExamplesPath();
  */
 std::string userConfigPath();
 
+/**
+ * Base path for cached data of the current user, which can be deleted
+ * at any time. On Linux this is $XDG_CACHE_HOME, on macOS the user's
+ * Caches folder and on Windows the local AppData folder.
+ * The returned path already includes an OpenSCAD specific part, but
+ * may not exist yet.
+ *
+ * @return absolute path to the cache folder or an empty string if no
+ * such location is known.
+ */
+std::string userCachePath();
+
 bool createUserLibraryPath();
 std::string backupPath();
 bool createBackupPath();
@@ -99,6 +111,29 @@ int setenv(const char *name, const char *value, int overwrite);
  */
 unsigned long stackLimit();
 
+/**
+ * Return the resident set size of the current process, i.e. the
+ * physical memory it currently occupies.
+ *
+ * @return resident memory in bytes, or 0 if it can't be determined.
+ */
+uint64_t residentMemory();
+
+/**
+ * Return the largest resident set size the current process had so far.
+ *
+ * @return peak resident memory in bytes, or 0 if it can't be determined.
+ */
+uint64_t peakResidentMemory();
+
+/**
+ * Return the CPU time the current process spent so far, in user and
+ * system mode and summed over all threads.
+ *
+ * @return CPU time in seconds, or 0 if it can't be determined.
+ */
+double processCPUTime();
+
 /**
  * Single character separating path specifications in a list
  * (e.g. OPENSCADPATH). On Windows that's ';' and on most other
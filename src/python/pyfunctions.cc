@@ -239,13 +239,20 @@ PyObject *python_polyhedron(PyObject *self, PyObject *args, PyObject *kwargs)
   PyObject *element;
   Vector3d point;
 
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!O!|iO!", kwlist, &PyList_Type, &points, &PyList_Type,
-                                   &faces, &convexity, &PyList_Type, &triangles)) {
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O&O&|iO!", kwlist, python_listorbuffer, &points,
+                                   python_listorbuffer, &faces, &convexity, &PyList_Type, &triangles)) {
     PyErr_SetString(PyExc_TypeError, "Error during parsing polyhedron(points, faces)");
     return NULL;
   }
 
-  if (points != NULL && PyList_Check(points)) {
+  if (points != NULL && !PyList_Check(points) && PyObject_CheckBuffer(points)) {
+    // Bulk path for e.g. numpy arrays, avoiding a PyObject per coordinate
+    if (python_bufferpoints(points, node->points)) return NULL;
+    if (node->points.empty()) {
+      PyErr_SetString(PyExc_TypeError, "There must at least be one point in the polyhedron");
+      return NULL;
+    }
+  } else if (points != NULL && PyList_Check(points)) {
     if (PyList_Size(points) == 0) {
       PyErr_SetString(PyExc_TypeError, "There must at least be one point in the polyhedron");
       return NULL;
@@ -273,7 +280,13 @@ PyObject *python_polyhedron(PyObject *self, PyObject *args, PyObject *kwargs)
     //"polyhedron(triangles=[]) will be removed in future releases. Use polyhedron(faces=[]) instead.");
   }
 
-  if (faces != NULL && PyList_Check(faces)) {
+  if (faces != NULL && !PyList_Check(faces) && PyObject_CheckBuffer(faces)) {
+    if (python_bufferfaces(faces, node->points.size(), node->faces)) return NULL;
+    if (node->faces.empty()) {
+      PyErr_SetString(PyExc_TypeError, "must specify at least 1 face");
+      return NULL;
+    }
+  } else if (faces != NULL && PyList_Check(faces)) {
     if (PyList_Size(faces) == 0) {
       PyErr_SetString(PyExc_TypeError, "must specify at least 1 face");
       return NULL;
@@ -1044,7 +1057,7 @@ PyObject *python_oo_color(PyObject *obj, PyObject *args, PyObject *kwargs)
   return python_color_core(obj, color, alpha);
 }
 
-PyObject *python_mesh_core(PyObject *obj, bool tessellate)
+PyObject *python_mesh_core(PyObject *obj, bool tessellate, bool as_buffer)
 {
   PyObject *dummydict;
   std::shared_ptr<AbstractNode> child = PyOpenSCADObjectToNodeMulti(obj, &dummydict);
@@ -1058,18 +1071,37 @@ PyObject *python_mesh_core(PyObject *obj, bool tessellate)
   std::shared_ptr<const PolySet> ps = PolySetUtils::getGeometryAsPolySet(geom);
 
   if (ps != nullptr) {
-    if (tessellate == true) {
+    if (tessellate == true || as_buffer == true) {
       ps = PolySetUtils::tessellate_faces(*ps);
     }
+    if (as_buffer) {
+      // Triangles only, so both arrays have a fixed number of columns
+      std::vector<int32_t> triangles;
+      triangles.reserve(ps->indices.size() * 3);
+      for (const auto& face : ps->indices) {
+        triangles.insert(triangles.end(), face.begin(), face.end());
+      }
+      PyObjectUniquePtr ptbuf(
+        python_tobuffer(ps->vertices.data(), ps->vertices.size(), 3, "d", sizeof(double)),
+        PyObjectDeleter);
+      if (!ptbuf) return NULL;
+      PyObjectUniquePtr facebuf(
+        python_tobuffer(triangles.data(), ps->indices.size(), 3, "i", sizeof(int32_t)),
+        PyObjectDeleter);
+      if (!facebuf) return NULL;
+      PyObject *result = PyTuple_New(2);
+      if (!result) return NULL;
+      PyTuple_SetItem(result, 0, ptbuf.release());
+      PyTuple_SetItem(result, 1, facebuf.release());
+      return result;
+    }
     // Now create Python Point array
     PyObject *ptarr = PyList_New(ps->vertices.size());
     for (unsigned int i = 0; i < ps->vertices.size(); i++) {
       PyObject *coord = PyList_New(3);
       for (int j = 0; j < 3; j++) PyList_SetItem(coord, j, PyFloat_FromDouble(ps->vertices[i][j]));
       PyList_SetItem(ptarr, i, coord);
-      Py_XINCREF(coord);
     }
-    Py_XINCREF(ptarr);
     // Now create Python Point array
     PyObject *polarr = PyList_New(ps->indices.size());
     for (unsigned int i = 0; i < ps->indices.size(); i++) {
@@ -1077,11 +1109,14 @@ PyObject *python_mesh_core(PyObject *obj, bool tessellate)
       for (unsigned int j = 0; j < ps->indices[i].size(); j++)
         PyList_SetItem(face, j, PyLong_FromLong(ps->indices[i][j]));
       PyList_SetItem(polarr, i, face);
-      Py_XINCREF(face);
     }
-    Py_XINCREF(polarr);
 
     PyObject *result = PyTuple_New(2);
+    if (!result) {
+      Py_DECREF(ptarr);
+      Py_DECREF(polarr);
+      return NULL;
+    }
     PyTuple_SetItem(result, 0, ptarr);
     PyTuple_SetItem(result, 1, polarr);
 
@@ -1108,25 +1143,27 @@ PyObject *python_mesh_core(PyObject *obj, bool tessellate)
 
 PyObject *python_mesh(PyObject *self, PyObject *args, PyObject *kwargs)
 {
-  char *kwlist[] = {"obj", "triangulate", NULL};
+  char *kwlist[] = {"obj", "triangulate", "buffer", NULL};
   PyObject *obj = NULL;
   PyObject *tess = NULL;
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O", kwlist, &obj, &tess)) {
+  PyObject *buffer = NULL;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|OO", kwlist, &obj, &tess, &buffer)) {
     PyErr_SetString(PyExc_TypeError, "error during parsing\n");
     return NULL;
   }
-  return python_mesh_core(obj, tess == Py_True);
+  return python_mesh_core(obj, tess == Py_True, buffer == Py_True);
 }
 
 PyObject *python_oo_mesh(PyObject *obj, PyObject *args, PyObject *kwargs)
 {
-  char *kwlist[] = {"triangulate", NULL};
+  char *kwlist[] = {"triangulate", "buffer", NULL};
   PyObject *tess = NULL;
-  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", kwlist, &tess)) {
+  PyObject *buffer = NULL;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OO", kwlist, &tess, &buffer)) {
     PyErr_SetString(PyExc_TypeError, "error during parsing\n");
     return NULL;
   }
-  return python_mesh_core(obj, tess == Py_True);
+  return python_mesh_core(obj, tess == Py_True, buffer == Py_True);
 }
 
 PyObject *rotate_extrude_core(PyObject *obj, int convexity, double scale, double angle, PyObject *twist,
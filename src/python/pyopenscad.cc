@@ -28,6 +28,8 @@
 #include <Python.h>
 
 #include <array>
+#include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <memory>
 #include <optional>
@@ -270,6 +272,126 @@ std::vector<Vector3d> python_vectors(PyObject *vec, int mindim, int maxdim)
   return results;  // Error
 }
 
+namespace {
+
+// Strips the native byte order/alignment prefixes from a struct style buffer format
+const char *buffer_format(const Py_buffer& view)
+{
+  const char *format = view.format ? view.format : "B";
+  if (*format == '@' || *format == '=') format++;
+  return format;
+}
+
+// Number of rows when viewing the buffer as a 2D array with the given number of columns
+Py_ssize_t buffer_rows(const Py_buffer& view, Py_ssize_t cols)
+{
+  if (view.ndim == 2 && view.shape[1] == cols) return view.shape[0];
+  if (view.ndim == 1 && view.shape[0] % cols == 0) return view.shape[0] / cols;
+  return -1;
+}
+
+}  // namespace
+
+/*
+ * Copies the points out of a C-contiguous float64 buffer (e.g. a memoryview or
+ * numpy array) of shape (n, 3) or (3n,) in one go.
+ * Returns 0 on success, otherwise sets a Python exception and returns 1.
+ */
+int python_bufferpoints(PyObject *vec, std::vector<Vector3d>& points)
+{
+  static_assert(sizeof(Vector3d) == 3 * sizeof(double), "Vector3d must be tightly packed");
+  Py_buffer view;
+  if (PyObject_GetBuffer(vec, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) return 1;
+  const Py_ssize_t rows = buffer_rows(view, 3);
+  int result = 1;
+  if (strcmp(buffer_format(view), "d") != 0 || view.itemsize != sizeof(double)) {
+    PyErr_SetString(PyExc_TypeError, "Point buffer must contain float64 values");
+  } else if (rows < 0) {
+    PyErr_SetString(PyExc_TypeError, "Point buffer must have shape (n, 3)");
+  } else {
+    points.resize(rows);
+    if (rows > 0) memcpy(points.data(), view.buf, rows * sizeof(Vector3d));
+    result = 0;
+  }
+  PyBuffer_Release(&view);
+  return result;
+}
+
+/*
+ * Reads faces from a C-contiguous integer buffer of shape (n, k), each row being one face,
+ * or of shape (3n,) holding triangles. Indices are checked against num_points.
+ * Returns 0 on success, otherwise sets a Python exception and returns 1.
+ */
+int python_bufferfaces(PyObject *vec, size_t num_points, std::vector<IndexedFace>& faces)
+{
+  Py_buffer view;
+  if (PyObject_GetBuffer(vec, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) return 1;
+  const Py_ssize_t cols = view.ndim == 2 ? view.shape[1] : 3;
+  const Py_ssize_t rows = buffer_rows(view, cols);
+  const char *format = buffer_format(view);
+  int result = 1;
+  if (strlen(format) != 1 || !strchr("iIlLqQ", *format) ||
+      (view.itemsize != sizeof(int32_t) && view.itemsize != sizeof(int64_t))) {
+    PyErr_SetString(PyExc_TypeError, "Face buffer must contain 32 or 64 bit integers");
+  } else if (rows < 0 || cols < 3) {
+    PyErr_SetString(PyExc_TypeError, "Face buffer must have shape (n, k) with k >= 3");
+  } else {
+    auto index = [&view](Py_ssize_t i) -> int64_t {
+      if (view.itemsize == sizeof(int32_t)) return static_cast<const int32_t *>(view.buf)[i];
+      return static_cast<const int64_t *>(view.buf)[i];
+    };
+    faces.reserve(faces.size() + rows);
+    result = 0;
+    for (Py_ssize_t i = 0; i < rows && result == 0; i++) {
+      IndexedFace& face = faces.emplace_back();
+      for (Py_ssize_t j = 0; j < cols; j++) {
+        const int64_t ind = index(i * cols + j);
+        if (ind < 0 || ind >= static_cast<int64_t>(num_points)) {
+          PyErr_SetString(PyExc_TypeError, "Polyhedron Point Index out of range");
+          result = 1;
+          break;
+        }
+        face.push_back(static_cast<int>(ind));
+      }
+    }
+  }
+  PyBuffer_Release(&view);
+  return result;
+}
+
+/*
+ * PyArg_ParseTuple "O&" converter which stores obj in *result if it is a list or
+ * supports the buffer protocol.
+ * Returns 1 on success, otherwise sets a Python exception and returns 0.
+ */
+int python_listorbuffer(PyObject *obj, void *result)
+{
+  if (!PyList_Check(obj) && !PyObject_CheckBuffer(obj)) {
+    PyErr_Format(PyExc_TypeError, "expected a list or a buffer, not %s", Py_TYPE(obj)->tp_name);
+    return 0;
+  }
+  *static_cast<PyObject **>(result) = obj;
+  return 1;
+}
+
+/*
+ * Copies count rows of cols items into a new bytearray and returns a memoryview
+ * of it, cast to the given struct format and shape (count, cols).
+ */
+PyObject *python_tobuffer(const void *data, Py_ssize_t count, Py_ssize_t cols, const char *format,
+                          Py_ssize_t itemsize)
+{
+  PyObjectUniquePtr bytes(
+    PyByteArray_FromStringAndSize(static_cast<const char *>(data), count * cols * itemsize),
+    PyObjectDeleter);
+  if (!bytes) return nullptr;
+  PyObjectUniquePtr view(PyMemoryView_FromObject(bytes.get()), PyObjectDeleter);
+  if (!view) return nullptr;
+  // memoryview refuses to cast to a shape containing zeros
+  if (count == 0) return PyObject_CallMethod(view.get(), "cast", "s", format);
+  return PyObject_CallMethod(view.get(), "cast", "s(nn)", format, count, cols);
+}
+
 /**
  * Create a CurveDiscretizer by extracting parameters from __main__ and kwargs
  * @param kwargs *Remove* any control parameter arguments found.
@@ -1,12 +1,15 @@
 #include <Python.h>
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "core/ScopeContext.h"
 #include "core/UserModule.h"
 #include "core/function.h"
 #include "core/node.h"
+#include "geometry/GeometryUtils.h"
 #include "geometry/Polygon2d.h"
 #include "python_public.h"
 
@@ -41,6 +44,11 @@ std::shared_ptr<AbstractNode> PyOpenSCADObjectToNodeMulti(PyObject *object, PyOb
 extern std::string trusted_edit_document_name;
 extern std::string untrusted_edit_document_name;
 std::vector<Vector3d> python_vectors(PyObject *vec, int mindim, int maxdim);
+int python_bufferpoints(PyObject *vec, std::vector<Vector3d>& points);
+int python_bufferfaces(PyObject *vec, size_t num_points, std::vector<IndexedFace>& faces);
+int python_listorbuffer(PyObject *obj, void *result);
+PyObject *python_tobuffer(const void *data, Py_ssize_t count, Py_ssize_t cols, const char *format,
+                          Py_ssize_t itemsize);
 int python_numberval(PyObject *number, double *result);
 CurveDiscretizer CreateCurveDiscretizer(PyObject *kwargs);
 PyObject *python_str(PyObject *self);
@@ -25,6 +25,18 @@ void parallelizable_transform(const InputIterator begin1, const InputIterator en
   std::transform(begin1, end1, out, op);
 }
 
+template <class InputIterator, class Operation>
+void parallelizable_for_each(const InputIterator begin, const InputIterator end, const Operation& op)
+{
+#if ENABLE_TBB
+  if (!getenv("OPENSCAD_NO_PARALLEL")) {
+    tbb::parallel_for_each(begin, end, op);
+    return;
+  }
+#endif
+  std::for_each(begin, end, op);
+}
+
 template <class Container1, class Container2, class OutputIterator, class Operation>
 void parallelizable_cross_product_transform(const Container1& cont1, const Container2& cont2,
                                             OutputIterator out, const Operation& op)
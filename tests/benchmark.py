@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+
+# Performance benchmark
+#
+# Usage: <script> --openscad=<executable-path> --baselinedir=<dir> --resultdir=<dir>
+#                 [--runs=<n>] [--time-tolerance=<fraction>] [--memory-tolerance=<fraction>]
+#                 [-g] <inputfile> [<openscad args>]
+#
+# step 1. Render the .scad file to OFF the given number of times, each in a fresh process,
+#         and collect the --summary of each run
+# step 2. Write the median wall time, the largest peak resident memory, the facet count and
+#         the phase times of the median run to <resultdir>/<name>-actual.json
+# step 3. Compare to <baselinedir>/<name>-expected.json. Wall time and memory may exceed the
+#         baseline by the given tolerance, the facet count has to match.
+#
+# If the -g option is given or the TEST_GENERATE environment variable is set to 1, the
+# baseline is written instead. Baselines depend on the machine they were recorded on, so
+# without one the benchmark is skipped (exit code 77) rather than failed.
+#
+# This script should return 0 on success, not-0 on error.
+
+import argparse
+import json
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import time
+
+SKIPPED = 77
+
+
+def failquit(*args):
+    if len(args) != 0:
+        print(*args, file=sys.stderr)
+    print("benchmark args:", str(sys.argv), file=sys.stderr)
+    print("exiting benchmark.py with failure", file=sys.stderr)
+    sys.exit(1)
+
+
+def run(args, inputfile, name, index, openscad_args):
+    outputfile = os.path.join(args.resultdir, name + ".off")
+    summaryfile = os.path.join(args.resultdir, name + "-summary-" + str(index) + ".json")
+    cmd = [args.openscad, inputfile, "-o", outputfile, "--summary=all",
+           "--summary-file=" + summaryfile] + openscad_args
+    print("Running", " ".join(cmd), file=sys.stderr)
+    start = time.perf_counter()
+    result = subprocess.run(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE,
+                            universal_newlines=True)
+    wall = time.perf_counter() - start
+    if result.returncode != 0:
+        failquit(result.stderr, "openscad failed with return code", result.returncode)
+    try:
+        with open(summaryfile) as f:
+            summary = json.load(f)
+    except (OSError, ValueError) as e:
+        failquit("can't read summary " + summaryfile + ": " + str(e))
+    return wall, summary
+
+
+def measure(args, inputfile, name, openscad_args):
+    runs = [run(args, inputfile, name, i, openscad_args) for i in range(args.runs)]
+    walls = [wall for wall, _ in runs]
+    median_run = sorted(runs, key=lambda run: run[0])[len(runs) // 2]
+    summary = median_run[1]
+    geometry = summary.get("geometry", {})
+    return {
+        "file": os.path.basename(inputfile),
+        "args": openscad_args,
+        "runs": args.runs,
+        "wall_time": {
+            "median": statistics.median(walls),
+            "min": min(walls),
+            "max": max(walls),
+        },
+        "peak_resident": max(s.get("memory", {}).get("peak_resident", 0) for _, s in runs),
+        "facets": geometry.get("facets", geometry.get("contours")),
+        "phases": summary.get("time", {}).get("phases", {}),
+        "operations": summary.get("operations", {}),
+    }
+
+
+def compare(args, actual, expected):
+    ok = True
+
+    def check(label, value, baseline, tolerance, unit):
+        nonlocal ok
+        if not baseline:
+            return
+        limit = baseline * (1 + tolerance)
+        change = (value - baseline) / baseline * 100
+        print(f" {label}: {value:.3f}{unit} (baseline {baseline:.3f}{unit}, {change:+.1f}%)",
+              file=sys.stderr)
+        if value > limit:
+            print(f" {label} exceeds the baseline by more than {tolerance * 100:.0f}%",
+                  file=sys.stderr)
+            ok = False
+
+    check("wall time", actual["wall_time"]["median"], expected["wall_time"]["median"],
+          args.time_tolerance, " s")
+    check("peak memory", actual["peak_resident"] / 2**20, expected["peak_resident"] / 2**20,
+          args.memory_tolerance, " MB")
+    if actual["facets"] != expected["facets"]:
+        print(f" facets: {actual['facets']} (baseline {expected['facets']})", file=sys.stderr)
+        ok = False
+    return ok
+
+
+parser = argparse.ArgumentParser()
+parser.add_argument("--openscad", required=True, help="Specify OpenSCAD executable")
+parser.add_argument("--baselinedir", required=True, help="Directory holding the baselines")
+parser.add_argument("--resultdir", required=True, help="Directory to write results to")
+parser.add_argument("--runs", type=int, default=3, help="Number of runs to take the median of")
+parser.add_argument("--time-tolerance", type=float, default=0.25,
+                    help="Allowed increase of the wall time as a fraction of the baseline")
+parser.add_argument("--memory-tolerance", type=float, default=0.10,
+                    help="Allowed increase of the peak memory as a fraction of the baseline")
+parser.add_argument("-g", "--generate", action="store_true", help="Write the baseline")
+args, remaining_args = parser.parse_known_args()
+if not args.generate:
+    args.generate = os.getenv("TEST_GENERATE") == "1"
+
+inputfile = remaining_args[0]
+openscad_args = remaining_args[1:]  # Passed on to the OpenSCAD executable
+name = os.path.splitext(os.path.basename(inputfile))[0]
+
+if not os.path.exists(inputfile):
+    failquit("can't find input file named: " + inputfile)
+if not shutil.which(args.openscad):
+    failquit("can't find openscad executable named: " + args.openscad)
+if args.runs < 1:
+    failquit("--runs needs to be at least 1")
+os.makedirs(args.resultdir, exist_ok=True)
+
+actual = measure(args, inputfile, name, openscad_args)
+actualfile = os.path.join(args.resultdir, name + "-actual.json")
+with open(actualfile, "w") as f:
+    json.dump(actual, f, indent=2)
+print(" actual json file:", actualfile, file=sys.stderr)
+
+expectedfile = os.path.join(args.baselinedir, name + "-expected.json")
+if args.generate:
+    os.makedirs(args.baselinedir, exist_ok=True)
+    shutil.copyfile(actualfile, expectedfile)
+    print(" generated baseline:", expectedfile, file=sys.stderr)
+    sys.exit(0)
+
+if not os.path.isfile(expectedfile):
+    print(f"No baseline in {expectedfile}, run with TEST_GENERATE=1 to record one",
+          file=sys.stderr)
+    sys.exit(SKIPPED)
+with open(expectedfile) as f:
+    expected = json.load(f)
+print(" expected json file:", expectedfile, file=sys.stderr)
+if expected.get("args") != openscad_args:
+    print(" warning: the baseline was recorded with arguments", expected.get("args"),
+          file=sys.stderr)
+
+if not compare(args, actual, expected):
+    failquit()
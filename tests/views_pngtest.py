@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+
+# Views test
+#
+#
+# Usage: <script> <inputfile> --openscad=<executable-path> --views=<views.json> --view=<output> [<openscad args>] file.png
+#        <script> <inputfile> --openscad=<executable-path> --views=<views.json> --retval=<retval> [<openscad args>]
+#
+#
+# step 1. Run OpenSCAD on the .scad file with --views, writing all views of the spec to a
+#         temporary directory
+# step 2. Copy the PNG of the view whose "output" is <output> to file.png
+# step 3. (done in CTest) - compare the generated .png file to expected output
+#
+# With --retval, the views file is passed on as is, and the script only checks that OpenSCAD
+# returns <retval>. This is used for malformed specs.
+#
+# This script should return 0 on success, not-0 on error.
+#
+
+
+import sys, os, json, shutil, subprocess, tempfile, argparse
+
+
+def failquit(*args):
+    if len(args) != 0:
+        print(args)
+    print("views_pngtest args:", str(sys.argv))
+    print("exiting views_pngtest.py with failure")
+    sys.exit(1)
+
+
+#
+# Parse arguments
+#
+parser = argparse.ArgumentParser()
+parser.add_argument("--openscad", required=True, help="Specify OpenSCAD executable")
+parser.add_argument("--views", required=True, help="Specify JSON views file")
+parser.add_argument("--view", help='"output" of the view to compare')
+parser.add_argument("--retval", help="Expected return value")
+parser.add_argument("-s", dest="suffix", help="Ignored, given by add_failing_test()")
+args, remaining_args = parser.parse_known_args()
+
+if (args.view is None) == (args.retval is None):
+    failquit("exactly one of --view and --retval is needed")
+
+inputfile = remaining_args[0]
+if args.retval is None:
+    pngfile = remaining_args[-1]
+    remaining_args = remaining_args[1:-1]  # Passed on to the OpenSCAD executable
+else:
+    remaining_args = remaining_args[1:]
+
+if not os.path.exists(inputfile):
+    failquit("can't find input file named: " + inputfile)
+if not os.path.exists(args.openscad):
+    failquit("can't find openscad executable named: " + args.openscad)
+if not os.path.exists(args.views):
+    failquit("can't find views file named: " + args.views)
+
+fontdir = os.path.abspath(os.path.join(os.path.dirname(__file__), "data/ttf"))
+fontenv = os.environ.copy()
+fontenv["OPENSCAD_FONT_PATH"] = fontdir
+
+if args.retval is not None:
+    views_cmd = [args.openscad, inputfile, "--views=" + args.views] + remaining_args
+    print("Running OpenSCAD:", " ".join(views_cmd), file=sys.stderr)
+    result = subprocess.call(views_cmd, env=fontenv)
+    if str(result) != str(args.retval):
+        failquit("OpenSCAD failed with unexpected return value " + str(result) + " (should be " + str(args.retval) + ")")
+    sys.exit(0)
+
+# Write the views to a directory of our own, so parallel tests sharing a spec don't collide
+with tempfile.TemporaryDirectory() as tmpdir:
+    with open(args.views) as f:
+        spec = json.load(f)
+    views = spec["views"] if isinstance(spec, dict) else spec
+    outputs = {}
+    for view in views:
+        outputs[view["output"]] = view["output"] = os.path.join(tmpdir, os.path.basename(view["output"]))
+    if args.view not in outputs:
+        failquit("no view with output " + args.view + " in " + args.views)
+    viewsfile = os.path.join(tmpdir, "views.json")
+    with open(viewsfile, "w") as f:
+        json.dump(spec, f)
+
+    views_cmd = [args.openscad, inputfile, "--views=" + viewsfile] + remaining_args
+    print("Running OpenSCAD:", " ".join(views_cmd), file=sys.stderr)
+    result = subprocess.call(views_cmd, env=fontenv)
+    if result != 0:
+        failquit("OpenSCAD failed with return code " + str(result))
+
+    for output in outputs.values():
+        if not os.path.exists(output):
+            failquit("OpenSCAD didn't write " + output)
+    shutil.copyfile(outputs[args.view], pngfile)